@@ -0,0 +1,76 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNETCION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
+
+#include "MagnumPlugins/PngImporter/PngImporter.h"
+
+using namespace Magnum;
+
+/* GCC 11+ in Release warns that "this pointer is null". Yes. It is. Fuck off,
+   those are documentation code snippets. */
+#if defined(CORRADE_TARGET_GCC) && !defined(CORRADE_TARGET_CLANG) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wnonnull"
+#endif
+
+int main() {
+{
+Containers::ArrayView<char> stagingBuffer;
+/* [rows] */
+Trade::PngImporter importer;
+if(!importer.openFile("image.png"))
+    Fatal{} << "Can't open the file";
+
+Containers::Optional<Containers::Pair<PixelFormat, Vector2i>> properties =
+    importer.beginImage2DRows();
+if(!properties)
+    Fatal{} << "Can't read the header";
+
+/* Decode in batches of 64 rows directly into a staging buffer that's large
+   enough for the whole image with four-byte-aligned rows, going from the top
+   of the image */
+const PixelFormat format = properties->first();
+const Vector2i size = properties->second();
+for(Int decoded = 0; decoded != size.y(); ) {
+    const Int count = Math::min(64, size.y() - decoded);
+    MutableImageView2D destination{
+        PixelStorage{}.setSkip({0, size.y() - decoded - count, 0}),
+        format, {size.x(), count}, stagingBuffer};
+    Containers::Optional<Int> rows = importer.image2DRows(destination);
+    if(!rows)
+        Fatal{} << "Can't decode the image";
+
+    decoded += *rows;
+
+    // upload the freshly decoded rows while decoding the next batch ...
+}
+/* [rows] */
+}
+}
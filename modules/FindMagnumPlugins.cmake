@@ -52,6 +52,7 @@
 #  StbVorbisAudioImporter       - OGG audio importer using stb_vorbis
 #  StlImporter                  - STL importer
 #  UfbxImporter                 - FBX and OBJ importer using ufbx
+#  WebPImageConverter           - WebP image converter
 #  WebPImporter                 - WebP importer
 #
 # If Magnum is built with MAGNUM_BUILD_DEPRECATED enabled, these additional
@@ -175,7 +176,8 @@ set(_MAGNUMPLUGINS_PLUGIN_COMPONENTS
     SpirvToolsShaderConverter SpngImporter StanfordImporter
     StanfordSceneConverter StbDxtImageConverter StbImageConverter
     StbImageImporter StbResizeImageConverter StbTrueTypeFont
-    StbVorbisAudioImporter StlImporter UfbxImporter WebPImporter)
+    StbVorbisAudioImporter StlImporter UfbxImporter WebPImageConverter
+    WebPImporter)
 # Nothing is enabled by default right now
 set(_MAGNUMPLUGINS_IMPLICITLY_ENABLED_COMPONENTS )
 
@@ -365,7 +367,12 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
                 endif()
             endif()
 
-        # BcDecImageConverter has no dependencies
+        # BcDecImageConverter plugin dependencies
+        elseif(_component STREQUAL BcDecImageConverter)
+            find_package(Threads REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES Threads::Threads)
+
         # CgltfImporter has no dependencies
         # DdsImporter has no dependencies
 
@@ -378,7 +385,12 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
         # DrFlacAudioImporter has no dependencies
         # DrMp3AudioImporter has no dependencies
         # DrWavAudioImporter has no dependencies
-        # EtcDecImageConverter has no dependencies
+
+        # EtcDecImageConverter plugin dependencies
+        elseif(_component STREQUAL EtcDecImageConverter)
+            find_package(Threads REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES Threads::Threads)
 
         # Faad2AudioImporter plugin dependencies
         elseif(_component STREQUAL Faad2AudioImporter)
@@ -406,8 +418,25 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                 INTERFACE_LINK_LIBRARIES Glslang::Glslang)
 
-        # GltfImporter has no dependencies
-        # GltfSceneConverter has no dependencies
+        # GltfImporter and GltfSceneConverter plugin dependencies
+        elseif(_component STREQUAL GltfImporter OR _component STREQUAL GltfSceneConverter)
+            # Our own build may depend on meshoptimizer for
+            # EXT_meshopt_compression support. Include it if present,
+            # otherwise assume it's compiled without.
+            if(NOT TARGET meshoptimizer)
+                find_package(meshoptimizer CONFIG QUIET)
+                if(meshoptimizer_FOUND)
+                    set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                        INTERFACE_LINK_LIBRARIES meshoptimizer::meshoptimizer)
+                endif()
+            else()
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES meshoptimizer)
+            endif()
+            # Both plugins decode / encode images on multiple threads
+            find_package(Threads REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES Threads::Threads)
 
         # HarfBuzzFont plugin dependencies
         elseif(_component STREQUAL HarfBuzzFont)
@@ -441,9 +470,40 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
                 set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                     INTERFACE_LINK_LIBRARIES ${JPEG_LIBRARIES})
             endif()
+            # JpegImageConverter encodes image strips on multiple threads
+            if(_component STREQUAL JpegImageConverter)
+                find_package(Threads REQUIRED)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES Threads::Threads)
+            endif()
 
-        # KtxImageConverter has no dependencies
-        # KtxImporter has no dependencies
+        # KtxImageConverter plugin dependencies
+        elseif(_component STREQUAL KtxImageConverter)
+            # Zstd is optional, used for Zstandard supercompression, with the
+            # levels compressed on multiple threads. Include it if present,
+            # otherwise assume it's compiled without.
+            find_package(Zstd)
+            if(Zstd_FOUND)
+                find_package(Threads REQUIRED)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES Zstd::Zstd Threads::Threads)
+            endif()
+
+        # KtxImporter plugin dependencies
+        elseif(_component STREQUAL KtxImporter)
+            # Zstd and zlib are optional, used for Zstandard and ZLIB
+            # supercompression. Include them if present, otherwise assume
+            # it's compiled without.
+            find_package(Zstd)
+            if(Zstd_FOUND)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES Zstd::Zstd)
+            endif()
+            find_package(ZLIB)
+            if(ZLIB_FOUND)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES ZLIB::ZLIB)
+            endif()
 
         # MeshOptimizerSceneConverter plugin dependencies
         elseif(_component STREQUAL MeshOptimizerSceneConverter)
@@ -496,6 +556,13 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
                 set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                     INTERFACE_LINK_LIBRARIES ${PNG_LIBRARIES})
             endif()
+            # PngImageConverter filters and compresses row chunks on multiple
+            # threads
+            if(_component STREQUAL PngImageConverter)
+                find_package(Threads REQUIRED)
+                set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                    INTERFACE_LINK_LIBRARIES Threads::Threads)
+            endif()
 
         # PrimitiveImporter has no dependencies
 
@@ -513,7 +580,13 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
 
         # StanfordImporter has no dependencies
         # StanfordSceneConverter has no dependencies
-        # StbDxtImageConverter has no dependencies
+
+        # StbDxtImageConverter plugin dependencies
+        elseif(_component STREQUAL StbDxtImageConverter)
+            find_package(Threads REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES Threads::Threads)
+
         # StbImageConverter has no dependencies
 
         # StbImageImporter plugin dependencies
@@ -545,8 +618,8 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
         # UfbxImporter has no dependencies
         # TinyGltfImporter has no dependencies
 
-        # WebPImporter plugin dependencies
-        elseif(_component STREQUAL WebPImporter)
+        # WebPImporter / WebPImageConverter plugin dependencies
+        elseif(_component STREQUAL WebPImageConverter OR _component STREQUAL WebPImporter)
             find_package(WebP REQUIRED)
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                 INTERFACE_LINK_LIBRARIES WebP::WebP)
@@ -143,6 +143,7 @@ cmake .. ^
     -DMAGNUM_WITH_STLIMPORTER=ON ^
     -DMAGNUM_WITH_TINYGLTFIMPORTER=ON ^
     -DMAGNUM_WITH_UFBXIMPORTER=ON ^
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=OFF ^
     -DMAGNUM_WITH_WEBPIMPORTER=OFF ^
     -DMAGNUM_BUILD_TESTS=ON ^
     -DMAGNUM_BUILD_GL_TESTS=ON ^
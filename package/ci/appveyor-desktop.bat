@@ -113,6 +113,7 @@ cmake .. ^
     -DMAGNUM_WITH_STLIMPORTER=ON ^
     -DMAGNUM_WITH_TINYGLTFIMPORTER=ON ^
     -DMAGNUM_WITH_UFBXIMPORTER=ON ^
+    -DMAGNUM_WITH_WEBPIMAGECONVERTER=ON ^
     -DMAGNUM_WITH_WEBPIMPORTER=ON ^
     -DMAGNUM_BUILD_TESTS=ON ^
     -DMAGNUM_BUILD_GL_TESTS=ON ^
@@ -25,10 +25,13 @@
 
 #include "BcDecImageConverter.h"
 
+#include <thread>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -45,17 +48,33 @@ ImageConverterFeatures BcDecImageConverter::doFeatures() const { return ImageCon
 
 namespace {
 
-template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst) {
-    const std::size_t yBlocks = src.size()[0];
+/* Decodes block rows [begin, end). Each block is decoded independently so the
+   output doesn't depend on how the rows get split. */
+template<void(*decodeBlock)(const void*, void*, int)> void decodeBlockRows(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, const std::size_t begin, const std::size_t end) {
     const std::size_t xBlocks = src.size()[1];
-    CORRADE_INTERNAL_ASSERT(dst.size()[0] == yBlocks*4 &&
-                            dst.size()[1] == xBlocks*4);
     const std::size_t dstRowStride = dst.stride()[0];
-    for(std::size_t y = 0; y != yBlocks; ++y)
+    for(std::size_t y = begin; y != end; ++y)
         for(std::size_t x = 0; x != xBlocks; ++x)
             decodeBlock(&src[{y, x}], &dst[{y*4, x*4}], dstRowStride);
 }
 
+template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, UnsignedInt threadCount) {
+    const std::size_t yBlocks = src.size()[0];
+    CORRADE_INTERNAL_ASSERT(dst.size()[0] == yBlocks*4 &&
+                            dst.size()[1] == src.size()[1]*4);
+
+    /* Split block rows into contiguous ranges, one per thread, with the
+       calling thread processing the first range. There's no point in having
+       more threads than rows. */
+    threadCount = Math::max(Math::min(std::size_t(threadCount), yBlocks), std::size_t{1});
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{decodeBlockRows<decodeBlock>, src, dst, yBlocks*(i + 1)/threadCount, yBlocks*(i + 2)/threadCount};
+    decodeBlockRows<decodeBlock>(src, dst, 0, yBlocks/threadCount);
+    for(std::thread& thread: threads)
+        thread.join();
+}
+
 /* To make bcdec_bc6h_float() / bcdec_bc6h_half() the same signature as the
    others to use in decodeBlocks() above */
 template<void(*decodeBlock)(const void*, void*, int, int), bool isSigned, int typeSize> inline void decodeBc6hBlock(const void* src, void* dst, int rowStride) {
@@ -69,6 +88,13 @@ template<void(*decodeBlock)(const void*, void*, int, int), bool isSigned, int ty
 Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const CompressedImageView2D& image) {
     const bool bc6hToFloat = configuration().value<bool>("bc6hToFloat");
 
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) {
+        threadCount = std::thread::hardware_concurrency();
+        if(flags() & ImageConverterFlag::Verbose)
+            Debug{} << "Trade::BcDecImageConverter::convert(): autodetected hardware concurrency to" << threadCount << "threads";
+    }
+
     /* Decide on target pixel format */
     PixelFormat format;
     switch(image.format()) {
@@ -159,37 +185,37 @@ Containers::Optional<ImageData2D> BcDecImageConverter::doConvert(const Compresse
         case CompressedPixelFormat::Bc1RGBAUnorm:
         case CompressedPixelFormat::Bc1RGBSrgb:
         case CompressedPixelFormat::Bc1RGBASrgb:
-            decodeBlocks<bcdec_bc1>(src, dst);
+            decodeBlocks<bcdec_bc1>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc2RGBAUnorm:
         case CompressedPixelFormat::Bc2RGBASrgb:
-            decodeBlocks<bcdec_bc2>(src, dst);
+            decodeBlocks<bcdec_bc2>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc3RGBAUnorm:
         case CompressedPixelFormat::Bc3RGBASrgb:
-            decodeBlocks<bcdec_bc3>(src, dst);
+            decodeBlocks<bcdec_bc3>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc4RUnorm:
         case CompressedPixelFormat::Bc4RSnorm:
-            decodeBlocks<bcdec_bc4>(src, dst);
+            decodeBlocks<bcdec_bc4>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc5RGUnorm:
         case CompressedPixelFormat::Bc5RGSnorm:
-            decodeBlocks<bcdec_bc5>(src, dst);
+            decodeBlocks<bcdec_bc5>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc6hRGBUfloat:
             bc6hToFloat ?
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_float, false, 4>>(src, dst) :
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_half, false, 2>>(src, dst);
+                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_float, false, 4>>(src, dst, threadCount) :
+                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_half, false, 2>>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc6hRGBSfloat:
             bc6hToFloat ?
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_float, true, 4>>(src, dst) :
-                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_half, true, 2>>(src, dst);
+                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_float, true, 4>>(src, dst, threadCount) :
+                decodeBlocks<decodeBc6hBlock<bcdec_bc6h_half, true, 2>>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Bc7RGBAUnorm:
         case CompressedPixelFormat::Bc7RGBASrgb:
-            decodeBlocks<bcdec_bc7>(src, dst);
+            decodeBlocks<bcdec_bc7>(src, dst, threadCount);
             break;
         /* Unsupported formats already handled above */
         default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
@@ -27,9 +27,12 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/DebugTools/CompareImage.h>
@@ -50,6 +53,10 @@ struct BcDecImageConverterTest: TestSuite::Tester {
     void unsupportedFormat();
     void unsupportedStorage();
 
+    void threads();
+
+    void benchmark();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -160,6 +167,47 @@ const struct {
         {}, {}, 3.5f, 0.41f},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    ImageConverterFlags flags;
+} ThreadsData[]{
+    {"2 threads", 2, {}},
+    /* 11 block rows in total, so the ranges aren't all the same size */
+    {"5 threads", 5, {}},
+    {"more threads than block rows", 100, {}},
+    {"autodetected thread count", 0, {}},
+    {"autodetected thread count, verbose", 0, ImageConverterFlag::Verbose},
+};
+
+const struct {
+    const char* name;
+    CompressedPixelFormat format;
+    UnsignedInt threads;
+} BenchmarkData[]{
+    {"BC1 RGBA", CompressedPixelFormat::Bc1RGBAUnorm, 1},
+    {"BC2 RGBA", CompressedPixelFormat::Bc2RGBAUnorm, 1},
+    {"BC3 RGBA", CompressedPixelFormat::Bc3RGBAUnorm, 1},
+    {"BC4", CompressedPixelFormat::Bc4RUnorm, 1},
+    {"BC5", CompressedPixelFormat::Bc5RGUnorm, 1},
+    {"BC6H unsigned", CompressedPixelFormat::Bc6hRGBUfloat, 1},
+    {"BC7", CompressedPixelFormat::Bc7RGBAUnorm, 1},
+    {"BC7, autodetected thread count", CompressedPixelFormat::Bc7RGBAUnorm, 0},
+};
+
+/* Deterministic pseudo-random block data. Not all bit patterns are meaningful
+   for all formats but the decoders handle any input, which is enough for
+   verifying the thread splitting and for measuring decoding speed. */
+Containers::Array<char> randomBlockData(std::size_t size) {
+    Containers::Array<char> out{NoInit, size};
+    UnsignedInt state = 0x1234567;
+    for(char& i: out) {
+        state = state*1103515245u + 12345u;
+        i = char(state >> 24);
+    }
+    return out;
+}
+
 BcDecImageConverterTest::BcDecImageConverterTest() {
     addInstancedTests({&BcDecImageConverterTest::test},
         Containers::arraySize(TestData));
@@ -169,6 +217,12 @@ BcDecImageConverterTest::BcDecImageConverterTest() {
               &BcDecImageConverterTest::unsupportedFormat,
               &BcDecImageConverterTest::unsupportedStorage});
 
+    addInstancedTests({&BcDecImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addInstancedBenchmarks({&BcDecImageConverterTest::benchmark}, 10,
+        Containers::arraySize(BenchmarkData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef BCDECIMAGECONVERTER_PLUGIN_FILENAME
@@ -286,6 +340,63 @@ void BcDecImageConverterTest::unsupportedStorage() {
     CORRADE_COMPARE(out.str(), "Trade::BcDecImageConverter::convert(): non-default compressed storage is not supported\n");
 }
 
+void BcDecImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* 15x11 blocks, with the last ones incomplete */
+    const Containers::Array<char> blocks = randomBlockData(15*11*compressedPixelFormatBlockDataSize(CompressedPixelFormat::Bc7RGBAUnorm));
+    const CompressedImageView2D image{CompressedPixelFormat::Bc7RGBAUnorm, {59, 42}, blocks};
+
+    /* Single-threaded output as the reference */
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    Containers::Optional<ImageData2D> expected = converter->convert(image);
+    CORRADE_VERIFY(expected);
+
+    converter->addFlags(data.flags);
+    converter->configuration().setValue("threads", data.threads);
+
+    std::ostringstream out;
+    Containers::Optional<ImageData2D> converted;
+    {
+        Debug redirectOutput{&out};
+        converted = converter->convert(image);
+    }
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->format(), expected->format());
+    CORRADE_COMPARE(converted->size(), (Vector2i{59, 42}));
+    if(data.flags & ImageConverterFlag::Verbose)
+        CORRADE_COMPARE_AS(out.str(),
+            "Trade::BcDecImageConverter::convert(): autodetected hardware concurrency to ",
+            TestSuite::Compare::StringHasPrefix);
+    else
+        CORRADE_COMPARE(out.str(), "");
+
+    /* The output should be bit-identical to the single-threaded case */
+    CORRADE_COMPARE_AS(converted->data(), expected->data(),
+        TestSuite::Compare::Container);
+}
+
+void BcDecImageConverterTest::benchmark() {
+    auto&& data = BenchmarkData[testCaseInstanceId()];
+    /* The image is exactly one megapixel, so the time per iteration is an
+       inverse of the megapixels per second throughput */
+    setTestCaseDescription(Utility::format("{}, 1024x1024", data.name));
+
+    const Containers::Array<char> blocks = randomBlockData(256*256*compressedPixelFormatBlockDataSize(data.format));
+    const CompressedImageView2D image{data.format, {1024, 1024}, blocks};
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("BcDecImageConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    Containers::Optional<ImageData2D> converted;
+    CORRADE_BENCHMARK(1)
+        converted = converter->convert(image);
+
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), (Vector2i{1024, 1024}));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::BcDecImageConverterTest)
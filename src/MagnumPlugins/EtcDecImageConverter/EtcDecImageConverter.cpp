@@ -25,10 +25,13 @@
 
 #include "EtcDecImageConverter.h"
 
+#include <thread>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -45,17 +48,33 @@ ImageConverterFeatures EtcDecImageConverter::doFeatures() const { return ImageCo
 
 namespace {
 
-template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst) {
-    const std::size_t yBlocks = src.size()[0];
+/* Decodes block rows [begin, end). Each block is decoded independently so the
+   output doesn't depend on how the rows get split. */
+template<void(*decodeBlock)(const void*, void*, int)> void decodeBlockRows(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, const std::size_t begin, const std::size_t end) {
     const std::size_t xBlocks = src.size()[1];
-    CORRADE_INTERNAL_ASSERT(dst.size()[0] == yBlocks*4 &&
-                            dst.size()[1] == xBlocks*4);
     const std::size_t dstRowStride = dst.stride()[0];
-    for(std::size_t y = 0; y != yBlocks; ++y)
+    for(std::size_t y = begin; y != end; ++y)
         for(std::size_t x = 0; x != xBlocks; ++x)
             decodeBlock(&src[{y, x}], &dst[{y*4, x*4}], dstRowStride);
 }
 
+template<void(*decodeBlock)(const void*, void*, int)> void decodeBlocks(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView2D<char>& dst, UnsignedInt threadCount) {
+    const std::size_t yBlocks = src.size()[0];
+    CORRADE_INTERNAL_ASSERT(dst.size()[0] == yBlocks*4 &&
+                            dst.size()[1] == src.size()[1]*4);
+
+    /* Split block rows into contiguous ranges, one per thread, with the
+       calling thread processing the first range. There's no point in having
+       more threads than rows. */
+    threadCount = Math::max(Math::min(std::size_t(threadCount), yBlocks), std::size_t{1});
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{decodeBlockRows<decodeBlock>, src, dst, yBlocks*(i + 1)/threadCount, yBlocks*(i + 2)/threadCount};
+    decodeBlockRows<decodeBlock>(src, dst, 0, yBlocks/threadCount);
+    for(std::thread& thread: threads)
+        thread.join();
+}
+
 /* To make etcdec_eac_r11_float() / etcdec_eac_rg11_float() the same signature
    as the others to use in decodeBlocks() above */
 template<void(*decodeBlock)(const void*, void*, int, int), bool isSigned> inline void decodeEacFloatBlock(const void* src, void* dst, int rowStride) {
@@ -69,6 +88,13 @@ template<void(*decodeBlock)(const void*, void*, int, int), bool isSigned> inline
 Containers::Optional<ImageData2D> EtcDecImageConverter::doConvert(const CompressedImageView2D& image) {
     const bool eacToFloat = configuration().value<bool>("eacToFloat");
 
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) {
+        threadCount = std::thread::hardware_concurrency();
+        if(flags() & ImageConverterFlag::Verbose)
+            Debug{} << "Trade::EtcDecImageConverter::convert(): autodetected hardware concurrency to" << threadCount << "threads";
+    }
+
     /* Decide on target pixel format */
     PixelFormat format;
     switch(image.format()) {
@@ -155,35 +181,35 @@ Containers::Optional<ImageData2D> EtcDecImageConverter::doConvert(const Compress
     switch(image.format()) {
         case CompressedPixelFormat::EacR11Unorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, false>>(src, dst) :
-                decodeBlocks<etcdec_eac_r11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, false>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_r11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::EacR11Snorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, true>>(src, dst) :
-                decodeBlocks<etcdec_eac_r11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_r11_float, true>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_r11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::EacRG11Unorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, false>>(src, dst) :
-                decodeBlocks<etcdec_eac_rg11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, false>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_rg11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::EacRG11Snorm:
             eacToFloat ?
-                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, true>>(src, dst) :
-                decodeBlocks<etcdec_eac_rg11_u16>(src, dst);
+                decodeBlocks<decodeEacFloatBlock<etcdec_eac_rg11_float, true>>(src, dst, threadCount) :
+                decodeBlocks<etcdec_eac_rg11_u16>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Etc2RGB8Unorm:
         case CompressedPixelFormat::Etc2RGB8Srgb:
-            decodeBlocks<etcdec_etc_rgb>(src, dst);
+            decodeBlocks<etcdec_etc_rgb>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Etc2RGB8A1Unorm:
         case CompressedPixelFormat::Etc2RGB8A1Srgb:
-            decodeBlocks<etcdec_etc_rgb_a1>(src, dst);
+            decodeBlocks<etcdec_etc_rgb_a1>(src, dst, threadCount);
             break;
         case CompressedPixelFormat::Etc2RGBA8Unorm:
         case CompressedPixelFormat::Etc2RGBA8Srgb:
-            decodeBlocks<etcdec_eac_rgba>(src, dst);
+            decodeBlocks<etcdec_eac_rgba>(src, dst, threadCount);
             break;
         /* Unsupported formats already handled above */
         default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
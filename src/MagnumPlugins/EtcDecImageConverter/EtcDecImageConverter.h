@@ -145,6 +145,12 @@ isn't supported in input images.
 Only 2D image conversion is supported at the moment. Image flags, if any, are
 passed through unchanged.
 
+The decoding can be spread across multiple threads using the
+@cb{.ini} threads @ce @ref Trade-EtcDecImageConverter-configuration "configuration option".
+As each block is decoded independently, the output is the same regardless of
+the thread count. The plugin recognizes @ref ImageConverterFlag::Verbose,
+printing the autodetected thread count if the option is set to @cb{.ini} 0 @ce.
+
 @section Trade-EtcDecImageConverter-configuration Plugin-specific configuration
 
 It's possible to tune various conversion options through @ref configuration().
@@ -27,9 +27,12 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/DebugTools/CompareImage.h>
@@ -50,6 +53,10 @@ struct EtcDecImageConverterTest: TestSuite::Tester {
     void unsupportedFormat();
     void unsupportedStorage();
 
+    void threads();
+
+    void benchmark();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -119,6 +126,45 @@ const struct {
         true, {}, {}, {}, 17.0f, 1.62f},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    ImageConverterFlags flags;
+} ThreadsData[]{
+    {"2 threads", 2, {}},
+    /* 11 block rows in total, so the ranges aren't all the same size */
+    {"5 threads", 5, {}},
+    {"more threads than block rows", 100, {}},
+    {"autodetected thread count", 0, {}},
+    {"autodetected thread count, verbose", 0, ImageConverterFlag::Verbose},
+};
+
+const struct {
+    const char* name;
+    CompressedPixelFormat format;
+    UnsignedInt threads;
+} BenchmarkData[]{
+    {"EAC R11", CompressedPixelFormat::EacR11Unorm, 1},
+    {"EAC RG11", CompressedPixelFormat::EacRG11Unorm, 1},
+    {"ETC2 RGB8", CompressedPixelFormat::Etc2RGB8Unorm, 1},
+    {"ETC2 RGB8A1", CompressedPixelFormat::Etc2RGB8A1Unorm, 1},
+    {"ETC2 RGBA8", CompressedPixelFormat::Etc2RGBA8Unorm, 1},
+    {"ETC2 RGBA8, autodetected thread count", CompressedPixelFormat::Etc2RGBA8Unorm, 0},
+};
+
+/* Deterministic pseudo-random block data. Not all bit patterns are meaningful
+   for all formats but the decoders handle any input, which is enough for
+   verifying the thread splitting and for measuring decoding speed. */
+Containers::Array<char> randomBlockData(std::size_t size) {
+    Containers::Array<char> out{NoInit, size};
+    UnsignedInt state = 0x1234567;
+    for(char& i: out) {
+        state = state*1103515245u + 12345u;
+        i = char(state >> 24);
+    }
+    return out;
+}
+
 EtcDecImageConverterTest::EtcDecImageConverterTest() {
     addInstancedTests({&EtcDecImageConverterTest::test},
         Containers::arraySize(TestData));
@@ -128,6 +174,12 @@ EtcDecImageConverterTest::EtcDecImageConverterTest() {
               &EtcDecImageConverterTest::unsupportedFormat,
               &EtcDecImageConverterTest::unsupportedStorage});
 
+    addInstancedTests({&EtcDecImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addInstancedBenchmarks({&EtcDecImageConverterTest::benchmark}, 10,
+        Containers::arraySize(BenchmarkData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef ETCDECIMAGECONVERTER_PLUGIN_FILENAME
@@ -240,6 +292,63 @@ void EtcDecImageConverterTest::unsupportedStorage() {
     CORRADE_COMPARE(out.str(), "Trade::EtcDecImageConverter::convert(): non-default compressed storage is not supported\n");
 }
 
+void EtcDecImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* 15x11 blocks, with the last ones incomplete */
+    const Containers::Array<char> blocks = randomBlockData(15*11*compressedPixelFormatBlockDataSize(CompressedPixelFormat::Etc2RGBA8Unorm));
+    const CompressedImageView2D image{CompressedPixelFormat::Etc2RGBA8Unorm, {59, 42}, blocks};
+
+    /* Single-threaded output as the reference */
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("EtcDecImageConverter");
+    Containers::Optional<ImageData2D> expected = converter->convert(image);
+    CORRADE_VERIFY(expected);
+
+    converter->addFlags(data.flags);
+    converter->configuration().setValue("threads", data.threads);
+
+    std::ostringstream out;
+    Containers::Optional<ImageData2D> converted;
+    {
+        Debug redirectOutput{&out};
+        converted = converter->convert(image);
+    }
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->format(), expected->format());
+    CORRADE_COMPARE(converted->size(), (Vector2i{59, 42}));
+    if(data.flags & ImageConverterFlag::Verbose)
+        CORRADE_COMPARE_AS(out.str(),
+            "Trade::EtcDecImageConverter::convert(): autodetected hardware concurrency to ",
+            TestSuite::Compare::StringHasPrefix);
+    else
+        CORRADE_COMPARE(out.str(), "");
+
+    /* The output should be bit-identical to the single-threaded case */
+    CORRADE_COMPARE_AS(converted->data(), expected->data(),
+        TestSuite::Compare::Container);
+}
+
+void EtcDecImageConverterTest::benchmark() {
+    auto&& data = BenchmarkData[testCaseInstanceId()];
+    /* The image is exactly one megapixel, so the time per iteration is an
+       inverse of the megapixels per second throughput */
+    setTestCaseDescription(Utility::format("{}, 1024x1024", data.name));
+
+    const Containers::Array<char> blocks = randomBlockData(256*256*compressedPixelFormatBlockDataSize(data.format));
+    const CompressedImageView2D image{data.format, {1024, 1024}, blocks};
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("EtcDecImageConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    Containers::Optional<ImageData2D> converted;
+    CORRADE_BENCHMARK(1)
+        converted = converter->convert(image);
+
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), (Vector2i{1024, 1024}));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::EtcDecImageConverterTest)
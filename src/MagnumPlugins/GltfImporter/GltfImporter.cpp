@@ -28,7 +28,10 @@
 #include "GltfImporter.h"
 
 #include <algorithm> /* std::stable_sort() */
+#include <atomic>
 #include <cctype>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayTuple.h>
@@ -41,6 +44,7 @@
 #include <Corrade/Containers/StridedBitArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Containers/StringStlHash.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Containers/Triple.h>
@@ -57,6 +61,7 @@
 #include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
@@ -72,6 +77,10 @@
 #include "MagnumPlugins/GltfImporter/decode.h"
 #include "MagnumPlugins/GltfImporter/Gltf.h"
 
+#ifdef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+#include <meshoptimizer.h>
+#endif
+
 /* Otherwise std::unique() fails to compile on MSVC 2015 and libc++ 15 (commit
    https://github.com/llvm/llvm-project/commit/c9905b8cb0139f410ce63081989a328559e11374) */
 #if defined(CORRADE_MSVC2015_COMPATIBILITY) || (defined(CORRADE_TARGET_LIBCXX) && _LIBCPP_VERSION >= 15)
@@ -141,6 +150,15 @@ struct GltfImporter::Document {
     Containers::Optional<Utility::Json> gltf;
     Containers::Optional<Containers::ArrayView<const char>> binChunk;
 
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    /* If openFile() was used without a file callback, the file is
+       memory-mapped and fileData is a non-owning view on it. External
+       buffers loaded without a file callback are memory-mapped as well, with
+       their entries in `buffers` being non-owning views on these. */
+    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mappedFileData;
+    Containers::Array<Containers::Array<const char, Utility::Path::MapDeleter>> mappedBuffers;
+    #endif
+
     /* Constant-time access to glTF data and their names. All these are checked
        to be object tokens during the initial import. Buffers, buffer views,
        accessors and samplers have names defined as well but we don't provide
@@ -169,6 +187,11 @@ struct GltfImporter::Document {
        stay a NullOpt, meaning the same failure message will be printed next
        time it's accessed. */
     Containers::Array<Containers::Optional<Containers::Array<char>>> buffers;
+    /* Whether given buffer is a EXT_meshopt_compression fallback. Such
+       buffers are allocated zero-filled in parseBuffer() and compressed
+       buffer views get decoded into them on-demand in parseBufferView(). Only
+       used if the plugin is built with meshoptimizer. */
+    Containers::Array<bool> meshoptFallbackBuffers;
     /* Parsed and validated buffer views, second element is stride (or 0 if not
        strided), third is buffer ID. Same as with buffers, if any of these
        failed to validate, it'll stay a NullOpt, meaning the same failure
@@ -189,6 +212,11 @@ struct GltfImporter::Document {
        better than "normalized VEC3 of 5121 is not a supported normal format"
        no matter how well formatted. */
     Containers::Array<Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>> accessors;
+    /* How many times parseAccessor() returned an already parsed accessor and
+       how many times it had to parse it. Printed on close() if
+       ImporterFlag::Verbose is enabled. */
+    std::size_t accessorCacheHits = 0;
+    std::size_t accessorCacheMisses = 0;
     /* Cached parsed samplers. Values left uninitialized, they will be set to
        appropriate default values inside doTexture(). */
     struct Sampler {
@@ -230,8 +258,16 @@ struct GltfImporter::Document {
         images3DForName,
         texturesForName;
 
-    /* Unlike the ones above, these are filled already during construction as
-       we need them in three different places and on-demand construction would
+    /* Whether the node hierarchy was validated and custom scene fields from
+       node extras discovered. Done during opening unless the
+       lazyNodeProcessing option is enabled, in which case it's done on the
+       first scene-related call. */
+    bool nodesProcessed = false;
+
+    /* Unlike the ones above, these are filled already during opening -- the
+       scene fields in processNodes(), which may get deferred with the
+       lazyNodeProcessing option, the mesh attributes unconditionally -- as we
+       need them in three different places and on-demand construction would
        be too annoying to test. The key has to be a full string and not views
        on object keys inside the Json instance because it's joined with dots
        for nested objects. */
@@ -252,6 +288,10 @@ struct GltfImporter::Document {
        STL guarantees iterator stability, i.e. the strings don't get moved
        anywhere even with SSO */
     Containers::Array<Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>> sceneFieldNamesTypesFlags;
+    /* ID of the first of the three custom fields for EXT_mesh_gpu_instancing
+       translations, rotations and scalings, registered in processNodes() only
+       if any node uses the extension */
+    Containers::Optional<UnsignedInt> instanceSceneFieldOffset;
     Containers::Array<Containers::StringView> meshAttributeNames{InPlaceInit, {
         #ifdef MAGNUM_BUILD_DEPRECATED
         "JOINTS"_s,
@@ -283,6 +323,19 @@ struct GltfImporter::Document {
 
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+
+    /* If the threads option isn't 1, base levels of all 2D images are decoded
+       in parallel on the first image2D() call and then handed out from here.
+       The image is a NullOpt if decoding failed or if the image was handed
+       out already, in which case it goes through the serial path again. The
+       debug and warning output is printed from the calling thread once the
+       image is handed out, as the output redirection is thread-local. */
+    bool images2DDecoded = false;
+    struct DecodedImage2D {
+        Containers::Optional<ImageData2D> image;
+        Containers::String debug, warning;
+    };
+    Containers::Array<DecodedImage2D> decodedImages2D;
 };
 
 Containers::Optional<Containers::Array<char>> GltfImporter::loadUri(const char* const errorPrefix, const Containers::StringView uri) {
@@ -328,8 +381,19 @@ Containers::Optional<Containers::Array<char>> GltfImporter::loadUri(const char*
 
         const Containers::String fullPath = Utility::Path::join(Utility::Path::split(*_d->filename).first(), *decodedUri);
 
+        /* Memory-map the file if possible so its pages get loaded only once
+           something actually references them. The mapping is kept until the
+           importer is closed, return a non-owning view on it. */
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        if(Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> data = Utility::Path::mapRead(fullPath)) {
+            const Containers::ArrayView<const char> view = *data;
+            arrayAppend(_d->mappedBuffers, Utility::move(*data));
+            return Containers::Array<char>{const_cast<char*>(view.data()), view.size(), [](char*, std::size_t){}};
+        }
+        #else
         if(Containers::Optional<Containers::Array<char>> data = Utility::Path::read(fullPath))
             return data;
+        #endif
 
         Error{} << errorPrefix << "error opening" << fullPath;
         return {};
@@ -356,6 +420,40 @@ Containers::Optional<Containers::ArrayView<const char>> GltfImporter::parseBuffe
         return {};
     }
 
+    /* If the buffer is a EXT_meshopt_compression fallback, its contents don't
+       need to be loaded at all. Instead it's allocated zero-filled here and
+       parseBufferView() then decodes compressed buffer views into it as they
+       get accessed. If the plugin is built without meshoptimizer, the
+       fallback is loaded as any other buffer, if it has any uri. */
+    #ifdef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+    if(const Utility::JsonToken* const gltfBufferExtensions = gltfBuffer.find("extensions"_s)) {
+        if(!_d->gltf->parseObject(*gltfBufferExtensions)) {
+            Error{} << errorPrefix << "buffer" << bufferId << "has invalid extensions property";
+            return {};
+        }
+
+        if(const Utility::JsonToken* const gltfMeshoptCompression = gltfBufferExtensions->find("EXT_meshopt_compression"_s)) {
+            if(!_d->gltf->parseObject(*gltfMeshoptCompression)) {
+                Error{} << errorPrefix << "buffer" << bufferId << "has invalid EXT_meshopt_compression extension";
+                return {};
+            }
+
+            /* Fallback is optional, defaulting to false */
+            const Utility::JsonToken* const gltfFallback = gltfMeshoptCompression->find("fallback"_s);
+            if(gltfFallback && !_d->gltf->parseBool(*gltfFallback)) {
+                Error{} << errorPrefix << "buffer" << bufferId << "has invalid EXT_meshopt_compression fallback property";
+                return {};
+            }
+
+            if(gltfFallback && gltfFallback->asBool()) {
+                storage.emplace(ValueInit, gltfBufferByteLength->asSize());
+                _d->meshoptFallbackBuffers[bufferId] = true;
+                return Containers::ArrayView<const char>{*storage};
+            }
+        }
+    }
+    #endif
+
     Containers::ArrayView<const char> view;
     if(const Utility::JsonToken* gltfBufferUri = gltfBuffer.find("uri"_s)) {
         if(!_d->gltf->parseString(*gltfBufferUri)) {
@@ -443,6 +541,162 @@ Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, Unsig
         return {};
     }
 
+    /* If the view points to a EXT_meshopt_compression fallback buffer, decode
+       the compressed data into it. This is done just once for every buffer
+       view as the result is cached in `storage` below. If the buffer isn't a
+       fallback, it already contains uncompressed data and the extension, if
+       present, is ignored. */
+    #ifdef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+    if(_d->meshoptFallbackBuffers[gltfBufferId->asUnsignedInt()]) {
+        const Utility::JsonToken* const gltfBufferViewExtensions = gltfBufferView.find("extensions"_s);
+        if(gltfBufferViewExtensions && !_d->gltf->parseObject(*gltfBufferViewExtensions)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid extensions property";
+            return {};
+        }
+        const Utility::JsonToken* const gltfMeshoptCompression = gltfBufferViewExtensions ? gltfBufferViewExtensions->find("EXT_meshopt_compression"_s) : nullptr;
+        if(!gltfMeshoptCompression) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "references a EXT_meshopt_compression fallback buffer" << gltfBufferId->asUnsignedInt() << "but isn't compressed";
+            return {};
+        }
+        if(!_d->gltf->parseObject(*gltfMeshoptCompression)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression extension";
+            return {};
+        }
+
+        const Utility::JsonToken* const gltfMeshoptBufferId = gltfMeshoptCompression->find("buffer"_s);
+        if(!gltfMeshoptBufferId || !_d->gltf->parseUnsignedInt(*gltfMeshoptBufferId)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression buffer property";
+            return {};
+        }
+
+        /* Byte offset is optional, defaulting to 0 */
+        const Utility::JsonToken* const gltfMeshoptByteOffset = gltfMeshoptCompression->find("byteOffset"_s);
+        if(gltfMeshoptByteOffset && !_d->gltf->parseSize(*gltfMeshoptByteOffset)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression byteOffset property";
+            return {};
+        }
+
+        const Utility::JsonToken* const gltfMeshoptByteLength = gltfMeshoptCompression->find("byteLength"_s);
+        if(!gltfMeshoptByteLength || !_d->gltf->parseSize(*gltfMeshoptByteLength)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression byteLength property";
+            return {};
+        }
+
+        const Utility::JsonToken* const gltfMeshoptByteStride = gltfMeshoptCompression->find("byteStride"_s);
+        if(!gltfMeshoptByteStride || !_d->gltf->parseUnsignedInt(*gltfMeshoptByteStride)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression byteStride property";
+            return {};
+        }
+
+        const Utility::JsonToken* const gltfMeshoptCount = gltfMeshoptCompression->find("count"_s);
+        if(!gltfMeshoptCount || !_d->gltf->parseSize(*gltfMeshoptCount)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression count property";
+            return {};
+        }
+
+        const Utility::JsonToken* const gltfMeshoptMode = gltfMeshoptCompression->find("mode"_s);
+        if(!gltfMeshoptMode || !_d->gltf->parseString(*gltfMeshoptMode)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has missing or invalid EXT_meshopt_compression mode property";
+            return {};
+        }
+
+        /* Filter is optional, defaulting to NONE */
+        const Utility::JsonToken* const gltfMeshoptFilter = gltfMeshoptCompression->find("filter"_s);
+        if(gltfMeshoptFilter && !_d->gltf->parseString(*gltfMeshoptFilter)) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression filter property";
+            return {};
+        }
+
+        const Containers::StringView mode = gltfMeshoptMode->asString();
+        const Containers::StringView filter = gltfMeshoptFilter ? gltfMeshoptFilter->asString() : "NONE"_s;
+        const std::size_t count = gltfMeshoptCount->asSize();
+        const UnsignedInt stride = gltfMeshoptByteStride->asUnsignedInt();
+
+        /* Check stride, count and filter restrictions for each mode. These
+           are the same restrictions the meshoptimizer decoders assert on. */
+        if(mode == "ATTRIBUTES"_s) {
+            if(stride == 0 || stride % 4 != 0 || stride > 256) {
+                Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression byteStride" << stride << "for ATTRIBUTES, expected a multiple of 4 not larger than 256";
+                return {};
+            }
+            if(!(filter == "NONE"_s ||
+                (filter == "OCTAHEDRAL"_s && (stride == 4 || stride == 8)) ||
+                (filter == "QUATERNION"_s && stride == 8) ||
+                 filter == "EXPONENTIAL"_s)) {
+                Error{} << errorPrefix << "buffer view" << bufferViewId << "has unsupported EXT_meshopt_compression filter" << filter << "with byteStride" << stride;
+                return {};
+            }
+        } else if(mode == "TRIANGLES"_s || mode == "INDICES"_s) {
+            if(stride != 2 && stride != 4) {
+                Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression byteStride" << stride << "for" << mode << Debug::nospace << ", expected 2 or 4";
+                return {};
+            }
+            if(mode == "TRIANGLES"_s && count % 3 != 0) {
+                Error{} << errorPrefix << "buffer view" << bufferViewId << "has invalid EXT_meshopt_compression count" << count << "for TRIANGLES, expected a multiple of 3";
+                return {};
+            }
+            if(filter != "NONE"_s) {
+                Error{} << errorPrefix << "buffer view" << bufferViewId << "has unsupported EXT_meshopt_compression filter" << filter << "for" << mode;
+                return {};
+            }
+        } else {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has unrecognized EXT_meshopt_compression mode" << mode;
+            return {};
+        }
+
+        /* The stride is never zero at this point, but better be safe than
+           sorry */
+        if(stride && count > ~std::size_t{}/stride) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "has too large EXT_meshopt_compression count" << count << "for byteStride" << stride;
+            return {};
+        }
+        if(count*stride > gltfByteLength->asSize()) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "needs" << count*stride << "bytes for" << count << "decoded EXT_meshopt_compression elements but has only" << gltfByteLength->asSize();
+            return {};
+        }
+
+        /* Get the buffer with compressed data, continue only if that doesn't
+           fail. Like above, this also checks that the buffer ID is in
+           bounds. */
+        Containers::Optional<Containers::ArrayView<const char>> compressedBuffer = parseBuffer(errorPrefix, gltfMeshoptBufferId->asUnsignedInt());
+        if(!compressedBuffer) return {};
+
+        const std::size_t compressedOffset = gltfMeshoptByteOffset ? gltfMeshoptByteOffset->asSize() : 0;
+        const std::size_t requiredCompressedBufferSize = compressedOffset + gltfMeshoptByteLength->asSize();
+        if(compressedBuffer->size() < requiredCompressedBufferSize) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "needs" << requiredCompressedBufferSize << "bytes of EXT_meshopt_compression data but buffer" << gltfMeshoptBufferId->asUnsignedInt() << "has only" << compressedBuffer->size();
+            return {};
+        }
+
+        const Containers::ArrayView<const unsigned char> compressed = Containers::arrayCast<const unsigned char>(compressedBuffer->slice(compressedOffset, requiredCompressedBufferSize));
+        /* The fallback buffer storage is owned by us, so writing into it is
+           fine */
+        const Containers::ArrayView<char> decoded = Containers::arrayView(*_d->buffers[gltfBufferId->asUnsignedInt()]).slice(offset, offset + count*stride);
+
+        /* The decoders use SIMD where available */
+        int result;
+        if(mode == "ATTRIBUTES"_s)
+            result = meshopt_decodeVertexBuffer(decoded.data(), count, stride, compressed.data(), compressed.size());
+        else if(mode == "TRIANGLES"_s)
+            result = meshopt_decodeIndexBuffer(decoded.data(), count, stride, compressed.data(), compressed.size());
+        else if(mode == "INDICES"_s)
+            result = meshopt_decodeIndexSequence(decoded.data(), count, stride, compressed.data(), compressed.size());
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        if(result != 0) {
+            Error{} << errorPrefix << "buffer view" << bufferViewId << "EXT_meshopt_compression" << mode << "decoding failed with error" << result;
+            return {};
+        }
+
+        /* Apply the filter, if any, in-place */
+        if(filter == "OCTAHEDRAL"_s)
+            meshopt_decodeFilterOct(decoded.data(), count, stride);
+        else if(filter == "QUATERNION"_s)
+            meshopt_decodeFilterQuat(decoded.data(), count, stride);
+        else if(filter == "EXPONENTIAL"_s)
+            meshopt_decodeFilterExp(decoded.data(), count, stride);
+    }
+    #endif
+
     /* If the buffer isn't strided, the first dimension has a zero stride and
        the second is the whole view */
     storage.emplace(
@@ -461,7 +715,11 @@ Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const cha
 
     /* Return if the buffer view is already parsed */
     Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>& storage = _d->accessors[accessorId];
-    if(storage) return storage;
+    if(storage) {
+        ++_d->accessorCacheHits;
+        return storage;
+    }
+    ++_d->accessorCacheMisses;
 
     const Utility::JsonToken& gltfAccessor = _d->gltfAccessors[accessorId];
 
@@ -644,6 +902,9 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     conf.setValue("mergeAnimationClips", false);
     conf.setValue("phongMaterialFallback", true);
     conf.setValue("objectIdAttribute", "_OBJECT_ID");
+    conf.setValue("zeroCopy", false);
+    conf.setValue("threads", 1);
+    conf.setValue("lazyNodeProcessing", false);
 }
 
 }
@@ -666,11 +927,38 @@ ImporterFeatures GltfImporter::doFeatures() const { return ImporterFeature::Open
 
 bool GltfImporter::doIsOpened() const { return !!_d && _d->gltf; }
 
-void GltfImporter::doClose() { _d = nullptr; }
+void GltfImporter::doClose() {
+    if(flags() & ImporterFlag::Verbose)
+        Debug{} << "Trade::GltfImporter::close(): accessor cache had" << _d->accessorCacheHits << "hits and" << _d->accessorCacheMisses << "misses";
+
+    _d = nullptr;
+}
 
 void GltfImporter::doOpenFile(const Containers::StringView filename) {
     _d.reset(new Document);
     _d->filename.emplace(Containers::String::nullTerminatedGlobalView(filename));
+
+    /* Without a file callback, memory-map the file if possible. Opening then
+       touches only the JSON, and pages of the GLB binary chunk get loaded
+       only once something actually references them. */
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    if(!fileCallback()) {
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mappedFileData = Utility::Path::mapRead(filename);
+        if(!mappedFileData) {
+            Error{} << "Trade::GltfImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        /* The mapping is owned by the document, pass it as a non-owning
+           view. Marking it as externally owned so doOpenData() doesn't make a
+           copy. */
+        const Containers::ArrayView<const char> data = *mappedFileData;
+        _d->mappedFileData = Utility::move(mappedFileData);
+        doOpenData(Containers::Array<char>{const_cast<char*>(data.data()), data.size(), [](char*, std::size_t){}}, DataFlag::ExternallyOwned);
+        return;
+    }
+    #endif
+
     AbstractImporter::doOpenFile(filename);
 }
 
@@ -693,8 +981,9 @@ bool isRecognized2DTextureExtension(Containers::StringView name) {
         name == "EXT_texture_webp"_s;
 }
 
-/* Used by doOpenData() but it's recursive and so it can't be a local lambda */
-bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, Containers::Array<Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>>& sceneFieldNamesTypesFlags, const Utility::ConfigurationGroup* const customSceneFieldTypeConfiguration, UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
+/* Used by processNodes() but it's recursive and so it can't be a local
+   lambda */
+bool discoverSceneExtraFields(const char* const errorPrefix, Utility::Json& gltf, std::unordered_map<Containers::String, SceneField>& sceneFieldsForName, Containers::Array<Containers::Triple<Containers::StringView, SceneFieldType, SceneFieldFlags>>& sceneFieldNamesTypesFlags, const Utility::ConfigurationGroup* const customSceneFieldTypeConfiguration, UnsignedInt nodeI, const Containers::StringView key, const Utility::JsonToken& gltfExtraValue) {
     /* If the value is an object, recurse into it. The field name will then be
        all object keys concatenated with dots. */
     if(gltfExtraValue.type() == Utility::JsonToken::Type::Object) {
@@ -703,12 +992,12 @@ bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers
            it'd still print a message to the output which would imply an error
            was silently ignored, which is not any better. */
         if(!gltf.parseObject(gltfExtraValue)) {
-            Error{} << "Trade::GltfImporter::openData(): invalid node" << nodeI << "extras property";
+            Error{} << errorPrefix << "invalid node" << nodeI << "extras property";
             return false;
         }
 
         for(const Utility::JsonObjectItem gltfNestedExtra: gltfExtraValue.asObject()) {
-            if(!discoverSceneExtraFields(
+            if(!discoverSceneExtraFields(errorPrefix,
                 gltf, sceneFieldsForName, sceneFieldNamesTypesFlags,
                 customSceneFieldTypeConfiguration,
                 nodeI, "."_s.join({key, gltfNestedExtra.key()}), gltfNestedExtra.value())
@@ -775,7 +1064,7 @@ bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers
         else {
             /* I expect the type set to grow significantly over time, thus
                listing them all in the error message doesn't scale */
-            Error{} << "Trade::GltfImporter::openData(): invalid type" << typeString << "specified for custom scene field" << key;
+            Error{} << errorPrefix << "invalid type" << typeString << "specified for custom scene field" << key;
             return false;
         }
 
@@ -794,6 +1083,158 @@ bool discoverSceneExtraFields(Utility::Json& gltf, std::unordered_map<Containers
 
 }
 
+bool GltfImporter::processNodes(Utility::Json& gltf, const char* const errorPrefix) {
+    /* Find cycles in node tree. The Tortoise and Hare algorithm relies on
+       elements of the graph having a single outgoing edge, which means we have
+       to build parent links first. During that process we check that nodes
+       don't have multiple parents. */
+    {
+        /* Mark all nodes as unreferenced (-2) first -- if a node isn't
+           referenced from any scene nodes or node children array, it'll stay
+           that way */
+        /** @todo this could be eventually used to compile a "leftovers" scene
+            out of unreferenced nodes */
+        Containers::Array<Int> nodeParents{DirectInit, _d->gltfNodes.size(), -2};
+
+        /* Mark all nodes referenced by a scene as root nodes (-1) */
+        for(std::size_t i = 0; i != _d->gltfScenes.size(); ++i) {
+            const Utility::JsonToken* const gltfSceneNodes = _d->gltfScenes[i].first()->find("nodes"_s);
+            if(!gltfSceneNodes) continue;
+
+            const Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> sceneNodes = gltf.parseUnsignedIntArray(*gltfSceneNodes);
+            if(!sceneNodes) {
+                Error{} << errorPrefix << "invalid nodes property of scene" << i;
+                return false;
+            }
+
+            for(const UnsignedInt node: *sceneNodes) {
+                if(node >= _d->gltfNodes.size()) {
+                    Error{} << errorPrefix << "node index" << node << "in scene" << i << "out of range for" << _d->gltfNodes.size() << "nodes";
+                    return false;
+                }
+
+                /* In this case it's fine if a node is referenced by multiple
+                   scenes (and it's allowed by glTF) */
+                nodeParents[node] = -1;
+            }
+        }
+
+        /* Go through the node hierarchy and mark nested children, discovering
+           potential conflicting parent nodes */
+        for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
+            const Utility::JsonToken* const gltfNodeChildren = _d->gltfNodes[i].first()->find("children"_s);
+            if(!gltfNodeChildren) continue;
+
+            const Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> nodeChildren = gltf.parseUnsignedIntArray(*gltfNodeChildren);
+            if(!nodeChildren) {
+                Error{} << errorPrefix << "invalid children property of node" << i;
+                return false;
+            }
+
+            for(const UnsignedInt child: *nodeChildren) {
+                if(child >= _d->gltfNodes.size()) {
+                    Error{} << errorPrefix << "child index" << child << "in node" << i << "out of range for" << _d->gltfNodes.size() << "nodes";
+                    return false;
+                }
+
+                /* If a referenced child already has a parent assigned, it's a
+                   cycle */
+                if(nodeParents[child] == -1) {
+                    Error{} << errorPrefix << "node" << child << "is both a root node and a child of node" << i;
+                    return false;
+                } else if(nodeParents[child] != -2) {
+                    Error{} << errorPrefix << "node" << child << "is a child of both node" << nodeParents[child] << "and node" << i;
+                    return false;
+                }
+
+                nodeParents[child] = i;
+            }
+        }
+
+        /* Find cycles, Tortoise and Hare */
+        for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
+            Int p1 = nodeParents[i];
+            Int p2 = p1 < 0 ? -1 : nodeParents[p1];
+
+            while(p1 >= 0 && p2 >= 0) {
+                if(p1 == p2) {
+                    Error{} << errorPrefix << "node tree contains cycle starting at node" << i;
+                    return false;
+                }
+
+                p1 = nodeParents[p1];
+                p2 = nodeParents[p2] < 0 ? -1 : nodeParents[nodeParents[p2]];
+            }
+        }
+    }
+
+    /* If any node uses EXT_mesh_gpu_instancing, register custom scene fields
+       for the per-instance transformations. Done before discovering fields
+       from extras so the names are reserved for these. If this function
+       failed before and is called again, the fields are already there. */
+    if(!_d->instanceSceneFieldOffset) for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
+        const Utility::JsonToken* const gltfExtensions = _d->gltfNodes[i].first()->find("extensions"_s);
+        /* Silently skip if extensions isn't a valid object -- the error will
+           be printed when importing the actual scene containing this node */
+        if(!gltfExtensions || gltfExtensions->type() != Utility::JsonToken::Type::Object)
+            continue;
+        {
+            Error redirectError{nullptr};
+            if(!gltf.parseObject(*gltfExtensions))
+                continue;
+        }
+        if(!gltfExtensions->find("EXT_mesh_gpu_instancing"_s))
+            continue;
+
+        const Containers::StringView names[]{
+            "instanceTranslation"_s,
+            "instanceRotation"_s,
+            "instanceScaling"_s
+        };
+        const SceneFieldType types[]{
+            SceneFieldType::Vector3,
+            SceneFieldType::Quaternion,
+            SceneFieldType::Vector3
+        };
+        _d->instanceSceneFieldOffset = _d->sceneFieldNamesTypesFlags.size();
+        for(std::size_t j = 0; j != Containers::arraySize(names); ++j) {
+            const auto inserted = _d->sceneFieldsForName.emplace(names[j], sceneFieldCustom(_d->sceneFieldNamesTypesFlags.size()));
+            CORRADE_INTERNAL_ASSERT(inserted.second);
+            arrayAppend(_d->sceneFieldNamesTypesFlags, InPlaceInit, inserted.first->first, types[j], SceneFieldFlag::MultiEntry);
+        }
+        break;
+    }
+
+    /* Go through all nodes and collect names of extra properties for custom
+       scene fields */
+    for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
+        const Utility::JsonToken& gltfNode = _d->gltfNodes[i].first();
+        const Utility::JsonToken* const gltfExtras = gltfNode.find("extras"_s);
+        /* Silently skip also if extras isn't an object -- the error will be
+           printed when importing the actual scene containing this node */
+        if(!gltfExtras || gltfExtras->type() != Utility::JsonToken::Type::Object)
+            continue;
+        /* However if the object fails to parse because it has invalid keys
+           (i.e., invalid Unicode escapes), fail the whole import. If we
+           wouldn't, it'd still print a message to the output which would imply
+           an error was silently ignored, which is not any better. */
+        if(!gltf.parseObject(*gltfExtras)) {
+            Error{} << errorPrefix << "invalid node" << i << "extras property";
+            return false;
+        }
+
+        /* The process is recursive so it has to be an external function */
+        const Utility::ConfigurationGroup* customSceneFieldTypeConfiguration = configuration().group("customSceneFieldTypes");
+        for(const Utility::JsonObjectItem gltfExtra: gltfExtras->asObject()) {
+            if(!discoverSceneExtraFields(errorPrefix, gltf, _d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, customSceneFieldTypeConfiguration, i, gltfExtra.key(), gltfExtra.value()))
+                return false;
+        }
+    }
+
+    _d->nodesProcessed = true;
+    return true;
+}
+
 void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
     if(!_d) _d.reset(new Document);
 
@@ -955,8 +1396,12 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
             "KHR_texture_transform"_s,
             "GOOGLE_texture_basis"_s,
             "MSFT_texture_dds"_s,
-            "EXT_texture_webp"_s
+            "EXT_texture_webp"_s,
+            "EXT_mesh_gpu_instancing"_s
         });
+        #ifdef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+        arrayAppend(supportedExtensions, "EXT_meshopt_compression"_s);
+        #endif
         if(configuration().value<bool>("experimentalKhrTextureKtx"))
             arrayAppend(supportedExtensions, "KHR_texture_ktx"_s);
 
@@ -1096,115 +1541,10 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
         }
     }
 
-    /* Find cycles in node tree. The Tortoise and Hare algorithm relies on
-       elements of the graph having a single outgoing edge, which means we have
-       to build parent links first. During that process we check that nodes
-       don't have multiple parents. */
-    {
-        /* Mark all nodes as unreferenced (-2) first -- if a node isn't
-           referenced from any scene nodes or node children array, it'll stay
-           that way */
-        /** @todo this could be eventually used to compile a "leftovers" scene
-            out of unreferenced nodes */
-        Containers::Array<Int> nodeParents{DirectInit, _d->gltfNodes.size(), -2};
-
-        /* Mark all nodes referenced by a scene as root nodes (-1) */
-        for(std::size_t i = 0; i != _d->gltfScenes.size(); ++i) {
-            const Utility::JsonToken* const gltfSceneNodes = _d->gltfScenes[i].first()->find("nodes"_s);
-            if(!gltfSceneNodes) continue;
-
-            const Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> sceneNodes = gltf->parseUnsignedIntArray(*gltfSceneNodes);
-            if(!sceneNodes) {
-                Error{} << "Trade::GltfImporter::openData(): invalid nodes property of scene" << i;
-                return;
-            }
-
-            for(const UnsignedInt node: *sceneNodes) {
-                if(node >= _d->gltfNodes.size()) {
-                    Error{} << "Trade::GltfImporter::openData(): node index" << node << "in scene" << i << "out of range for" << _d->gltfNodes.size() << "nodes";
-                    return;
-                }
-
-                /* In this case it's fine if a node is referenced by multiple
-                   scenes (and it's allowed by glTF) */
-                nodeParents[node] = -1;
-            }
-        }
-
-        /* Go through the node hierarchy and mark nested children, discovering
-           potential conflicting parent nodes */
-        for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
-            const Utility::JsonToken* const gltfNodeChildren = _d->gltfNodes[i].first()->find("children"_s);
-            if(!gltfNodeChildren) continue;
-
-            const Containers::Optional<Containers::StridedArrayView1D<const UnsignedInt>> nodeChildren = gltf->parseUnsignedIntArray(*gltfNodeChildren);
-            if(!nodeChildren) {
-                Error{} << "Trade::GltfImporter::openData(): invalid children property of node" << i;
-                return;
-            }
-
-            for(const UnsignedInt child: *nodeChildren) {
-                if(child >= _d->gltfNodes.size()) {
-                    Error{} << "Trade::GltfImporter::openData(): child index" << child << "in node" << i << "out of range for" << _d->gltfNodes.size() << "nodes";
-                    return;
-                }
-
-                /* If a referenced child already has a parent assigned, it's a
-                   cycle */
-                if(nodeParents[child] == -1) {
-                    Error{} << "Trade::GltfImporter::openData(): node" << child << "is both a root node and a child of node" << i;
-                    return;
-                } else if(nodeParents[child] != -2) {
-                    Error{} << "Trade::GltfImporter::openData(): node" << child << "is a child of both node" << nodeParents[child] << "and node" << i;
-                    return;
-                }
-
-                nodeParents[child] = i;
-            }
-        }
-
-        /* Find cycles, Tortoise and Hare */
-        for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
-            Int p1 = nodeParents[i];
-            Int p2 = p1 < 0 ? -1 : nodeParents[p1];
-
-            while(p1 >= 0 && p2 >= 0) {
-                if(p1 == p2) {
-                    Error{} << "Trade::GltfImporter::openData(): node tree contains cycle starting at node" << i;
-                    return;
-                }
-
-                p1 = nodeParents[p1];
-                p2 = nodeParents[p2] < 0 ? -1 : nodeParents[nodeParents[p2]];
-            }
-        }
-    }
-
-    /* Go through all nodes and collect names of extra properties for custom
-       scene fields */
-    for(std::size_t i = 0; i != _d->gltfNodes.size(); ++i) {
-        const Utility::JsonToken& gltfNode = _d->gltfNodes[i].first();
-        const Utility::JsonToken* const gltfExtras = gltfNode.find("extras"_s);
-        /* Silently skip also if extras isn't an object -- the error will be
-           printed when importing the actual scene containing this node */
-        if(!gltfExtras || gltfExtras->type() != Utility::JsonToken::Type::Object)
-            continue;
-        /* However if the object fails to parse because it has invalid keys
-           (i.e., invalid Unicode escapes), fail the whole import. If we
-           wouldn't, it'd still print a message to the output which would imply
-           an error was silently ignored, which is not any better. */
-        if(!gltf->parseObject(*gltfExtras)) {
-            Error{} << "Trade::GltfImporter::openData(): invalid node" << i << "extras property";
-            return;
-        }
-
-        /* The process is recursive so it has to be an external function */
-        const Utility::ConfigurationGroup* customSceneFieldTypeConfiguration = configuration().group("customSceneFieldTypes");
-        for(const Utility::JsonObjectItem gltfExtra: gltfExtras->asObject()) {
-            if(!discoverSceneExtraFields(*gltf, _d->sceneFieldsForName, _d->sceneFieldNamesTypesFlags, customSceneFieldTypeConfiguration, i, gltfExtra.key(), gltfExtra.value()))
-                return;
-        }
-    }
+    /* Validate the node hierarchy and discover custom scene fields, unless
+       it's deferred to the first scene-related call */
+    if(!configuration().value<bool>("lazyNodeProcessing") && !processNodes(*gltf, "Trade::GltfImporter::openData():"))
+        return;
 
     /* Treat meshes with multiple primitives as separate meshes. Each mesh gets
        duplicated as many times as is the size of the primitives array.
@@ -1518,6 +1858,7 @@ void GltfImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
 
     /* Allocate storage for parsed buffers, buffer views and accessors */
     _d->buffers = Containers::Array<Containers::Optional<Containers::Array<char>>>{_d->gltfBuffers.size()};
+    _d->meshoptFallbackBuffers = Containers::Array<bool>{ValueInit, _d->gltfBuffers.size()};
     _d->bufferViews = Containers::Array<Containers::Optional<Containers::Triple<Containers::ArrayView<const char>, UnsignedInt, UnsignedInt>>>{_d->gltfBufferViews.size()};
     _d->accessors = Containers::Array<Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>>>{_d->gltfAccessors.size()};
     _d->samplers = Containers::Array<Containers::Optional<Document::Sampler>>{_d->gltfSamplers.size()};
@@ -2317,6 +2658,15 @@ void parseSceneExtraFields(Utility::Json& gltf, const ImporterFlags flags, const
               gltfExtraValue.type() == Utility::JsonToken::Type::Number ||
               gltfExtraValue.type() == Utility::JsonToken::Type::String) {
         const UnsignedInt customFieldId = sceneFieldCustom(sceneFieldsForName.at(key));
+        /* Fields reserved for EXT_mesh_gpu_instancing are multi-entry as
+           well, but an array wouldn't be accepted for them either, so report
+           the name conflict instead */
+        if(sceneFieldNamesTypesFlags[customFieldId].second() == SceneFieldType::Vector3 ||
+           sceneFieldNamesTypesFlags[customFieldId].second() == SceneFieldType::Quaternion) {
+            if(!(flags & ImporterFlag::Quiet))
+                Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property conflicts with an EXT_mesh_gpu_instancing field, skipping";
+            return;
+        }
         if(sceneFieldNamesTypesFlags[customFieldId].third() & SceneFieldFlag::MultiEntry) {
             if(!(flags & ImporterFlag::Quiet))
                 Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property was expected to be an array, skipping";
@@ -2391,6 +2741,14 @@ void parseSceneExtraFields(Utility::Json& gltf, const ImporterFlags flags, const
                 Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property was not expected to be an array, skipping";
             return;
         }
+        /* Fields reserved for EXT_mesh_gpu_instancing are the only multi-entry
+           fields with a type that can't come from extras */
+        if(sceneFieldNamesTypesFlags[customFieldId].second() == SceneFieldType::Vector3 ||
+           sceneFieldNamesTypesFlags[customFieldId].second() == SceneFieldType::Quaternion) {
+            if(!(flags & ImporterFlag::Quiet))
+                Warning{} << "Trade::GltfImporter::scene(): node" << nodeI << "extras" << key << "property conflicts with an EXT_mesh_gpu_instancing field, skipping";
+            return;
+        }
 
         bool success = false;
 
@@ -2548,6 +2906,9 @@ void collectSceneExtraFields(const std::unordered_map<Containers::String, SceneF
 }
 
 Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
+    if(!_d->nodesProcessed && !processNodes(*_d->gltf, "Trade::GltfImporter::scene():"))
+        return {};
+
     const Utility::JsonToken& gltfScene = _d->gltfScenes[id].first();
 
     /* Gather all top-level nodes belonging to a scene and recursively populate
@@ -2560,7 +2921,7 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
     Containers::Array<UnsignedInt> objects;
     arrayReserve(objects, _d->gltfNodes.size());
     if(const Utility::JsonToken* const gltfSceneNodes = gltfScene.find("nodes"_s)) {
-        /* Scene node array parsed in doOpenData() already, for cycle
+        /* Scene node array parsed in processNodes() already, for cycle
            detection. Bounds checked there as well, so we can just directly
            copy the contents. */
         const Containers::StridedArrayView1D<const UnsignedInt> sceneNodes = gltfSceneNodes->asUnsignedIntArray();
@@ -2578,7 +2939,7 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         for(std::size_t j = children[i], jMax = children[i + 1]; j != jMax; ++j) {
             const Utility::JsonToken& gltfNode = _d->gltfNodes[objects[j]].first();
             if(const Utility::JsonToken* const gltfNodeChildren = gltfNode.find("children"_s)) {
-                /* Node children array parsed in doOpenData() already, for
+                /* Node children array parsed in processNodes() already, for
                    cycle detection. Bounds checked there as well, so we can
                    just directly copy the contents. */
                 const Containers::StridedArrayView1D<const UnsignedInt> nodeChildren = gltfNodeChildren->asUnsignedIntArray();
@@ -2606,6 +2967,13 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
     UnsignedInt lightCount = 0;
     UnsignedInt cameraCount = 0;
     UnsignedInt skinCount = 0;
+    /* Instance transformations from EXT_mesh_gpu_instancing. Similarly to TRS,
+       if a node has just some of the attributes, the others are filled with
+       defaults. */
+    UnsignedInt instanceCount = 0;
+    bool hasInstanceTranslations = false;
+    bool hasInstanceRotations = false;
+    bool hasInstanceScalings = false;
     /* Separate counter for every recognized extra field. Mappings are put into
        `extraMappingOffsets`, number and string fields are put into
        `extraDataOffsets`, bit fields into `extraBitOffsets` and string data
@@ -2734,6 +3102,70 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
 
                 ++lightCount;
             }
+
+            /* Instance transformations. The accessors are parsed and checked
+               here already so the second pass can just copy the data. */
+            if(const Utility::JsonToken* const gltfMeshGpuInstancing = gltfExtensions->find("EXT_mesh_gpu_instancing"_s)) {
+                if(!_d->gltf->parseObject(*gltfMeshGpuInstancing)) {
+                    Error{} << "Trade::GltfImporter::scene(): invalid node" << i << "EXT_mesh_gpu_instancing extension";
+                    return {};
+                }
+
+                const Utility::JsonToken* gltfAttributes = gltfMeshGpuInstancing->find("attributes"_s);
+                if(!gltfAttributes || !_d->gltf->parseObject(*gltfAttributes)) {
+                    Error{} << "Trade::GltfImporter::scene(): missing or invalid EXT_mesh_gpu_instancing attributes property of node" << i;
+                    return {};
+                }
+
+                Containers::Optional<std::size_t> count;
+                for(const Utility::JsonObjectItem gltfAttribute: gltfAttributes->asObject()) {
+                    const Containers::StringView attributeName = gltfAttribute.key();
+                    if(attributeName != "TRANSLATION"_s &&
+                       attributeName != "ROTATION"_s &&
+                       attributeName != "SCALE"_s) {
+                        if(!(flags() & ImporterFlag::Quiet))
+                            Warning{} << "Trade::GltfImporter::scene(): ignoring unsupported EXT_mesh_gpu_instancing attribute" << attributeName << "in node" << i;
+                        continue;
+                    }
+
+                    if(!_d->gltf->parseUnsignedInt(gltfAttribute.value())) {
+                        Error{} << "Trade::GltfImporter::scene(): invalid EXT_mesh_gpu_instancing" << attributeName << "attribute of node" << i;
+                        return {};
+                    }
+
+                    const Containers::Optional<Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>> accessor = parseAccessor("Trade::GltfImporter::scene():", gltfAttribute.value().asUnsignedInt());
+                    if(!accessor)
+                        return {};
+
+                    if(attributeName == "ROTATION"_s ?
+                        accessor->second() != VertexFormat::Vector4 &&
+                        accessor->second() != VertexFormat::Vector4bNormalized &&
+                        accessor->second() != VertexFormat::Vector4sNormalized :
+                        accessor->second() != VertexFormat::Vector3)
+                    {
+                        /* Since we're abusing VertexFormat for all formats,
+                           print just the enum value without the prefix to
+                           avoid cofusion */
+                        Error{} << "Trade::GltfImporter::scene(): unsupported EXT_mesh_gpu_instancing" << attributeName << "format" << Debug::packed << accessor->second() << "in node" << i;
+                        return {};
+                    }
+
+                    if(count && accessor->first().size()[0] != *count) {
+                        Error{} << "Trade::GltfImporter::scene(): mismatched EXT_mesh_gpu_instancing" << attributeName << "attribute count in node" << i << Debug::nospace << ", expected" << *count << "but got" << accessor->first().size()[0];
+                        return {};
+                    }
+                    count = accessor->first().size()[0];
+
+                    if(attributeName == "TRANSLATION"_s)
+                        hasInstanceTranslations = true;
+                    else if(attributeName == "ROTATION"_s)
+                        hasInstanceRotations = true;
+                    else
+                        hasInstanceScalings = true;
+                }
+
+                if(count) instanceCount += *count;
+            }
         }
 
         /* Extras. If it's an object, it was already parsed during initial
@@ -2809,6 +3241,10 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
     Containers::ArrayView<UnsignedInt> cameras;
     Containers::ArrayView<UnsignedInt> skinObjects;
     Containers::ArrayView<UnsignedInt> skins;
+    Containers::ArrayView<UnsignedInt> instanceObjects;
+    Containers::ArrayView<Vector3> instanceTranslations;
+    Containers::ArrayView<Quaternion> instanceRotations;
+    Containers::ArrayView<Vector3> instanceScalings;
     Containers::ArrayView<UnsignedInt> extraMappings;
     Containers::MutableStringView extrasStrings;
     /* This gets later cast to extrasFloat and extrasInt */
@@ -2837,6 +3273,10 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         {NoInit, cameraCount, cameras},
         {NoInit, skinCount, skinObjects},
         {NoInit, skinCount, skins},
+        {NoInit, instanceCount, instanceObjects},
+        {NoInit, hasInstanceTranslations ? instanceCount : 0, instanceTranslations},
+        {NoInit, hasInstanceRotations ? instanceCount : 0, instanceRotations},
+        {NoInit, hasInstanceScalings ? instanceCount : 0, instanceScalings},
         {NoInit, extraMappingCount, extraMappings},
         {NoInit, extraStringSize, extrasStrings},
         {NoInit, extraDataCount, extrasUnsignedInt},
@@ -2861,6 +3301,7 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
     std::size_t lightOffset = 0;
     std::size_t cameraOffset = 0;
     std::size_t skinOffset = 0;
+    std::size_t instanceOffset = 0;
     for(std::size_t i = 0; i != objects.size(); ++i) {
         const UnsignedInt nodeI = objects[i];
         const Utility::JsonToken& gltfNode = _d->gltfNodes[nodeI].first();
@@ -2994,6 +3435,67 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
                 lights[lightOffset] = (*gltfKhrLightsPunctual)["light"_s].asUnsignedInt();
                 ++lightOffset;
             }
+
+            /* Populate instance transformations. Parsing, format and count
+               checks done in the previous pass already, so the accessors can
+               be taken directly from the cache. */
+            if(const Utility::JsonToken* const gltfMeshGpuInstancing = gltfExtensions->find("EXT_mesh_gpu_instancing"_s)) {
+                std::size_t count = 0;
+                bool hasTranslation = false;
+                bool hasRotation = false;
+                bool hasScaling = false;
+                for(const Utility::JsonObjectItem gltfAttribute: (*gltfMeshGpuInstancing)["attributes"_s].asObject()) {
+                    const Containers::StringView attributeName = gltfAttribute.key();
+                    if(attributeName != "TRANSLATION"_s &&
+                       attributeName != "ROTATION"_s &&
+                       attributeName != "SCALE"_s)
+                        continue;
+
+                    const Containers::Triple<Containers::StridedArrayView2D<const char>, VertexFormat, UnsignedInt>& accessor = *_d->accessors[gltfAttribute.value().asUnsignedInt()];
+                    count = accessor.first().size()[0];
+                    if(attributeName == "TRANSLATION"_s) {
+                        Utility::copy(Containers::arrayCast<1, const Vector3>(accessor.first()), instanceTranslations.sliceSize(instanceOffset, count));
+                        hasTranslation = true;
+                    } else if(attributeName == "ROTATION"_s) {
+                        const Containers::ArrayView<Quaternion> dst = instanceRotations.sliceSize(instanceOffset, count);
+                        /* glTF also uses the XYZW order */
+                        if(accessor.second() == VertexFormat::Vector4)
+                            Utility::copy(Containers::arrayCast<1, const Quaternion>(accessor.first()), dst);
+                        else if(accessor.second() == VertexFormat::Vector4bNormalized) {
+                            const Containers::StridedArrayView1D<const Vector4b> src = Containers::arrayCast<1, const Vector4b>(accessor.first());
+                            for(std::size_t j = 0; j != count; ++j) {
+                                const Vector4 unpacked = Math::unpack<Vector4>(src[j]);
+                                dst[j] = Quaternion{unpacked.xyz(), unpacked.w()};
+                            }
+                        } else if(accessor.second() == VertexFormat::Vector4sNormalized) {
+                            const Containers::StridedArrayView1D<const Vector4s> src = Containers::arrayCast<1, const Vector4s>(accessor.first());
+                            for(std::size_t j = 0; j != count; ++j) {
+                                const Vector4 unpacked = Math::unpack<Vector4>(src[j]);
+                                dst[j] = Quaternion{unpacked.xyz(), unpacked.w()};
+                            }
+                        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                        hasRotation = true;
+                    } else {
+                        Utility::copy(Containers::arrayCast<1, const Vector3>(accessor.first()), instanceScalings.sliceSize(instanceOffset, count));
+                        hasScaling = true;
+                    }
+                }
+
+                /* Fill the attributes the node doesn't have but other nodes
+                   do with defaults, and the object mapping */
+                if(hasInstanceTranslations && !hasTranslation)
+                    for(Vector3& j: instanceTranslations.sliceSize(instanceOffset, count))
+                        j = Vector3{};
+                if(hasInstanceRotations && !hasRotation)
+                    for(Quaternion& j: instanceRotations.sliceSize(instanceOffset, count))
+                        j = Quaternion{};
+                if(hasInstanceScalings && !hasScaling)
+                    for(Vector3& j: instanceScalings.sliceSize(instanceOffset, count))
+                        j = Vector3{1.0f};
+                for(UnsignedInt& j: instanceObjects.sliceSize(instanceOffset, count))
+                    j = nodeI;
+                instanceOffset += count;
+            }
         }
 
         /* Extras. Types were checked in the previous pass already, so just
@@ -3013,7 +3515,8 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         meshMaterialOffset == meshMaterialObjects.size() &&
         lightOffset == lightObjects.size() &&
         cameraOffset == cameraObjects.size() &&
-        skinOffset == skinObjects.size());
+        skinOffset == skinObjects.size() &&
+        instanceOffset == instanceObjects.size());
 
     /* Put everything together. For simplicity the imported data could always
        have all fields present, with some being empty, but this gives less
@@ -3063,6 +3566,20 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
         SceneField::Skin, skinObjects, skins
     });
 
+    /* Instance transformations, in custom fields registered in processNodes().
+       Those are never populated from extras, so there's no conflict with the
+       loop below. */
+    CORRADE_INTERNAL_ASSERT(!(hasInstanceTranslations || hasInstanceRotations || hasInstanceScalings) || _d->instanceSceneFieldOffset);
+    if(hasInstanceTranslations) arrayAppend(fields, SceneFieldData{
+        sceneFieldCustom(*_d->instanceSceneFieldOffset + 0), instanceObjects, instanceTranslations, SceneFieldFlag::MultiEntry
+    });
+    if(hasInstanceRotations) arrayAppend(fields, SceneFieldData{
+        sceneFieldCustom(*_d->instanceSceneFieldOffset + 1), instanceObjects, instanceRotations, SceneFieldFlag::MultiEntry
+    });
+    if(hasInstanceScalings) arrayAppend(fields, SceneFieldData{
+        sceneFieldCustom(*_d->instanceSceneFieldOffset + 2), instanceObjects, instanceScalings, SceneFieldFlag::MultiEntry
+    });
+
     /* Extras. At this point, `extraOffsets[i]` to `extraOffsets[i + 1]` is the
        range of data for extra field sceneFieldCustom(i). Add it if it's
        non-empty. */
@@ -3105,10 +3622,16 @@ Containers::Optional<SceneData> GltfImporter::doScene(UnsignedInt id) {
 }
 
 SceneField GltfImporter::doSceneFieldForName(const Containers::StringView name) {
+    if(_d && _d->gltf && !_d->nodesProcessed && !processNodes(*_d->gltf, "Trade::GltfImporter::sceneFieldForName():"))
+        return {};
+
     return _d ? _d->sceneFieldsForName[name] : SceneField{};
 }
 
 Containers::String GltfImporter::doSceneFieldName(const SceneField name) {
+    if(_d && _d->gltf && !_d->nodesProcessed && !processNodes(*_d->gltf, "Trade::GltfImporter::sceneFieldName():"))
+        return {};
+
     return _d && sceneFieldCustom(name) < _d->sceneFieldNamesTypesFlags.size() ?
         _d->sceneFieldNamesTypesFlags[sceneFieldCustom(name)].first() : ""_s;
 }
@@ -3623,57 +4146,77 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
         return {};
     }
 
-    /* Allocate & copy vertex data, if any */
-    Containers::ArrayView<const char> inputVertexData{reinterpret_cast<const char*>(bufferRange.min()), bufferRange.size()};
-    Containers::Array<char> vertexData{NoInit, bufferRange.size()};
-    Utility::copy(inputVertexData, vertexData);
+    /* With zero-copy import enabled the vertex data are referenced directly
+       from the importer-owned buffer, unless they need to be modified. That's
+       currently only if texture coordinates get Y-flipped, the formats not
+       handled in the loop below are always flipped in the material instead. */
+    const bool zeroCopy = configuration().value<bool>("zeroCopy");
+    bool vertexDataZeroCopy = zeroCopy;
+    if(vertexDataZeroCopy && !_d->textureCoordinateYFlipInMaterial) for(const MeshAttributeData& attribute: attributeData) {
+        if(attribute.name() == MeshAttribute::TextureCoordinates &&
+          (attribute.format() == VertexFormat::Vector2 ||
+           attribute.format() == VertexFormat::Vector2ubNormalized ||
+           attribute.format() == VertexFormat::Vector2usNormalized)) {
+            vertexDataZeroCopy = false;
+            break;
+        }
+    }
 
-    /* Convert the attributes from relative to absolute, copy them to a
-       non-growable array and do additional patching */
-    for(std::size_t i = 0; i != attributeData.size(); ++i) {
-        /* glTF only requires buffer views to be large enough to fit the actual
-           data, not to have the size large enough to fit `count*stride`
-           elements. The StridedArrayView expects the latter, so we fake the
-           vertexData size to satisfy the assert. For simplicity we overextend
-           by the whole stride instead of `offset + typeSize`, relying on
-           parseAccessor() having checked the bounds already (and there is a
-           similar workaround when populating the output view). */
-        /** @todo instead of faking the size, split the offset into offset in
-            whole strides and the remainder (Math::div), then form the view
-            with offset in whole strides and then "shift" the view by the
-            remainder (once there's StridedArrayView::shift() or some such) */
-        Containers::StridedArrayView1D<char> data{{vertexData, vertexData.size() + attributeData[i].stride()},
-            vertexData + attributeData[i].offset(inputVertexData),
-            vertexCount, attributeData[i].stride()};
-
-        attributeData[i] = MeshAttributeData{attributeData[i].name(),
-            attributeData[i].format(), data, attributeData[i].arraySize(), attributeData[i].morphTargetId()};
-
-        /* Flip Y axis of texture coordinates, unless it's done in the material
-           instead */
-        if(attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial) {
-           if(attributeData[i].format() == VertexFormat::Vector2)
-                for(auto& c: Containers::arrayCast<Vector2>(data))
-                    c.y() = 1.0f - c.y();
-            else if(attributeData[i].format() == VertexFormat::Vector2ubNormalized)
-                for(auto& c: Containers::arrayCast<Vector2ub>(data))
-                    c.y() = 255 - c.y();
-            else if(attributeData[i].format() == VertexFormat::Vector2usNormalized)
-                for(auto& c: Containers::arrayCast<Vector2us>(data))
-                    c.y() = 65535 - c.y();
-            /* For these it's always done in the material texture transform as
-               we can't do a 1 - y flip like above. These are allowed only by
-               the KHR_mesh_quantization formats and in that case the texture
-               transform should be always present. */
-            /* LCOV_EXCL_START */
-            else if(attributeData[i].format() != VertexFormat::Vector2bNormalized &&
-                    attributeData[i].format() != VertexFormat::Vector2sNormalized &&
-                    attributeData[i].format() != VertexFormat::Vector2ub &&
-                    attributeData[i].format() != VertexFormat::Vector2b &&
-                    attributeData[i].format() != VertexFormat::Vector2us &&
-                    attributeData[i].format() != VertexFormat::Vector2s)
-                CORRADE_INTERNAL_ASSERT_UNREACHABLE();
-            /* LCOV_EXCL_STOP */
+    /* Allocate & copy vertex data, if any. In the zero-copy case the
+       attributes already point to the input data. */
+    Containers::ArrayView<const char> inputVertexData{reinterpret_cast<const char*>(bufferRange.min()), bufferRange.size()};
+    Containers::Array<char> vertexData;
+    if(!vertexDataZeroCopy) {
+        vertexData = Containers::Array<char>{NoInit, bufferRange.size()};
+        Utility::copy(inputVertexData, vertexData);
+
+        /* Convert the attributes from relative to absolute, copy them to a
+           non-growable array and do additional patching */
+        for(std::size_t i = 0; i != attributeData.size(); ++i) {
+            /* glTF only requires buffer views to be large enough to fit the actual
+               data, not to have the size large enough to fit `count*stride`
+               elements. The StridedArrayView expects the latter, so we fake the
+               vertexData size to satisfy the assert. For simplicity we overextend
+               by the whole stride instead of `offset + typeSize`, relying on
+               parseAccessor() having checked the bounds already (and there is a
+               similar workaround when populating the output view). */
+            /** @todo instead of faking the size, split the offset into offset in
+                whole strides and the remainder (Math::div), then form the view
+                with offset in whole strides and then "shift" the view by the
+                remainder (once there's StridedArrayView::shift() or some such) */
+            Containers::StridedArrayView1D<char> data{{vertexData, vertexData.size() + attributeData[i].stride()},
+                vertexData + attributeData[i].offset(inputVertexData),
+                vertexCount, attributeData[i].stride()};
+
+            attributeData[i] = MeshAttributeData{attributeData[i].name(),
+                attributeData[i].format(), data, attributeData[i].arraySize(), attributeData[i].morphTargetId()};
+
+            /* Flip Y axis of texture coordinates, unless it's done in the material
+               instead */
+            if(attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial) {
+               if(attributeData[i].format() == VertexFormat::Vector2)
+                    for(auto& c: Containers::arrayCast<Vector2>(data))
+                        c.y() = 1.0f - c.y();
+                else if(attributeData[i].format() == VertexFormat::Vector2ubNormalized)
+                    for(auto& c: Containers::arrayCast<Vector2ub>(data))
+                        c.y() = 255 - c.y();
+                else if(attributeData[i].format() == VertexFormat::Vector2usNormalized)
+                    for(auto& c: Containers::arrayCast<Vector2us>(data))
+                        c.y() = 65535 - c.y();
+                /* For these it's always done in the material texture transform as
+                   we can't do a 1 - y flip like above. These are allowed only by
+                   the KHR_mesh_quantization formats and in that case the texture
+                   transform should be always present. */
+                /* LCOV_EXCL_START */
+                else if(attributeData[i].format() != VertexFormat::Vector2bNormalized &&
+                        attributeData[i].format() != VertexFormat::Vector2sNormalized &&
+                        attributeData[i].format() != VertexFormat::Vector2ub &&
+                        attributeData[i].format() != VertexFormat::Vector2b &&
+                        attributeData[i].format() != VertexFormat::Vector2us &&
+                        attributeData[i].format() != VertexFormat::Vector2s)
+                    CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+                /* LCOV_EXCL_STOP */
+            }
         }
     }
 
@@ -3710,10 +4253,16 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
             return {};
         }
 
+        /* Index data are never modified, so in the zero-copy case they can
+           be always referenced directly */
         Containers::ArrayView<const char> srcContiguous = accessor->first().asContiguous();
-        indexData = Containers::Array<char>{NoInit, srcContiguous.size()};
-        Utility::copy(srcContiguous, indexData);
-        indices = MeshIndexData{type, indexData};
+        if(zeroCopy) {
+            indices = MeshIndexData{type, srcContiguous};
+        } else {
+            indexData = Containers::Array<char>{NoInit, srcContiguous.size()};
+            Utility::copy(srcContiguous, indexData);
+            indices = MeshIndexData{type, indexData};
+        }
     }
 
     /* If we have an index-less attribute-less mesh, glTF has no way to supply
@@ -3721,6 +4270,19 @@ Containers::Optional<MeshData> GltfImporter::doMesh(const UnsignedInt id, Unsign
     if(!indices.data().size() && !attributeData.size())
         return MeshData{primitive, 0};
 
+    /* Referenced data are valid only as long as the importer stays open, so
+       no data flags are set for them */
+    if(zeroCopy) {
+        if(vertexDataZeroCopy) return MeshData{primitive,
+            DataFlags{}, indices.data(), indices,
+            DataFlags{}, inputVertexData, Utility::move(attributeData),
+            vertexCount, &gltfPrimitive};
+        return MeshData{primitive,
+            DataFlags{}, indices.data(), indices,
+            Utility::move(vertexData), Utility::move(attributeData),
+            vertexCount, &gltfPrimitive};
+    }
+
     return MeshData{primitive,
         Utility::move(indexData), indices,
         Utility::move(vertexData), Utility::move(attributeData),
@@ -5048,6 +5610,72 @@ AbstractImporter* GltfImporter::setupOrReuseImporterForImage(const char* const e
     return &_d->imageImporter.emplace(Utility::move(importer));
 }
 
+void GltfImporter::decodeImages2D() {
+    _d->images2DDecoded = true;
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) {
+        threadCount = std::thread::hardware_concurrency();
+        if(flags() & ImporterFlag::Verbose)
+            Debug{} << "Trade::GltfImporter::image2D(): autodetected hardware concurrency to" << threadCount << "threads";
+    }
+
+    /* Opening may load plugins through the manager, which isn't thread-safe,
+       so open everything serially first. Errors are silenced here, images
+       that fail to open go through the serial path again once requested,
+       which prints the message. */
+    Containers::Array<Containers::Optional<AnyImageImporter>> importers{_d->image2DCount};
+    {
+        Error redirectError{nullptr};
+        for(std::size_t i = 0; i != _d->image2DCount; ++i) {
+            if(!setupOrReuseImporterForImage("Trade::GltfImporter::image2D():", _d->imagesByDimension[i], 2))
+                continue;
+            importers[i] = Utility::move(_d->imageImporter);
+            _d->imageImporter = Containers::NullOpt;
+        }
+        _d->imageImporterId = ~UnsignedInt{};
+    }
+
+    /* Then decode the base levels, each thread picking the next image from
+       the queue as images can differ in size a lot. Nothing can be printed
+       directly from the worker threads as the output redirection is
+       thread-local and the user-installed redirection wouldn't be respected.
+       Debug and warning output is thus captured for each image and printed
+       when the image is handed out. Errors are silenced, failed images are
+       again imported serially later, which prints all messages again. */
+    _d->decodedImages2D = Containers::Array<Document::DecodedImage2D>{_d->image2DCount};
+    std::atomic<std::size_t> nextImage{0};
+    auto decode = [&]() {
+        Error redirectError{nullptr};
+        for(std::size_t i; (i = nextImage++) < importers.size(); ) {
+            if(!importers[i]) continue;
+
+            std::ostringstream debugOut, warningOut;
+            Containers::Optional<ImageData2D> image;
+            {
+                Debug redirectOutput{&debugOut};
+                Warning redirectWarning{&warningOut};
+                image = importers[i]->image2D(0);
+            }
+            if(!image) continue;
+
+            Document::DecodedImage2D& decoded = _d->decodedImages2D[i];
+            decoded.image = Utility::move(image);
+            decoded.debug = debugOut.str();
+            decoded.warning = warningOut.str();
+        }
+    };
+
+    /* The calling thread does its share of work as well. There's no point in
+       having more threads than images. */
+    Containers::Array<std::thread> threads{Math::max(Math::min(std::size_t(threadCount), _d->image2DCount), std::size_t{1}) - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{decode};
+    decode();
+    for(std::thread& thread: threads)
+        thread.join();
+}
+
 UnsignedInt GltfImporter::doImage2DCount() const {
     return _d->image2DCount;
 }
@@ -5083,6 +5711,26 @@ UnsignedInt GltfImporter::doImage2DLevelCount(const UnsignedInt id) {
 Containers::Optional<ImageData2D> GltfImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
     CORRADE_ASSERT(manager(), "Trade::GltfImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
+    /* Decode all images in parallel on the first call if requested and hand
+       out the result, if there's any */
+    if(level == 0 && configuration().value<UnsignedInt>("threads") != 1) {
+        if(!_d->images2DDecoded) decodeImages2D();
+        Document::DecodedImage2D& decoded = _d->decodedImages2D[id];
+        if(decoded.image) {
+            /* The relative order of debug and warning messages isn't
+               preserved, but that's the case for the separate output streams
+               in general as well */
+            if(decoded.debug)
+                Debug{Debug::Flag::NoNewlineAtTheEnd} << decoded.debug;
+            if(decoded.warning)
+                Warning{Debug::Flag::NoNewlineAtTheEnd} << decoded.warning;
+
+            Containers::Optional<ImageData2D> imageData = Utility::move(decoded.image);
+            decoded = Document::DecodedImage2D{};
+            return ImageData2D{Utility::move(*imageData), &*_d->gltfImages[id].first()};
+        }
+    }
+
     AbstractImporter* importer = setupOrReuseImporterForImage("Trade::GltfImporter::image2D():", _d->imagesByDimension[id], 2);
     if(!importer) return {};
 
@@ -72,7 +72,11 @@ Imports glTF (`*.gltf`) and binary glTF (`*.glb`) files. You can use
 This plugin depends on the @ref Trade library and the @ref AnyImageImporter
 plugin and is built if `MAGNUM_WITH_GLTFIMPORTER` is enabled when building
 Magnum Plugins. To use as a dynamic plugin, load @cpp "GltfImporter" @ce via
-@ref Corrade::PluginManager::Manager.
+@ref Corrade::PluginManager::Manager. Support for the
+[EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md)
+extension is enabled if [meshoptimizer](https://github.com/zeux/meshoptimizer)
+is found when building the plugin, see
+@ref Trade-GltfImporter-behavior-meshes for details.
 
 Additionally, if you're using Magnum as a CMake subproject, bundle the
 [magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do the
@@ -117,6 +121,19 @@ the importer instance. In case of images, the files are loaded on-demand inside
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
+If no file callback is set, files opened with @ref openFile() as well as
+external buffers are memory-mapped on platforms that support it. Opening a
+file then reads only its JSON part. Contents of the GLB binary chunk and of
+external buffers get paged in only once a mesh, animation or another piece
+of data actually references them. The mappings are kept until the importer
+is closed.
+
+Buffer views and accessors are parsed and validated only once, the first time
+a mesh, animation or skin references them, and the result is reused by all
+later imports until the importer is closed. With @ref ImporterFlag::Verbose
+enabled, @ref close() prints how many accessor lookups were served from this
+cache and how many had to parse the accessor.
+
 The content of the global [extensionsRequired](https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#specifying-extensions)
 array is checked against all extensions supported by the plugin. If a glTF file
 requires an unknown extension, the import will fail. This behaviour can be
@@ -171,6 +188,19 @@ importer plugins the importer delegates to.
     @ref SceneFieldType::UnsignedInt) is present. A single node can only
     reference one light at most. See
     @ref Trade-GltfImporter-behavior-lights for further details.
+-   Per-instance transformations from the
+    [EXT_mesh_gpu_instancing](https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_mesh_gpu_instancing)
+    extension are imported as custom `instanceTranslation` (of type
+    @ref SceneFieldType::Vector3), `instanceRotation` (of type
+    @ref SceneFieldType::Quaternion) and `instanceScaling` (of type
+    @ref SceneFieldType::Vector3) fields, marked with
+    @ref SceneFieldFlag::MultiEntry and having one entry per instance for the
+    node containing the extension. Instance rotations in normalized 8- and
+    16-bit formats are unpacked to floats. If a node has only some of the
+    attributes while other nodes in the scene have them, the missing ones are
+    filled with an identity transformation. Other attributes are ignored with
+    a warning. The fields are registered only if the file uses the extension,
+    node `extras` with the same names are then ignored with a warning.
 -   If node rotation quaternion is not normalized, the importer prints a
     warning and normalizes it. Can be disabled per-object with the
     @cb{.ini} normalizeQuaternions @ce
@@ -195,6 +225,14 @@ importer plugins the importer delegates to.
     have multiple entries for a single object. Node `extras` that were parsed
     from an array are also marked with @ref SceneFieldFlag::MultiEntry in order
     to unambiguously distinguish them from non-array values.
+-   The node hierarchy is validated and custom scene fields discovered during
+    file opening. For files with a lot of nodes where the scenes aren't
+    needed, this can be deferred by enabling the
+    @cb{.ini} lazyNodeProcessing @ce
+    @ref Trade-GltfImporter-configuration "configuration option". Then it's
+    done on the first @ref scene(), @ref sceneFieldName() or
+    @ref sceneFieldForName() call, which fail if the hierarchy is invalid
+    instead of file opening failing.
 
 @subsection Trade-GltfImporter-behavior-animations Animation and skin import
 
@@ -317,6 +355,14 @@ importer plugins the importer delegates to.
 -   Morph targets, if present, have their attributes imported with
     @ref Trade::MeshData::attributeMorphTargetId() set to index of the morph
     target. Non-sparse buffers aren't supported for those at the moment.
+-   If the plugin is built with [meshoptimizer](https://github.com/zeux/meshoptimizer),
+    buffer views compressed with the [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md)
+    extension are decoded on-demand the first time a mesh references them,
+    including the `OCTAHEDRAL`, `QUATERNION` and `EXPONENTIAL` filters.
+    Decoded data are kept in memory for any later access. Fallback buffers
+    aren't loaded at all, compressed data is always used instead. If the
+    plugin is built without meshoptimizer, files that list the extension as
+    required fail to open and in other cases the uncompressed fallback is used.
 
 By default, the mesh import silently allows certain features that aren't
 strictly valid according to the glTF specification, such as 32-bit integer
@@ -330,6 +376,22 @@ imported meshes as well. Their mapping to/from a string can be queried using
 unsupported types (such as non-normalized integer matrices) cause the import to
 fail.
 
+@subsubsection Trade-GltfImporter-behavior-meshes-zero-copy Zero-copy mesh import
+
+By default, index and vertex data of each imported mesh are copied out of the
+buffer they're in. If the @cb{.ini} zeroCopy @ce
+@ref Trade-GltfImporter-configuration "configuration option" is enabled,
+@ref mesh() instead returns a @ref MeshData that references the
+importer-owned buffer directly, whether it's the GLB binary chunk, an external
+buffer or a decoded data URI. The data are then only valid as long as the
+importer is open, which is signalized by @ref MeshData::indexDataFlags() and
+@relativeref{MeshData,vertexDataFlags()} being empty.
+
+Index data can be always referenced. Vertex data are copied only if they need
+to be modified, which is when texture coordinates get Y-flipped. Enable the
+@cb{.ini} textureCoordinateYFlipInMaterial @ce option as well to avoid that
+copy.
+
 @subsection Trade-GltfImporter-behavior-materials Material import
 
 -   If present, builtin [metallic/roughness](https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#metallic-roughness-material) material is imported,
@@ -461,6 +523,27 @@ multiple extensions, the image referenced by the first recognized extension
 appearing in the file will be picked, others ignored.</li>
 </ul>
 
+@subsubsection Trade-GltfImporter-behavior-textures-parallel Parallel image decoding
+
+By default, each image is opened and decoded on demand in the calling thread
+when @ref image2D() is called, with only the last used image importer kept
+around. If the @cb{.ini} threads @ce
+@ref Trade-GltfImporter-configuration "configuration option" is set to a value
+other than @cb{.ini} 1 @ce, the first @ref image2D() call for a base level
+opens all 2D images in the file and decodes their base levels at once,
+distributing them across given number of threads, and subsequent calls then
+hand out the already decoded images. The plugin recognizes
+@ref ImporterFlag::Verbose, printing the autodetected thread count if the
+option is set to @cb{.ini} 0 @ce.
+
+Images are opened serially as that may involve loading plugins through the
+plugin manager, only the decoding itself is done in parallel. Messages can't
+be printed from worker threads, so errors and warnings from the decoding are
+suppressed. An image that failed to decode, or that was already handed out
+and is requested again, goes through the serial path, printing any errors
+there. Images of other than the base level and 3D images are always imported
+serially.
+
 @subsubsection Trade-GltfImporter-behavior-textures-array 2D array texture support
 
 If the @cb{.ini} experimentalKhrTextureKtx @ce
@@ -593,6 +676,7 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
 
         MAGNUM_GLTFIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
         MAGNUM_GLTFIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
+        MAGNUM_GLTFIMPORTER_LOCAL bool processNodes(Utility::Json& gltf, const char* errorPrefix);
         MAGNUM_GLTFIMPORTER_LOCAL void doClose() override;
 
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doAnimationCount() const override;
@@ -646,6 +730,7 @@ class MAGNUM_GLTFIMPORTER_EXPORT GltfImporter: public AbstractImporter {
         MAGNUM_GLTFIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
         MAGNUM_GLTFIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(const char* errorPrefix, UnsignedInt id, UnsignedInt expectedDimensions);
+        MAGNUM_GLTFIMPORTER_LOCAL void decodeImages2D();
 
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_GLTFIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -27,6 +27,7 @@
 
 #include <sstream>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StaticArray.h>
@@ -45,6 +46,7 @@
 #include <Corrade/Utility/Json.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/Resource.h>
+#include <Corrade/Utility/String.h>
 #include <Magnum/FileCallback.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
@@ -87,6 +89,7 @@ struct GltfImporterTest: TestSuite::Tester {
     void open();
     void openError();
     void openFileError();
+    void openFileNotFound();
     void openIgnoreUnknownChunk();
     void openExternalDataOrder();
     void openExternalDataNoPathNoCallback();
@@ -113,6 +116,7 @@ struct GltfImporterTest: TestSuite::Tester {
     void animationQuaternionNormalizationDisabled();
     void animationMergeEmpty();
     void animationMerge();
+    void animationAccessorCache();
 
     void camera();
     void cameraInvalid();
@@ -122,6 +126,7 @@ struct GltfImporterTest: TestSuite::Tester {
 
     void scene();
     void sceneInvalidWholeFile();
+    void sceneInvalidWholeFileLazyNodeProcessing();
     void sceneInvalid();
     void sceneDefaultNoDefault();
     void sceneDefaultOutOfRange();
@@ -130,12 +135,16 @@ struct GltfImporterTest: TestSuite::Tester {
     void sceneTransformationQuaternionNormalizationDisabled();
     void sceneCustomFields();
     void sceneCustomFieldsInvalidConfiguration();
+    void sceneCustomFieldsInvalidConfigurationLazy();
+    void sceneLazyNodeProcessing();
+    void sceneMeshGpuInstancing();
 
     void skin();
     void skinInvalid();
     void skinInvalidBufferNotFound();
 
     void mesh();
+    void meshZeroCopy();
     void meshNoAttributes();
     void meshNoIndices();
     void meshNoIndicesNoAttributes();
@@ -155,6 +164,10 @@ struct GltfImporterTest: TestSuite::Tester {
     void meshInvalidWholeFile();
     void meshInvalid();
     void meshInvalidBufferNotFound();
+    void meshMeshoptCompression();
+    void meshMeshoptCompressionTriangles();
+    void meshMeshoptCompressionFilters();
+    void meshMeshoptCompressionInvalid();
 
     void materialPbrMetallicRoughness();
     void materialPbrSpecularGlossiness();
@@ -182,9 +195,12 @@ struct GltfImporterTest: TestSuite::Tester {
     void imageEmbedded();
     void imageExternal();
     void imageExternalNoPathNoCallback();
+    void imageParallel();
+    void imageParallelMessages();
     void imageBasis();
     void imageMipLevels();
     void imageInvalid();
+    void imageInvalidParallel();
     void imageInvalidNotFound();
     void imagePropagateImporterFlags();
 
@@ -212,6 +228,8 @@ struct GltfImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
 
+    void benchmarkOpenNodes();
+
     /* Needs to load AnyImageImporter from a system-wide location */
     PluginManager::Manager<AbstractImporter> _manager;
 };
@@ -490,6 +508,24 @@ constexpr struct {
     {"binary embedded", "-embedded.glb"}
 };
 
+constexpr struct {
+    const char* name;
+    const char* suffix;
+    bool flipInMaterial;
+    DataFlags vertexDataFlags;
+} MeshZeroCopyData[]{
+    {"ascii external", ".gltf", false,
+        DataFlag::Owned|DataFlag::Mutable},
+    {"binary embedded", "-embedded.glb", false,
+        DataFlag::Owned|DataFlag::Mutable},
+    {"ascii external, texture coordinate Y flip in material", ".gltf", true,
+        {}},
+    {"ascii embedded, texture coordinate Y flip in material", "-embedded.gltf", true,
+        {}},
+    {"binary embedded, texture coordinate Y flip in material", "-embedded.glb", true,
+        {}},
+};
+
 constexpr struct {
     const char* name;
     const char* message;
@@ -1074,6 +1110,45 @@ constexpr struct {
     {"indices buffer not found", "error opening /nonexistent2.bin"}
 };
 
+constexpr struct {
+    const char* name;
+    const char* message;
+} MeshMeshoptCompressionInvalidData[]{
+    {"Uncompressed view in a fallback buffer",
+        "buffer view 2 references a EXT_meshopt_compression fallback buffer 1 but isn't compressed"},
+    {"Invalid mode",
+        "buffer view 3 has unrecognized EXT_meshopt_compression mode VERTICES"},
+    {"Invalid attribute stride",
+        "buffer view 4 has invalid EXT_meshopt_compression byteStride 6 for ATTRIBUTES, expected a multiple of 4 not larger than 256"},
+    {"Decoded size too large",
+        "buffer view 5 needs 48 bytes for 4 decoded EXT_meshopt_compression elements but has only 36"},
+    {"Compressed data out of bounds",
+        "buffer view 6 needs 793 bytes of EXT_meshopt_compression data but buffer 0 has only 792"},
+    {"Corrupted data",
+        "buffer view 7 EXT_meshopt_compression ATTRIBUTES decoding failed with error -1"},
+    {"Invalid octahedral filter stride",
+        "buffer view 12 has unsupported EXT_meshopt_compression filter OCTAHEDRAL with byteStride 12"},
+    {"Invalid quaternion filter stride",
+        "buffer view 13 has unsupported EXT_meshopt_compression filter QUATERNION with byteStride 4"},
+    {"Invalid filter",
+        "buffer view 14 has unsupported EXT_meshopt_compression filter NONSENSE with byteStride 12"},
+    {"Invalid index stride",
+        "buffer view 15 has invalid EXT_meshopt_compression byteStride 3 for INDICES, expected 2 or 4"},
+    {"Invalid triangle count",
+        "buffer view 16 has invalid EXT_meshopt_compression count 4 for TRIANGLES, expected a multiple of 3"},
+    {"Filter for indices",
+        "buffer view 17 has unsupported EXT_meshopt_compression filter EXPONENTIAL for TRIANGLES"},
+    /* On 64-bit the product doesn't overflow, as the count is limited to 52
+       bits by the JSON parser */
+    {"Decoded size overflow",
+        #ifndef CORRADE_TARGET_32BIT
+        "buffer view 18 needs 17179869180 bytes for 4294967295 decoded EXT_meshopt_compression elements but has only 8"
+        #else
+        "buffer view 18 has too large EXT_meshopt_compression count 4294967295 for byteStride 4"
+        #endif
+        },
+};
+
 constexpr struct {
     const char* name;
     const char* message;
@@ -1469,6 +1544,19 @@ constexpr struct {
     {"embedded binary", "-embedded.glb"},
 };
 
+const struct {
+    const char* name;
+    const char* suffix;
+    UnsignedInt threads;
+    ImporterFlags flags;
+} ImageParallelData[]{
+    {"two threads", ".gltf", 2, {}},
+    {"two threads, embedded", "-embedded.gltf", 2, {}},
+    {"more threads than images", ".gltf", 8, {}},
+    {"autodetected threads", ".gltf", 0, {}},
+    {"autodetected threads, verbose", ".gltf", 0, ImporterFlag::Verbose},
+};
+
 const struct {
     const char* name;
     const char* requiresPlugin;
@@ -1579,6 +1667,19 @@ constexpr struct {
     {"minVersion 2.1", "version-unsupported-min.gltf", "unsupported minVersion 2.1, expected 2.0"}
 };
 
+const struct {
+    const char* name;
+    UnsignedInt nodeCount;
+    bool lazyNodeProcessing;
+} BenchmarkOpenNodesData[]{
+    {"1k nodes", 1000, false},
+    {"1k nodes, lazy node processing", 1000, true},
+    {"10k nodes", 10000, false},
+    {"10k nodes, lazy node processing", 10000, true},
+    {"100k nodes", 100000, false},
+    {"100k nodes, lazy node processing", 100000, true},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -1602,7 +1703,8 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::openError},
                       Containers::arraySize(OpenErrorData));
 
-    addTests({&GltfImporterTest::openFileError});
+    addTests({&GltfImporterTest::openFileError,
+              &GltfImporterTest::openFileNotFound});
 
     addInstancedTests({&GltfImporterTest::openIgnoreUnknownChunk},
         Containers::arraySize(QuietData));
@@ -1652,7 +1754,8 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::animationQuaternionNormalizationDisabled,
               &GltfImporterTest::animationMergeEmpty,
-              &GltfImporterTest::animationMerge});
+              &GltfImporterTest::animationMerge,
+              &GltfImporterTest::animationAccessorCache});
 
     addTests({&GltfImporterTest::camera});
 
@@ -1666,7 +1769,8 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::scene});
 
-    addInstancedTests({&GltfImporterTest::sceneInvalidWholeFile},
+    addInstancedTests({&GltfImporterTest::sceneInvalidWholeFile,
+                       &GltfImporterTest::sceneInvalidWholeFileLazyNodeProcessing},
         Containers::arraySize(SceneInvalidWholeFileData));
 
     addInstancedTests({&GltfImporterTest::sceneInvalid},
@@ -1684,7 +1788,10 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::sceneCustomFields},
         Containers::arraySize(QuietData));
 
-    addTests({&GltfImporterTest::sceneCustomFieldsInvalidConfiguration});
+    addTests({&GltfImporterTest::sceneCustomFieldsInvalidConfiguration,
+              &GltfImporterTest::sceneCustomFieldsInvalidConfigurationLazy,
+              &GltfImporterTest::sceneLazyNodeProcessing,
+              &GltfImporterTest::sceneMeshGpuInstancing});
 
     addInstancedTests({&GltfImporterTest::skin},
         Containers::arraySize(MultiFileData));
@@ -1697,6 +1804,9 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::mesh},
                       Containers::arraySize(MultiFileData));
 
+    addInstancedTests({&GltfImporterTest::meshZeroCopy},
+        Containers::arraySize(MeshZeroCopyData));
+
     addInstancedTests({&GltfImporterTest::meshNoAttributes},
         Containers::arraySize(MeshNoAttributesData));
 
@@ -1746,6 +1856,13 @@ GltfImporterTest::GltfImporterTest() {
     addInstancedTests({&GltfImporterTest::meshInvalidBufferNotFound},
         Containers::arraySize(MeshInvalidBufferNotFoundData));
 
+    addTests({&GltfImporterTest::meshMeshoptCompression,
+              &GltfImporterTest::meshMeshoptCompressionTriangles,
+              &GltfImporterTest::meshMeshoptCompressionFilters});
+
+    addInstancedTests({&GltfImporterTest::meshMeshoptCompressionInvalid},
+        Containers::arraySize(MeshMeshoptCompressionInvalidData));
+
     addTests({&GltfImporterTest::materialPbrMetallicRoughness,
               &GltfImporterTest::materialPbrSpecularGlossiness,
               &GltfImporterTest::materialCommon,
@@ -1791,12 +1908,18 @@ GltfImporterTest::GltfImporterTest() {
 
     addTests({&GltfImporterTest::imageExternalNoPathNoCallback});
 
+    addInstancedTests({&GltfImporterTest::imageParallel},
+        Containers::arraySize(ImageParallelData));
+
+    addTests({&GltfImporterTest::imageParallelMessages});
+
     addInstancedTests({&GltfImporterTest::imageBasis},
                       Containers::arraySize(ImageBasisData));
 
     addTests({&GltfImporterTest::imageMipLevels});
 
-    addInstancedTests({&GltfImporterTest::imageInvalid},
+    addInstancedTests({&GltfImporterTest::imageInvalid,
+                       &GltfImporterTest::imageInvalidParallel},
                       Containers::arraySize(ImageInvalidData));
 
     addInstancedTests({&GltfImporterTest::imageInvalidNotFound},
@@ -1841,6 +1964,9 @@ GltfImporterTest::GltfImporterTest() {
     addTests({&GltfImporterTest::openTwice,
               &GltfImporterTest::importTwice});
 
+    addInstancedBenchmarks({&GltfImporterTest::benchmarkOpenNodes}, 10,
+        Containers::arraySize(BenchmarkOpenNodesData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. It also pulls in the AnyImageImporter dependency. */
     #ifdef GLTFIMPORTER_PLUGIN_FILENAME
@@ -1922,6 +2048,24 @@ void GltfImporterTest::openFileError() {
         "Trade::GltfImporter::openData(): missing or invalid asset property\n", filename));
 }
 
+void GltfImporterTest::openFileNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("nonexistent.glb"));
+    /* There's an error from Path::mapRead() or Path::read() before */
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_COMPARE_AS(out.str(),
+        "\nTrade::GltfImporter::openFile(): cannot open file nonexistent.glb\n",
+        TestSuite::Compare::StringHasSuffix);
+    #else
+    CORRADE_COMPARE_AS(out.str(),
+        "\nTrade::AbstractImporter::openFile(): cannot open file nonexistent.glb\n",
+        TestSuite::Compare::StringHasSuffix);
+    #endif
+}
+
 void GltfImporterTest::openIgnoreUnknownChunk() {
     auto&& data = QuietData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2303,7 +2447,7 @@ void GltfImporterTest::animationInvalidBufferNotFound() {
     std::ostringstream out;
     Error redirectError{&out};
     CORRADE_VERIFY(!importer->animation(data.name));
-    /* There's an error from Path::read() before */
+    /* There's an error from Path::mapRead() before */
     CORRADE_COMPARE_AS(out.str(),
         Utility::format("\nTrade::GltfImporter::animation(): {}\n", data.message),
         TestSuite::Compare::StringHasSuffix);
@@ -2772,6 +2916,25 @@ void GltfImporterTest::animationMerge() {
     CORRADE_VERIFY(!animation->importerState());
 }
 
+void GltfImporterTest::animationAccessorCache() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->setFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "animation.gltf")));
+
+    /* The first import parses five accessors, the input accessor 2 is shared
+       by two samplers and thus parsed just once. The second import takes all
+       of them from the cache. */
+    CORRADE_VERIFY(importer->animation("TRS animation"));
+    CORRADE_VERIFY(importer->animation("TRS animation"));
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        importer->close();
+    }
+    CORRADE_COMPARE(out.str(), "Trade::GltfImporter::close(): accessor cache had 5 hits and 5 misses\n");
+}
+
 void GltfImporterTest::camera() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "camera.gltf")));
@@ -3115,6 +3278,34 @@ void GltfImporterTest::sceneInvalidWholeFile() {
             TestSuite::Compare::String);
 }
 
+void GltfImporterTest::sceneInvalidWholeFileLazyNodeProcessing() {
+    auto&& data = SceneInvalidWholeFileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::String filename = Utility::Path::join(GLTFIMPORTER_TEST_DIR, data.file);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("lazyNodeProcessing", true);
+
+    /* Opening succeeds, the error is printed only once the node hierarchy is
+       needed */
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_COMPARE(importer->sceneFieldForName("radius"), SceneField{});
+    /* The message is the same as when failing on opening, just with a
+       different prefix */
+    if(Containers::StringView{data.message}.hasSuffix('\n')) {
+        const Containers::String message = Utility::String::replaceAll(data.message, "openData():"_s, "sceneFieldForName():"_s);
+        CORRADE_COMPARE_AS(out.str(),
+            Utility::formatString(message.data(), filename),
+            TestSuite::Compare::String);
+    } else CORRADE_COMPARE_AS(out.str(),
+        Utility::formatString("Trade::GltfImporter::sceneFieldForName(): {}\n", data.message),
+        TestSuite::Compare::String);
+}
+
 void GltfImporterTest::sceneInvalid() {
     auto&& data = SceneInvalidData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3844,6 +4035,38 @@ void GltfImporterTest::sceneCustomFields() {
     }
 }
 
+void GltfImporterTest::sceneLazyNodeProcessing() {
+    Containers::String filename = Utility::Path::join(GLTFIMPORTER_TEST_DIR, "scene-custom-fields.gltf");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->addFlags(ImporterFlag::Quiet);
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    Containers::Pointer<AbstractImporter> lazyImporter = _manager.instantiate("GltfImporter");
+    lazyImporter->addFlags(ImporterFlag::Quiet);
+    lazyImporter->configuration().setValue("lazyNodeProcessing", true);
+    CORRADE_VERIFY(lazyImporter->openFile(filename));
+
+    /* Importing a scene first discovers the custom fields on the fly, and the
+       result should be the same as if they were discovered on opening */
+    Containers::Optional<SceneData> scene = importer->scene(0);
+    Containers::Optional<SceneData> lazyScene = lazyImporter->scene(0);
+    CORRADE_VERIFY(scene);
+    CORRADE_VERIFY(lazyScene);
+    CORRADE_COMPARE(lazyScene->fieldCount(), scene->fieldCount());
+    CORRADE_COMPARE(lazyScene->mappingBound(), scene->mappingBound());
+    for(UnsignedInt i = 0; i != scene->fieldCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(lazyScene->fieldName(i), scene->fieldName(i));
+        CORRADE_COMPARE(lazyScene->fieldSize(i), scene->fieldSize(i));
+    }
+
+    SceneField radius = importer->sceneFieldForName("radius");
+    CORRADE_VERIFY(isSceneFieldCustom(radius));
+    CORRADE_COMPARE(lazyImporter->sceneFieldForName("radius"), radius);
+    CORRADE_COMPARE(lazyImporter->sceneFieldName(radius), "radius");
+}
+
 void GltfImporterTest::sceneCustomFieldsInvalidConfiguration() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
 
@@ -3855,6 +4078,89 @@ void GltfImporterTest::sceneCustomFieldsInvalidConfiguration() {
     CORRADE_COMPARE(out.str(), "Trade::GltfImporter::openData(): invalid type Vector2ui specified for custom scene field offset\n");
 }
 
+void GltfImporterTest::sceneCustomFieldsInvalidConfigurationLazy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("lazyNodeProcessing", true);
+
+    importer->configuration().group("customSceneFieldTypes")->addValue("offset", "Vector2ui");
+
+    /* Opening succeeds as the custom fields aren't discovered yet, the error
+       is reported from the first scene-related call instead */
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "scene-custom-fields.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->scene(0));
+    CORRADE_COMPARE(out.str(), "Trade::GltfImporter::scene(): invalid type Vector2ui specified for custom scene field offset\n");
+}
+
+void GltfImporterTest::sceneMeshGpuInstancing() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "scene-mesh-gpu-instancing.gltf")));
+
+    /* The fields are registered first, before the ones coming from extras */
+    SceneField sceneFieldInstanceTranslation = importer->sceneFieldForName("instanceTranslation");
+    SceneField sceneFieldInstanceRotation = importer->sceneFieldForName("instanceRotation");
+    SceneField sceneFieldInstanceScaling = importer->sceneFieldForName("instanceScaling");
+    CORRADE_COMPARE(sceneFieldInstanceTranslation, sceneFieldCustom(0));
+    CORRADE_COMPARE(sceneFieldInstanceRotation, sceneFieldCustom(1));
+    CORRADE_COMPARE(sceneFieldInstanceScaling, sceneFieldCustom(2));
+    CORRADE_COMPARE(importer->sceneFieldName(sceneFieldCustom(0)), "instanceTranslation");
+    CORRADE_COMPARE(importer->sceneFieldName(sceneFieldCustom(1)), "instanceRotation");
+    CORRADE_COMPARE(importer->sceneFieldName(sceneFieldCustom(2)), "instanceScaling");
+
+    Containers::Optional<SceneData> scene;
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        scene = importer->scene(0);
+    }
+    CORRADE_VERIFY(scene);
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfImporter::scene(): ignoring unsupported EXT_mesh_gpu_instancing attribute _ID in node 0\n"
+        "Trade::GltfImporter::scene(): node 1 extras instanceScaling property conflicts with an EXT_mesh_gpu_instancing field, skipping\n"
+        "Trade::GltfImporter::scene(): node 2 extras instanceTranslation property conflicts with an EXT_mesh_gpu_instancing field, skipping\n");
+
+    /* Parent, importer state and the three instance fields. The node extras
+       didn't get added. */
+    CORRADE_COMPARE(scene->fieldCount(), 2 + 3);
+
+    CORRADE_VERIFY(scene->hasField(sceneFieldInstanceTranslation));
+    CORRADE_COMPARE(scene->fieldType(sceneFieldInstanceTranslation), SceneFieldType::Vector3);
+    CORRADE_COMPARE(scene->fieldFlags(sceneFieldInstanceTranslation), SceneFieldFlag::MultiEntry);
+    CORRADE_COMPARE_AS(scene->mapping<UnsignedInt>(sceneFieldInstanceTranslation), Containers::arrayView<UnsignedInt>({
+        0, 0, 1, 1, 1
+    }), TestSuite::Compare::Container);
+    /* The second node has no translation, so it's filled with defaults */
+    CORRADE_COMPARE_AS(scene->field<Vector3>(sceneFieldInstanceTranslation), Containers::arrayView<Vector3>({
+        {1.0f, 2.0f, 3.0f},
+        {4.0f, 5.0f, 6.0f},
+        {}, {}, {}
+    }), TestSuite::Compare::Container);
+
+    /* The rotations are unpacked from normalized shorts */
+    CORRADE_VERIFY(scene->hasField(sceneFieldInstanceRotation));
+    CORRADE_COMPARE(scene->fieldType(sceneFieldInstanceRotation), SceneFieldType::Quaternion);
+    CORRADE_COMPARE(scene->fieldFlags(sceneFieldInstanceRotation), SceneFieldFlag::MultiEntry);
+    CORRADE_COMPARE_AS(scene->field<Quaternion>(sceneFieldInstanceRotation), Containers::arrayView<Quaternion>({
+        {},
+        {{1.0f, 0.0f, 0.0f}, 0.0f},
+        {}, {}, {}
+    }), TestSuite::Compare::Container);
+
+    /* The first node has no scaling, so it's filled with defaults */
+    CORRADE_VERIFY(scene->hasField(sceneFieldInstanceScaling));
+    CORRADE_COMPARE(scene->fieldType(sceneFieldInstanceScaling), SceneFieldType::Vector3);
+    CORRADE_COMPARE(scene->fieldFlags(sceneFieldInstanceScaling), SceneFieldFlag::MultiEntry);
+    CORRADE_COMPARE_AS(scene->field<Vector3>(sceneFieldInstanceScaling), Containers::arrayView<Vector3>({
+        Vector3{1.0f},
+        Vector3{1.0f},
+        Vector3{2.0f},
+        Vector3{3.0f},
+        Vector3{4.0f}
+    }), TestSuite::Compare::Container);
+}
+
 void GltfImporterTest::skin() {
     auto&& data = MultiFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3931,7 +4237,7 @@ void GltfImporterTest::skinInvalidBufferNotFound() {
     std::ostringstream out;
     Error redirectError{&out};
     CORRADE_VERIFY(!importer->skin3D("buffer not found"));
-    /* There's an error from Path::read() before */
+    /* There's an error from Path::mapRead() before */
     CORRADE_COMPARE_AS(out.str(),
         "\nTrade::GltfImporter::skin3D(): error opening /nonexistent.bin\n",
         TestSuite::Compare::StringHasSuffix);
@@ -4067,6 +4373,65 @@ void GltfImporterTest::meshNoAttributes() {
     }
 }
 
+void GltfImporterTest::meshZeroCopy() {
+    auto&& data = MeshZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("textureCoordinateYFlipInMaterial", data.flipInMaterial);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh"_s + data.suffix)));
+
+    /* Import a copy first to compare against */
+    Containers::Optional<Trade::MeshData> expected = importer->mesh(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(expected->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(expected->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    /* The option can be changed between imports */
+    importer->configuration().setValue("zeroCopy", true);
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexDataFlags(), data.vertexDataFlags);
+
+    /* Importing again references the same memory if not copied */
+    {
+        Containers::Optional<Trade::MeshData> mesh2 = importer->mesh(0);
+        CORRADE_VERIFY(mesh2);
+        CORRADE_COMPARE(mesh2->indexData().data(), mesh->indexData().data());
+        if(data.vertexDataFlags == DataFlags{})
+            CORRADE_COMPARE(mesh2->vertexData().data(), mesh->vertexData().data());
+        else
+            CORRADE_VERIFY(mesh2->vertexData().data() != mesh->vertexData().data());
+    }
+
+    /* The contents should be the same as when copying */
+    CORRADE_COMPARE(mesh->primitive(), expected->primitive());
+    CORRADE_COMPARE(mesh->indexType(), expected->indexType());
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        expected->indicesAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->vertexCount(), expected->vertexCount());
+    CORRADE_COMPARE(mesh->attributeCount(), expected->attributeCount());
+    for(UnsignedInt i = 0; i != mesh->attributeCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(mesh->attributeName(i), expected->attributeName(i));
+        CORRADE_COMPARE(mesh->attributeFormat(i), expected->attributeFormat(i));
+    }
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+        expected->positions3DAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->normalsAsArray(),
+        expected->normalsAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->textureCoordinates2DAsArray(),
+        expected->textureCoordinates2DAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->objectIdsAsArray(),
+        expected->objectIdsAsArray(),
+        TestSuite::Compare::Container);
+}
+
 void GltfImporterTest::meshNoIndices() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh.gltf")));
@@ -5166,12 +5531,132 @@ void GltfImporterTest::meshInvalidBufferNotFound() {
     std::ostringstream out;
     Error redirectError{&out};
     CORRADE_VERIFY(!importer->mesh(data.name));
-    /* There's an error from Path::read() before */
+    /* There's an error from Path::mapRead() before */
     CORRADE_COMPARE_AS(out.str(),
         Utility::format("\nTrade::GltfImporter::mesh(): {}\n", data.message),
         TestSuite::Compare::StringHasSuffix);
 }
 
+void GltfImporterTest::meshMeshoptCompression() {
+    #ifndef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin is built without meshoptimizer, can't test EXT_meshopt_compression decoding.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-meshopt.gltf")));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh("Compressed mesh");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({0, 1, 2}),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeCount(), 1);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+
+    /* Importing the mesh again uses the already decoded views */
+    mesh = importer->mesh("Compressed mesh");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attribute<Vector3>(MeshAttribute::Position)[2], (Vector3{-2.0f, 1.0f, 0.3f}));
+    #endif
+}
+
+void GltfImporterTest::meshMeshoptCompressionTriangles() {
+    #ifndef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin is built without meshoptimizer, can't test EXT_meshopt_compression decoding.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-meshopt.gltf")));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh("Compressed triangles");
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({0, 1, 2, 0, 2, 1}),
+        TestSuite::Compare::Container);
+    #endif
+}
+
+void GltfImporterTest::meshMeshoptCompressionFilters() {
+    #ifndef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin is built without meshoptimizer, can't test EXT_meshopt_compression decoding.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-meshopt.gltf")));
+
+    /* The filters are applied in-place on the decoded data. The expected
+       values are calculated from the reference decoder implementation. */
+    {
+        CORRADE_ITERATION("OCTAHEDRAL");
+        const MeshAttribute attribute = importer->meshAttributeForName("_OCTAHEDRAL");
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh("Octahedral filter");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(attribute), VertexFormat::Vector4bNormalized);
+        /* The fourth component is preserved */
+        CORRADE_COMPARE_AS(mesh->attribute<Vector4b>(attribute),
+            Containers::arrayView<Vector4b>({
+                {115, 40, -34, 0},
+                {-115, 40, -34, 5}
+            }), TestSuite::Compare::Container);
+    } {
+        CORRADE_ITERATION("QUATERNION");
+        const MeshAttribute attribute = importer->meshAttributeForName("_QUATERNION");
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh("Quaternion filter");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(attribute), VertexFormat::Vector4sNormalized);
+        /* A 90° rotation around X, with the omitted component being W, and
+           an identity, with the omitted component being X */
+        CORRADE_COMPARE_AS(mesh->attribute<Vector4s>(attribute),
+            Containers::arrayView<Vector4s>({
+                {23170, 0, 0, 23170},
+                {0, 0, 0, 32767}
+            }), TestSuite::Compare::Container);
+    } {
+        CORRADE_ITERATION("EXPONENTIAL");
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh("Exponential filter");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {1.5f, -2.0f, 0.75f},
+                {10.0f, 0.0f, -0.5f}
+            }), TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void GltfImporterTest::meshMeshoptCompressionInvalid() {
+    auto&& data = MeshMeshoptCompressionInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin is built without meshoptimizer, can't test EXT_meshopt_compression decoding.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "mesh-meshopt.gltf")));
+
+    /* Check we didn't forget to test anything. The remaining meshes are
+       tested in meshMeshoptCompression(), meshMeshoptCompressionTriangles()
+       and meshMeshoptCompressionFilters(). */
+    CORRADE_COMPARE(importer->meshCount(), Containers::arraySize(MeshMeshoptCompressionInvalidData) + 5);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(data.name));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::GltfImporter::mesh(): {}\n", data.message));
+    #endif
+}
+
 void GltfImporterTest::materialPbrMetallicRoughness() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
 
@@ -6526,6 +7011,98 @@ void GltfImporterTest::imageExternal() {
     CORRADE_COMPARE_AS(image->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
 }
 
+void GltfImporterTest::imageParallel() {
+    auto&& data = ImageParallelData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("threads", data.threads);
+    importer->addFlags(data.flags);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image"_s + data.suffix)));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* The first call decodes all images, the second takes the already
+       decoded one */
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image1, image0;
+    {
+        Debug redirectOutput{&out};
+        image1 = importer->image2D(1);
+        image0 = importer->image2D(0);
+    }
+    if(data.flags & ImporterFlag::Verbose)
+        CORRADE_COMPARE_AS(out.str(),
+            "Trade::GltfImporter::image2D(): autodetected hardware concurrency to ",
+            TestSuite::Compare::StringHasPrefix);
+    else
+        CORRADE_COMPARE(out.str(), "");
+
+    CORRADE_VERIFY(image1);
+    CORRADE_COMPARE(image1->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image1->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image1->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    CORRADE_VERIFY(image0);
+    CORRADE_COMPARE(image0->size(), Vector2i(5, 3));
+    CORRADE_COMPARE_AS(image0->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    /* Importer state should give the glTF image object, same as in the serial
+       case */
+    const auto* state = static_cast<const Utility::JsonToken*>(image1->importerState());
+    CORRADE_VERIFY(state);
+    CORRADE_COMPARE((*state)["name"].asString(), "Image");
+
+    /* Importing the same image again goes through the serial path */
+    Containers::Optional<Trade::ImageData2D> image1Again = importer->image2D(1);
+    CORRADE_VERIFY(image1Again);
+    CORRADE_COMPARE_AS(image1Again->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+}
+
+void GltfImporterTest::imageParallelMessages() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("threads", 2);
+    importer->addFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.gltf")));
+
+    /* Make the PngImporter print a verbose message during decoding */
+    _manager.metadata("PngImporter")->configuration().setValue("forceBitDepth", 16);
+
+    /* The messages printed by the worker threads should be captured and then
+       printed when the particular image is handed out, not to the default
+       output or dropped */
+    std::ostringstream out1, out0;
+    Containers::Optional<Trade::ImageData2D> image1, image0;
+    {
+        Debug redirectOutput{&out1};
+        image1 = importer->image2D(1);
+    } {
+        Debug redirectOutput{&out0};
+        image0 = importer->image2D(0);
+    }
+
+    /* Reset the option back to not affect other tests */
+    _manager.metadata("PngImporter")->configuration().setValue("forceBitDepth", 0);
+
+    CORRADE_VERIFY(image1);
+    CORRADE_COMPARE(image1->format(), PixelFormat::RGBA16Unorm);
+    CORRADE_VERIFY(image0);
+    CORRADE_COMPARE(image0->format(), PixelFormat::RGBA16Unorm);
+
+    /* The first call opens all images, which may print verbose messages as
+       well, the second only hands out an already decoded image */
+    CORRADE_COMPARE_AS(out1.str(),
+        "Trade::PngImporter::image2D(): expanding 8-bit channels to 16-bit\n",
+        TestSuite::Compare::StringHasSuffix);
+    CORRADE_COMPARE(out0.str(),
+        "Trade::PngImporter::image2D(): expanding 8-bit channels to 16-bit\n");
+}
+
 void GltfImporterTest::imageExternalNoPathNoCallback() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
     Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image.gltf"));
@@ -6652,6 +7229,31 @@ void GltfImporterTest::imageInvalid() {
         CORRADE_COMPARE(out.str(), Utility::formatString("Trade::GltfImporter::image2D(): {}\n", data.message));
 }
 
+void GltfImporterTest::imageInvalidParallel() {
+    auto&& data = ImageInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(data.requiresPlugin && _manager.loadState(data.requiresPlugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.requiresPlugin << "plugin not found, cannot test");
+
+    Containers::String filename = Utility::Path::join(GLTFIMPORTER_TEST_DIR, "image-invalid.gltf");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("threads", 4);
+    CORRADE_VERIFY(importer->openFile(filename));
+
+    /* Failures during the parallel decoding are silent, the failed image
+       then goes through the serial path, printing the same message as if the
+       parallel decoding wasn't enabled */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(data.name));
+    if(Containers::StringView{data.message}.hasSuffix('\n'))
+        CORRADE_COMPARE(out.str(), Utility::formatString(data.message, filename));
+    else
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::GltfImporter::image2D(): {}\n", data.message));
+}
+
 void GltfImporterTest::imageInvalidNotFound() {
     auto&& data = ImageInvalidNotFoundData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -7391,6 +7993,34 @@ void GltfImporterTest::importTwice() {
     }
 }
 
+void GltfImporterTest::benchmarkOpenNodes() {
+    auto&& data = BenchmarkOpenNodesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A balanced binary tree with a name and a custom field in each node */
+    Containers::Array<Containers::String> nodes;
+    arrayReserve(nodes, data.nodeCount);
+    for(UnsignedInt i = 0; i != data.nodeCount; ++i) {
+        Containers::String children;
+        if(2*i + 2 < data.nodeCount)
+            children = Utility::format(", \"children\": [{}, {}]", 2*i + 1, 2*i + 2);
+        else if(2*i + 1 < data.nodeCount)
+            children = Utility::format(", \"children\": [{}]", 2*i + 1);
+        arrayAppend(nodes, Utility::format("{{\"name\": \"node{0}\"{1}, \"extras\": {{\"id\": {0}}}}}", i, children));
+    }
+    const Containers::String file = Utility::format(
+        "{{\"asset\": {{\"version\": \"2.0\"}}, \"scenes\": [{{\"nodes\": [0]}}], \"nodes\": [{}]}}",
+        ",\n"_s.join(nodes));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("GltfImporter");
+    importer->configuration().setValue("lazyNodeProcessing", data.lazyNodeProcessing);
+
+    CORRADE_BENCHMARK(5) {
+        CORRADE_VERIFY(importer->openMemory(file));
+        importer->close();
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::GltfImporterTest)
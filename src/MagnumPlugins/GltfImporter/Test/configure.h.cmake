@@ -30,3 +30,4 @@
 #cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define GLTFIMPORTER_TEST_DIR "${GLTFIMPORTER_TEST_DIR}"
+#cmakedefine MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
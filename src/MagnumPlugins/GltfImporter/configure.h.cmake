@@ -25,3 +25,4 @@
 */
 
 #cmakedefine MAGNUM_GLTFIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_GLTFIMPORTER_HAS_MESHOPTIMIZER
@@ -26,7 +26,12 @@
 #include "GltfSceneConverter.h"
 
 #include <cctype> /* std::isupper() */
+#include <cstdio> /* std::fopen(), std::fread() */
 #include <algorithm> /* std::sort() */
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <type_traits> /* std::is_signed */
 #include <unordered_map>
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/ArrayViewStl.h> /** @todo drop once Configuration is STL-free */
@@ -40,6 +45,7 @@
 #include <Corrade/Containers/ScopeGuard.h>
 #include <Corrade/Containers/StridedBitArrayView.h>
 #include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStlHash.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Format.h>
@@ -47,10 +53,14 @@
 #include <Corrade/Utility/Macros.h> /* CORRADE_UNUSED */
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
+#ifdef CORRADE_TARGET_WINDOWS
+#include <Corrade/Utility/Unicode.h>
+#endif
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/FunctionsBatch.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 #include <Magnum/Trade/ArrayAllocator.h>
@@ -65,6 +75,10 @@
 #include "Magnum/Implementation/formatPluginsVersion.h"
 #include "MagnumPlugins/GltfImporter/Gltf.h"
 
+#ifdef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+#include <meshoptimizer.h>
+#endif
+
 /* We'd have to endian-flip everything that goes into buffers, plus the binary
    glTF headers, etc. Too much work, hard to automatically test because the
    HW is hard to get. */
@@ -79,12 +93,14 @@ namespace {
 /* Each value here needs a corresponding entry in extensionStrings inside
    doEndData(). Values sorted by name. */
 enum class GltfExtension {
-    KhrMaterialsClearCoat = 1 << 0,
-    KhrMaterialsUnlit = 1 << 1,
-    KhrMeshQuantization = 1 << 2,
-    KhrTextureBasisu = 1 << 3,
-    KhrTextureKtx = 1 << 4,
-    KhrTextureTransform = 1 << 5,
+    ExtMeshoptCompression = 1 << 0,
+    ExtTextureWebp = 1 << 1,
+    KhrMaterialsClearCoat = 1 << 2,
+    KhrMaterialsUnlit = 1 << 3,
+    KhrMeshQuantization = 1 << 4,
+    KhrTextureBasisu = 1 << 5,
+    KhrTextureKtx = 1 << 6,
+    KhrTextureTransform = 1 << 7,
 };
 typedef Containers::EnumSet<GltfExtension> GltfExtensions;
 #ifdef CORRADE_TARGET_CLANG
@@ -103,6 +119,135 @@ struct MeshProperties {
     Containers::Array<Containers::Pair<Containers::String, UnsignedInt>> gltfAttributes;
     Containers::Optional<UnsignedInt> gltfIndices;
     Containers::String gltfName;
+    /* Translation and uniform scale to apply to quantized positions, if the
+       quantize option was enabled for the mesh */
+    Containers::Optional<Containers::Pair<Vector3, Float>> dequantization;
+};
+
+/* Reads just the given range of a file, without having the whole file in
+   memory. Used for comparing deduplicated data that were already streamed
+   out. */
+bool readFileRange(const Containers::StringView filename, const std::size_t offset, const Containers::ArrayView<char> out) {
+    #ifdef CORRADE_TARGET_WINDOWS
+    std::FILE* const f = _wfopen(Utility::Unicode::widen(filename), L"rb");
+    #else
+    std::FILE* const f = std::fopen(Containers::String::nullTerminatedView(filename).data(), "rb");
+    #endif
+    if(!f)
+        return false;
+    const Containers::ScopeGuard closeFile{f, std::fclose};
+
+    #ifdef CORRADE_TARGET_WINDOWS
+    if(_fseeki64(f, offset, SEEK_SET) != 0)
+    #else
+    if(fseeko(f, offset, SEEK_SET) != 0)
+    #endif
+        return false;
+
+    return std::fread(out.data(), 1, out.size(), f) == out.size();
+}
+
+/* Content-based lookup of buffer views and accessors that were already
+   written, used if the deduplicate option is enabled */
+struct Deduplication {
+    struct BufferView {
+        /* 0 for the main buffer, 1 for the EXT_meshopt_compression fallback
+           buffer */
+        UnsignedInt buffer;
+        std::size_t offset, size;
+        /* Everything else that affects the written buffer view (or views, for
+           vertex data) apart from the data itself */
+        Containers::String properties;
+        /* Index of the (first) buffer view */
+        UnsignedInt gltfBufferView;
+    };
+
+    /* Returns the (first) buffer view index of data previously added with
+       addBufferView() that match given data and properties, or -1 if there's
+       no such. If the data are already appended at the end of the buffer,
+       the caller is expected to remove them again if a match is found. The
+       `bufferDataOffset` is the count of bytes preceding `bufferData` that
+       were already streamed to `bufferStreamFilename`, the range of a
+       candidate that's in there is read back for the comparison. */
+    Int findBufferView(const UnsignedInt buffer, const Containers::ArrayView<const char> bufferData, const std::size_t bufferDataOffset, const Containers::StringView bufferStreamFilename, const Containers::ArrayView<const char> data, const Containers::StringView properties) {
+        const Containers::StringView dataString{data.data(), data.size()};
+        const auto found = bufferViews.equal_range(std::hash<Containers::StringView>{}(dataString));
+        for(auto it = found.first; it != found.second; ++it) {
+            const BufferView& view = it->second;
+            if(view.buffer != buffer || view.properties != properties || view.size != data.size())
+                continue;
+
+            const std::size_t streamedSize = view.offset < bufferDataOffset ?
+                Math::min(view.size, bufferDataOffset - view.offset) : 0;
+            if(streamedSize) {
+                Containers::Array<char> streamed{NoInit, streamedSize};
+                if(!readFileRange(bufferStreamFilename, view.offset, streamed) || Containers::StringView{streamed.data(), streamedSize} != dataString.prefix(streamedSize))
+                    continue;
+            }
+            if(streamedSize != view.size && Containers::StringView{bufferData.data() + view.offset + streamedSize - bufferDataOffset, view.size - streamedSize} != dataString.exceptPrefix(streamedSize))
+                continue;
+
+            ++bufferViewCount;
+            byteCount += data.size();
+            return view.gltfBufferView;
+        }
+
+        return -1;
+    }
+
+    void addBufferView(const UnsignedInt buffer, const Containers::ArrayView<const char> bufferData, const std::size_t bufferDataOffset, const Containers::ArrayView<const char> data, const Containers::StringView properties, const UnsignedInt gltfBufferView) {
+        bufferViews.emplace(std::hash<Containers::StringView>{}(Containers::StringView{data.data(), data.size()}), BufferView{buffer, bufferDataOffset + (data.data() - bufferData.data()), data.size(), properties, gltfBufferView});
+    }
+
+    /* Returns an index of an accessor previously added with addAccessor()
+       with the same properties, or -1 if there's no such */
+    Int findAccessor(const Containers::StringView properties) {
+        const auto found = accessors.find(properties);
+        if(found == accessors.end())
+            return -1;
+
+        ++accessorCount;
+        return found->second;
+    }
+
+    void addAccessor(const Containers::StringView properties, const UnsignedInt gltfAccessor) {
+        accessors.emplace(properties, gltfAccessor);
+    }
+
+    /* Key is a hash of the data, verified against the actual buffer contents
+       in case of a collision */
+    std::unordered_multimap<std::size_t, BufferView> bufferViews;
+    /* Key is the buffer view index and all other accessor properties */
+    std::unordered_map<Containers::String, UnsignedInt> accessors;
+
+    /* Statistics printed with SceneConverterFlag::Verbose at the end */
+    std::size_t bufferViewCount = 0;
+    std::size_t accessorCount = 0;
+    std::size_t byteCount = 0;
+};
+
+/* An image added while the threads option isn't 1, encoded in doEndData() */
+struct QueuedImage {
+    /* 2D or 3D image ID, used for the external file name */
+    UnsignedInt id;
+    Containers::String name;
+    /* Instantiated and configured already in add() in order to fail early
+       and to pick up the configuration that was set at that point */
+    Containers::Pointer<AbstractImageConverter> imageConverter;
+    /* Exactly one of these is set. A copy as the caller is free to discard
+       the image once add() returns. */
+    Containers::Optional<ImageData2D> image2D;
+    Containers::Optional<ImageData3D> image3D;
+    /* Empty if the image is bundled */
+    Containers::String filename;
+    bool accessorNames;
+    bool deduplicate;
+
+    /* Filled by the encoding, including output of the image converter that
+       gets printed on the calling thread afterwards */
+    Containers::Optional<Containers::Array<char>> data;
+    bool converted;
+    Containers::String debug, warning, error;
 };
 
 }
@@ -188,11 +333,42 @@ struct GltfSceneConverter::State {
     Int defaultScene = -1;
 
     Containers::Array<char> buffer;
+    /* Uncompressed data for buffer views that have their compressed variant
+       in `buffer` via EXT_meshopt_compression. Saved as a fallback buffer
+       file only if meshoptCompressionFallback is enabled, otherwise just its
+       size is written. Empty if no compression was done. Not affected by the
+       streamBuffer option, always kept whole in memory. */
+    Containers::Array<char> meshoptFallbackBuffer;
+    /* If the streamBuffer option is enabled, name of the file the `buffer`
+       contents are appended to at the end of each add() and count of bytes
+       already written there. The `buffer` then contains only data that
+       weren't written yet. Empty if not streaming. */
+    Containers::String bufferStreamFilename;
+    std::size_t bufferStreamSize = 0;
+    bool bufferStreamFailed = false;
+
+    /* Images waiting for encoding in doEndData(), in the order they were
+       added. Non-empty only if the threads option was not 1. */
+    Containers::Array<QueuedImage> queuedImages;
+
+    Deduplication deduplication;
 };
 
 using namespace Containers::Literals;
 using namespace Math::Literals;
 
+void GltfSceneConverter::initialize() {
+    /* The codec versions are global state in meshoptimizer, set them just
+       once on plugin load instead of on every mesh addition. The
+       EXT_meshopt_compression extension is specified for index codec version
+       1 and vertex codec version 0, newer versions wouldn't be decodable by
+       conforming importers. */
+    #ifdef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+    meshopt_encodeIndexVersion(1);
+    meshopt_encodeVertexVersion(0);
+    #endif
+}
+
 GltfSceneConverter::GltfSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractSceneConverter{manager, plugin} {}
 
 GltfSceneConverter::~GltfSceneConverter() = default;
@@ -224,6 +400,20 @@ bool GltfSceneConverter::doBeginFile(const Containers::StringView filename) {
         _state->binary = Utility::String::lowercase(Utility::Path::splitExtension(filename).second()) != ".gltf"_s;
     } else _state->binary = configuration().value<bool>("binary");
 
+    /* If streaming the buffer, a text glTF gets the data directly in the
+       external buffer file, a binary glTF in a temporary file that's copied
+       to the BIN chunk at the end. Create it upfront to fail early. */
+    if(configuration().value<bool>("streamBuffer")) {
+        _state->bufferStreamFilename = _state->binary ?
+            filename + ".tmp"_s :
+            Utility::Path::splitExtension(filename).first() + ".bin"_s;
+        if(!Utility::Path::write(_state->bufferStreamFilename, Containers::ArrayView<const void>{})) {
+            Error{} << "Trade::GltfSceneConverter::beginFile(): can't create" << _state->bufferStreamFilename << "for streaming the buffer";
+            _state = {};
+            return false;
+        }
+    }
+
     return AbstractSceneConverter::doBeginFile(filename);
 }
 
@@ -266,8 +456,28 @@ bool GltfSceneConverter::doBeginData() {
     return true;
 }
 
-Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
-    Utility::JsonWriter json{_state->jsonOptions, _state->jsonIndentation};
+bool GltfSceneConverter::writeJson(Utility::JsonWriter& json) {
+    /* Encode all queued images first, as that's where the data get appended
+       to the buffer and written to the images array */
+    if(!_state->queuedImages.isEmpty() && !encodeQueuedImages())
+        return {};
+
+    /* If there's any EXT_meshopt_compression data, the extension is required
+       unless an uncompressed fallback buffer is saved as well. The fallback
+       can only be an external file so check that upfront. */
+    const bool meshoptCompressionFallback = !_state->meshoptFallbackBuffer.isEmpty() && configuration().value<bool>("meshoptCompressionFallback");
+    if(meshoptCompressionFallback) {
+        if(!_state->filename) {
+            Error{} << "Trade::GltfSceneConverter::endData(): can only write an EXT_meshopt_compression fallback buffer if converting to a file";
+            return {};
+        }
+        _state->usedExtensions |= GltfExtension::ExtMeshoptCompression;
+    } else if(!_state->meshoptFallbackBuffer.isEmpty())
+        _state->requiredExtensions |= GltfExtension::ExtMeshoptCompression;
+
+    if((flags() & SceneConverterFlag::Verbose) && (_state->deduplication.bufferViewCount || _state->deduplication.accessorCount))
+        Debug{} << "Trade::GltfSceneConverter::endData(): deduplicated" << _state->deduplication.bufferViewCount << "buffer views and" << _state->deduplication.accessorCount << "accessors, saving" << _state->deduplication.byteCount << "bytes";
+
     json.beginObject();
 
     /* Asset object, always present */
@@ -323,6 +533,8 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
            the loop */
         GltfExtensions usedExtensions = _state->usedExtensions|_state->requiredExtensions;
         const Containers::Pair<GltfExtension, Containers::StringView> extensionStrings[]{
+            {GltfExtension::ExtMeshoptCompression, "EXT_meshopt_compression"_s},
+            {GltfExtension::ExtTextureWebp, "EXT_texture_webp"_s},
             {GltfExtension::KhrMaterialsClearCoat, "KHR_materials_clearcoat"_s},
             {GltfExtension::KhrMaterialsUnlit, "KHR_materials_unlit"_s},
             {GltfExtension::KhrMeshQuantization, "KHR_mesh_quantization"_s},
@@ -352,33 +564,65 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
         }
     }
 
+    /* If streaming, write also the remaining data to the file. The buffer
+       is empty after. */
+    flushBuffer(true);
+    const std::size_t bufferSize = _state->bufferStreamSize + _state->buffer.size();
+
     /* Wrap up the buffer if it's non-empty or if there are any (empty) buffer
        views referencing it */
-    if(!_state->buffer.isEmpty() || !_state->gltfBufferViews.isEmpty()) {
+    if(bufferSize || !_state->gltfBufferViews.isEmpty()) {
         json.writeKey("buffers"_s);
         const Containers::ScopeGuard gltfBuffers = json.beginArrayScope();
-        const Containers::ScopeGuard gltfBuffer = json.beginObjectScope();
-
-        /* If not writing a binary glTF and the buffer is non-empty, save the
-           buffer to an external file and reference it. In a binary glTF the
-           buffer is just one with an implicit location. */
-        if(!_state->binary && !_state->buffer.isEmpty()) {
-            if(!_state->filename) {
-                Error{} << "Trade::GltfSceneConverter::endData(): can only write a glTF with external buffers if converting to a file";
-                return {};
-            }
 
-            Containers::String bufferFilename = Utility::Path::splitExtension(*_state->filename).first() + ".bin"_s;
-            Utility::Path::write(bufferFilename, _state->buffer);
-            /** @todo configurable buffer name? or a path prefix if ending with /?
-                or an extension alone if .. what, exactly? */
+        {
+            const Containers::ScopeGuard gltfBuffer = json.beginObjectScope();
+
+            /* If not writing a binary glTF and the buffer is non-empty, save
+               the buffer to an external file and reference it. In a binary
+               glTF the buffer is just one with an implicit location. */
+            if(!_state->binary && bufferSize) {
+                if(!_state->filename) {
+                    Error{} << "Trade::GltfSceneConverter::endData(): can only write a glTF with external buffers if converting to a file";
+                    return {};
+                }
+
+                /* If streaming, the data are already in this file */
+                Containers::String bufferFilename = Utility::Path::splitExtension(*_state->filename).first() + ".bin"_s;
+                if(!_state->bufferStreamFilename)
+                    Utility::Path::write(bufferFilename, _state->buffer);
+                /** @todo configurable buffer name? or a path prefix if ending
+                    with /? or an extension alone if .. what, exactly? */
+
+                /* Writing just the filename as the two files are expected to
+                   be next to each other */
+                json.writeKey("uri"_s).write(Utility::Path::split(bufferFilename).second());
+            }
 
-            /* Writing just the filename as the two files are expected to be
-               next to each other */
-            json.writeKey("uri"_s).write(Utility::Path::split(bufferFilename).second());
+            json.writeKey("byteLength"_s).write(bufferSize);
         }
 
-        json.writeKey("byteLength"_s).write(_state->buffer.size());
+        /* EXT_meshopt_compression fallback buffer, if anything got
+           compressed. Its contents are saved to an external file only if
+           requested, otherwise it has just the size and decoders are expected
+           to allocate it and decompress the data into it. */
+        if(!_state->meshoptFallbackBuffer.isEmpty()) {
+            const Containers::ScopeGuard gltfBuffer = json.beginObjectScope();
+
+            if(meshoptCompressionFallback) {
+                Containers::String bufferFilename = Utility::Path::splitExtension(*_state->filename).first() + ".fallback.bin"_s;
+                Utility::Path::write(bufferFilename, _state->meshoptFallbackBuffer);
+                json.writeKey("uri"_s).write(Utility::Path::split(bufferFilename).second());
+            }
+
+            json.writeKey("byteLength"_s).write(_state->meshoptFallbackBuffer.size());
+
+            json.writeKey("extensions"_s);
+            const Containers::ScopeGuard gltfExtensions = json.beginObjectScope();
+            json.writeKey("EXT_meshopt_compression"_s);
+            const Containers::ScopeGuard gltfMeshoptCompression = json.beginObjectScope();
+            json.writeKey("fallback"_s).write(true);
+        }
     }
 
     /* Buffer views, accessors, ... If there are any, the array is left open --
@@ -492,49 +736,83 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
     /* Done! */
     json.endObject();
 
-    union CharCaster {
-        UnsignedInt value;
-        const char data[4];
-    };
+    return true;
+}
+
+namespace {
 
+union CharCaster {
+    UnsignedInt value;
+    const char data[4];
+};
+
+/* Puts together a binary glTF file header, the JSON chunk including padding
+   and a BIN chunk header if binSize is non-zero. The BIN chunk data and
+   padding are then expected to be appended by the caller, space for them is
+   reserved only if reserveBin is set. Fails if the file wouldn't fit into the
+   32-bit size fields. */
+Containers::Optional<Containers::Array<char>> glbHeaderJsonChunk(const char* const messagePrefix, const Containers::StringView json, const std::size_t binSize, const bool reserveBin) {
     /* Padding after JSON and binary chunks to satisfy four-byte alignment
-       requirements. Used only in case of a binary output. */
-    std::size_t jsonChunkPadding;
-    std::size_t binChunkPadding;
+       requirements */
+    const std::size_t jsonChunkPadding = 4*((json.size() + 3)/4) - json.size();
+    const std::size_t binChunkPadding = 4*((binSize + 3)/4) - binSize;
+    CORRADE_INTERNAL_ASSERT(jsonChunkPadding <= 3 && binChunkPadding <= 3);
+
+    const std::size_t totalSize = 12 + /* file header */
+        /* JSON chunk + header + padding */
+        8 + json.size() + jsonChunkPadding +
+        /* BIN chunk + header + padding */
+        (!binSize ? 0 : 8 + binSize + binChunkPadding);
+
+    /* The total size is larger than any of the chunk sizes, so checking just
+       that is enough */
+    if(UnsignedLong(totalSize) > 0xffffffffull) {
+        Error{} << messagePrefix << "binary glTF size of" << totalSize << "bytes doesn't fit into 32 bits, write a text glTF instead";
+        return {};
+    }
 
-    /* Reserve the output array and write headers for a binary glTF */
     Containers::Array<char> out;
-    if(_state->binary) {
-        jsonChunkPadding = 4*((json.size() + 3)/4) - json.size();
-        binChunkPadding = 4*((_state->buffer.size() + 3)/4) - _state->buffer.size();
-        CORRADE_INTERNAL_ASSERT(jsonChunkPadding <= 3 && binChunkPadding <= 3);
-
-        const std::size_t totalSize = 12 + /* file header */
-            /* JSON chunk + header + padding */
-            8 + json.size() + jsonChunkPadding +
-            /* BIN chunk + header + padding */
-            (_state->buffer.isEmpty() ? 0 :
-                8 + _state->buffer.size() + binChunkPadding);
-        Containers::arrayReserve<ArrayAllocator>(out, totalSize);
-
-        /* glTF header */
+    Containers::arrayReserve<ArrayAllocator>(out, reserveBin ? totalSize :
+        totalSize - (!binSize ? 0 : binSize + binChunkPadding));
+
+    /* glTF header */
+    Containers::arrayAppend<ArrayAllocator>(out,
+        "glTF\x02\x00\x00\x00"_s);
+    Containers::arrayAppend<ArrayAllocator>(out,
+        CharCaster{UnsignedInt(totalSize)}.data);
+
+    /* JSON chunk header. The size includes padding. */
+    Containers::arrayAppend<ArrayAllocator>(out,
+        CharCaster{UnsignedInt(json.size() + jsonChunkPadding)}.data);
+    Containers::arrayAppend<ArrayAllocator>(out,
+        "JSON"_s);
+
+    /* JSON chunk data and padding, which has to be spaces */
+    Containers::arrayAppend<ArrayAllocator>(out, json);
+    for(char& i: Containers::arrayAppend<ArrayAllocator>(out, NoInit, jsonChunkPadding))
+        i = ' ';
+
+    /* BIN chunk header. The size includes padding again. */
+    if(binSize) {
         Containers::arrayAppend<ArrayAllocator>(out,
-            "glTF\x02\x00\x00\x00"_s);
+            CharCaster{UnsignedInt(binSize + binChunkPadding)}.data);
         Containers::arrayAppend<ArrayAllocator>(out,
-            CharCaster{UnsignedInt(totalSize)}.data);
+            "BIN\0"_s);
+    }
 
-        /* JSON chunk header. The size includes padding. */
-        Containers::arrayAppend<ArrayAllocator>(out,
-            CharCaster{UnsignedInt(json.size() + jsonChunkPadding)}.data);
-        Containers::arrayAppend<ArrayAllocator>(out,
-            "JSON"_s);
+    /* GCC 4.8 and Clang 3.8 need extra help here */
+    return Containers::optional(Utility::move(out));
+}
 
-    /* Otherwise reserve just for the JSON. Set the padding values to a
-       nonsense to catch accidental uses. */
-    } else {
-        Containers::arrayReserve<ArrayAllocator>(out, json.size());
-        jsonChunkPadding = binChunkPadding = ~std::size_t{};
-    }
+/* Zeros to pad the BIN chunk with */
+constexpr const char BinChunkPadding[3]{};
+
+}
+
+Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
+    Utility::JsonWriter json{_state->jsonOptions, _state->jsonIndentation};
+    if(!writeJson(json))
+        return {};
 
     /* Copy the JSON data to the output. In case of a text glTF we would
        ideally just pass the memory from the JsonWriter but the class uses an
@@ -542,25 +820,22 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
        in plugins. */
     /** @todo make it possible to specify an external allocator in JsonWriter
         once allocators-as-arguments are a thing */
-    Containers::arrayAppend<ArrayAllocator>(out, json.toString());
+    Containers::Array<char> out;
+    if(!_state->binary) {
+        Containers::arrayReserve<ArrayAllocator>(out, json.size());
+        Containers::arrayAppend<ArrayAllocator>(out, json.toString());
 
-    /* In case of a binary glTF add more data after */
-    if(_state->binary) {
-        /* JSON chunk padding, have to be spaces */
-        for(char& i: Containers::arrayAppend<ArrayAllocator>(out, NoInit, jsonChunkPadding))
-            i = ' ';
+    /* In case of a binary glTF add the buffer as a second BIN chunk, the
+       padding has to be zeros this time */
+    } else {
+        Containers::Optional<Containers::Array<char>> header = glbHeaderJsonChunk("Trade::GltfSceneConverter::endData():", json.toString(), _state->buffer.size(), true);
+        if(!header)
+            return {};
 
-        /* Add the buffer as a second BIN chunk. The size includes padding
-           again, this time the padding has to be zeros. */
+        out = Utility::move(*header);
         if(!_state->buffer.isEmpty()) {
-            Containers::arrayAppend<ArrayAllocator>(out,
-                CharCaster{UnsignedInt(_state->buffer.size() + binChunkPadding)}.data);
-            Containers::arrayAppend<ArrayAllocator>(out,
-                "BIN\0"_s);
-            Containers::arrayAppend<ArrayAllocator>(out,
-                _state->buffer);
-            for(char& i: Containers::arrayAppend<ArrayAllocator>(out, NoInit, binChunkPadding))
-                i = '\0';
+            Containers::arrayAppend<ArrayAllocator>(out, _state->buffer);
+            Containers::arrayAppend<ArrayAllocator>(out, Containers::arrayView(BinChunkPadding).prefix(4*((_state->buffer.size() + 3)/4) - _state->buffer.size()));
         }
     }
 
@@ -568,10 +843,84 @@ Containers::Optional<Containers::Array<char>> GltfSceneConverter::doEndData() {
     return Containers::optional(Utility::move(out));
 }
 
+bool GltfSceneConverter::doEndFile(const Containers::StringView filename) {
+    /* If not streaming, the base implementation delegates to doEndData() and
+       writes its output */
+    if(!_state->bufferStreamFilename)
+        return AbstractSceneConverter::doEndFile(filename);
+
+    Utility::JsonWriter json{_state->jsonOptions, _state->jsonIndentation};
+    if(!writeJson(json))
+        return {};
+
+    /* Path::append() printed a message already */
+    if(_state->bufferStreamFailed) {
+        Error{} << "Trade::GltfSceneConverter::endFile(): can't stream the buffer to" << _state->bufferStreamFilename;
+        return {};
+    }
+
+    /* For a text glTF the data were streamed directly to the external buffer
+       file, which writeJson() referenced. If the buffer ended up empty, it
+       isn't referenced however, so remove it. */
+    Containers::String bufferStreamFilename = Utility::move(_state->bufferStreamFilename);
+    if(!_state->binary) {
+        if(!_state->bufferStreamSize)
+            Utility::Path::remove(bufferStreamFilename);
+        return Utility::Path::writeString(filename, json.toString());
+    }
+
+    /* For a binary glTF write the headers and the JSON chunk first, then
+       append the temporary file as the BIN chunk and remove it. */
+    const Containers::ScopeGuard removeBufferStream{&bufferStreamFilename, [](Containers::String* filename) {
+        Utility::Path::remove(*filename);
+    }};
+    const Containers::Optional<Containers::Array<char>> header = glbHeaderJsonChunk("Trade::GltfSceneConverter::endFile():", json.toString(), _state->bufferStreamSize, false);
+    if(!header || !Utility::Path::write(filename, *header))
+        return {};
+    if(_state->bufferStreamSize) {
+        /* Map the file instead of reading it if possible so the data doesn't
+           need to be all in memory again */
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        const Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> data = Utility::Path::mapRead(bufferStreamFilename);
+        #else
+        const Containers::Optional<Containers::Array<char>> data = Utility::Path::read(bufferStreamFilename);
+        #endif
+        if(!data || !Utility::Path::append(filename, Containers::arrayView(*data)) || !Utility::Path::append(filename, Containers::arrayView(BinChunkPadding).prefix(4*((data->size() + 3)/4) - data->size())))
+            return {};
+    }
+
+    return true;
+}
+
 void GltfSceneConverter::doAbort() {
+    /* Remove the partially written buffer stream file, if any. If ending the
+       file was successful, the name is cleared already. */
+    if(_state && _state->bufferStreamFilename)
+        Utility::Path::remove(_state->bufferStreamFilename);
     _state = {};
 }
 
+void GltfSceneConverter::flushBuffer(const bool all) {
+    if(!_state->bufferStreamFilename)
+        return;
+
+    /* Unless writing everything, write only a multiple of four bytes, so the
+       alignment of data appended later can be still calculated from the
+       in-memory buffer size alone */
+    const std::size_t size = all ? _state->buffer.size() : _state->buffer.size() & ~std::size_t{3};
+    if(!size)
+        return;
+
+    if(!Utility::Path::append(_state->bufferStreamFilename, _state->buffer.prefix(size)))
+        _state->bufferStreamFailed = true;
+    _state->bufferStreamSize += size;
+
+    /* Move the remaining at most three bytes to the front */
+    for(std::size_t i = size; i != _state->buffer.size(); ++i)
+        _state->buffer[i - size] = _state->buffer[i];
+    arrayRemoveSuffix(_state->buffer, size);
+}
+
 void GltfSceneConverter::doSetDefaultScene(const UnsignedInt id) {
     _state->defaultScene = id;
 }
@@ -1059,6 +1408,60 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
             stringOffset == customStringFieldCount);
     }
 
+    /* Finds a sorted sequence of mesh and material assignments among
+       already used assignments, adding it as a new one if not found, and
+       returns its index. `meshMaterialAssignmentRanges` is either empty or
+       contains i + 1 items for i meshes referenced by the scene. */
+    const auto gltfMeshForAssignments = [&](const Containers::ArrayView<const Containers::Pair<UnsignedInt, Int>> sortedMeshMaterialAssignments) {
+        Containers::Optional<UnsignedInt> meshId;
+        if(!_state->meshMaterialAssignmentRanges.isEmpty()) for(UnsignedInt j = 0; j != _state->meshMaterialAssignmentRanges.size() - 1; ++j) {
+            const Containers::ArrayView<const Containers::Pair<UnsignedInt, Int>> meshMaterialAssignmentCandidates = _state->meshMaterialAssignments.slice(_state->meshMaterialAssignmentRanges[j], _state->meshMaterialAssignmentRanges[j + 1]);
+
+            /* If it has different mesh count, it's definitely not what we're
+               looking for */
+            if(meshMaterialAssignmentCandidates.size() != sortedMeshMaterialAssignments.size())
+                continue;
+
+            /* Inverse the logic to not need to invent horrible shit to break
+               out of two loops at once -- set the meshId upfront and unset it
+               if comparison fails, then break out of the outer loop if it's
+               still set at the end */
+            meshId = j;
+            /** @todo something better than O(n^3) lookup? sigh */
+            for(std::size_t k = 0; k != sortedMeshMaterialAssignments.size(); ++k) {
+                if(meshMaterialAssignmentCandidates[k] != sortedMeshMaterialAssignments[k]) {
+                    meshId = {};
+                    break;
+                }
+            }
+            if(meshId)
+                break;
+        }
+
+        /* If not found, add the sorted sequence as a new assignment. If
+           meshMaterialAssignmentRanges is empty, add 0 as the first
+           element. */
+        if(!meshId) {
+            arrayAppend(_state->meshMaterialAssignments, sortedMeshMaterialAssignments);
+
+            if(_state->meshMaterialAssignmentRanges.isEmpty())
+                arrayAppend(_state->meshMaterialAssignmentRanges, 0);
+
+            meshId = _state->meshMaterialAssignmentRanges.size() - 1;
+            arrayAppend(_state->meshMaterialAssignmentRanges, _state->meshMaterialAssignments.size());
+        }
+
+        return *meshId;
+    };
+
+    /* Meshes that were quantized by the quantize option and have a
+       dequantization transform are each put into a dedicated child node
+       carrying the transform, so it doesn't affect the node's own children or
+       other meshes assigned to it. These nodes are written after all others,
+       i.e. their IDs start at `parentFieldSize`. Each item is (mesh ID, glTF
+       mesh ID). */
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> dequantizedMeshNodes;
+
     /* Go object by object and consume the fields, populating the glTF node
        array. The output is currently restricted to a single scene, so the
        glTF nodes array should still be empty at this point. Otherwise we'd
@@ -1081,8 +1484,23 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
             gltfNodes = _state->gltfNodes.beginArrayScope();
         const Containers::ScopeGuard gltfNode = _state->gltfNodes.beginObjectScope();
 
-        /* Write the children array, if there's any */
-        if(childOffsets[object + 1] - childOffsets[object]) {
+        /* Count meshes that get put into dedicated child nodes */
+        UnsignedInt dequantizedMeshCount = 0;
+        for(std::size_t i = objectFieldOffsets[object], iMax = objectFieldOffsets[object + 1]; i != iMax; ++i) {
+            if(scene.fieldName(fieldIds[i]) == SceneField::Mesh && _state->meshes[meshesMaterials[fieldOffsets[i]].first()].dequantization)
+                ++dequantizedMeshCount;
+        }
+
+        /* Write the children array, if there's any, including the nodes
+           for dequantized meshes */
+        if(dequantizedMeshCount) {
+            _state->gltfNodes.writeKey("children"_s).beginCompactArray();
+            for(const UnsignedInt child: children.slice(childOffsets[object], childOffsets[object + 1]))
+                _state->gltfNodes.write(child);
+            for(UnsignedInt i = 0; i != dequantizedMeshCount; ++i)
+                _state->gltfNodes.write(parentFieldSize + dequantizedMeshNodes.size() + i);
+            _state->gltfNodes.endArray();
+        } else if(childOffsets[object + 1] - childOffsets[object]) {
             _state->gltfNodes.writeKey("children"_s).writeArray(children.slice(childOffsets[object], childOffsets[object + 1]));
         }
 
@@ -1096,6 +1514,7 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
            deduplicate them. Gets cleared and refilled for each object that has
            a Mesh field. */
         Containers::Array<Containers::Pair<UnsignedInt, Int>> sortedMeshMaterialAssignments;
+        Containers::Array<Containers::Pair<UnsignedInt, Int>> dequantizedMeshMaterialAssignments;
 
         SceneField previous{};
         for(std::size_t i = objectFieldOffsets[object], iMax = objectFieldOffsets[object + 1]; i != iMax; ++i) {
@@ -1211,56 +1630,27 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
                 CORRADE_INTERNAL_ASSERT(multiEntryFieldSize >= 1);
                 /** @todo arrayClear(), *finally */
                 arrayResize(sortedMeshMaterialAssignments, 0);
-                for(std::size_t j = 0; j != multiEntryFieldSize; ++j)
-                    arrayAppend(sortedMeshMaterialAssignments, meshesMaterials[fieldOffsets[i + j]]);
+                arrayResize(dequantizedMeshMaterialAssignments, 0);
+                for(std::size_t j = 0; j != multiEntryFieldSize; ++j) {
+                    const Containers::Pair<UnsignedInt, Int> meshMaterial = meshesMaterials[fieldOffsets[i + j]];
+                    arrayAppend(_state->meshes[meshMaterial.first()].dequantization ?
+                        dequantizedMeshMaterialAssignments :
+                        sortedMeshMaterialAssignments, meshMaterial);
+                }
                 std::sort(sortedMeshMaterialAssignments.begin(), sortedMeshMaterialAssignments.end(), [](const Containers::Pair<UnsignedInt, Int> a, const Containers::Pair<UnsignedInt, Int> b) {
                     return
                         a.first() < b.first() ||
                         (a.first() == b.first() && a.second() < b.second());
                 });
 
-                /* Try to find this sequence among already used assignments.
-                   `meshMaterialAssignmentRanges` is either empty or contains
-                   i + 1 items for i meshes referenced by the scene. */
-                Containers::Optional<UnsignedInt> meshId;
-                if(!_state->meshMaterialAssignmentRanges.isEmpty()) for(UnsignedInt j = 0; j != _state->meshMaterialAssignmentRanges.size() - 1; ++j) {
-                    const Containers::ArrayView<const Containers::Pair<UnsignedInt, Int>> meshMaterialAssignmentCandidates = _state->meshMaterialAssignments.slice(_state->meshMaterialAssignmentRanges[j], _state->meshMaterialAssignmentRanges[j + 1]);
-
-                    /* If it has different mesh count, it's definitely not what
-                       we're looking for */
-                    if(meshMaterialAssignmentCandidates.size() != sortedMeshMaterialAssignments.size())
-                        continue;
-
-                    /* Inverse the logic to not need to invent horrible shit to
-                       break out of two loops at once -- set the meshId upfront
-                       and unset it if comparison fails, then break out of the
-                       outer loop if it's still set at the end */
-                    meshId = j;
-                    /** @todo something better than O(n^3) lookup? sigh */
-                    for(std::size_t k = 0; k != sortedMeshMaterialAssignments.size(); ++k) {
-                        if(meshMaterialAssignmentCandidates[k] != sortedMeshMaterialAssignments[k]) {
-                            meshId = {};
-                            break;
-                        }
-                    }
-                    if(meshId)
-                        break;
-                }
-
-                /* If not found, add the sorted sequence as a new assignment.
-                   If meshMaterialAssignmentRanges is empty, add 0 as the first
-                   element. */
-                if(!meshId) {
-                    arrayAppend(_state->meshMaterialAssignments, sortedMeshMaterialAssignments);
-
-                    if(_state->meshMaterialAssignmentRanges.isEmpty())
-                        arrayAppend(_state->meshMaterialAssignmentRanges, 0);
-
-                    meshId = _state->meshMaterialAssignmentRanges.size() - 1;
-                    arrayAppend(_state->meshMaterialAssignmentRanges, _state->meshMaterialAssignments.size());
-                }
-
-                _state->gltfNodes.writeKey("mesh"_s).write(*meshId);
+                /* Meshes quantized with a dequantization transform go to
+                   dedicated child nodes, the rest stays in this node */
+                if(!sortedMeshMaterialAssignments.isEmpty())
+                    _state->gltfNodes.writeKey("mesh"_s).write(gltfMeshForAssignments(sortedMeshMaterialAssignments));
+                for(const Containers::Pair<UnsignedInt, Int>& dequantizedMeshMaterialAssignment: dequantizedMeshMaterialAssignments)
+                    arrayAppend(dequantizedMeshNodes, InPlaceInit,
+                        dequantizedMeshMaterialAssignment.first(),
+                        gltfMeshForAssignments({&dequantizedMeshMaterialAssignment, 1}));
 
                 /* Skip the remaining mesh assignments as otherwise they would
                    warn in the next iteration */
@@ -1285,6 +1675,18 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const SceneData& scene, con
             _state->gltfNodes.writeKey("name"_s).write(_state->objectNames[object]);
     }
 
+    /* Nodes for meshes with a dequantization transform, referenced from
+       their parent nodes above */
+    for(const Containers::Pair<UnsignedInt, UnsignedInt>& dequantizedMeshNode: dequantizedMeshNodes) {
+        const Containers::ScopeGuard gltfNode = _state->gltfNodes.beginObjectScope();
+        const Containers::Pair<Vector3, Float>& dequantization = *_state->meshes[dequantizedMeshNode.first()].dequantization;
+        if(dequantization.first() != Vector3{})
+            _state->gltfNodes.writeKey("translation"_s).writeArray(dequantization.first().data());
+        if(dequantization.second() != 1.0f)
+            _state->gltfNodes.writeKey("scale"_s).writeArray(Vector3{dequantization.second()}.data());
+        _state->gltfNodes.writeKey("mesh"_s).write(dequantizedMeshNode.second());
+    }
+
     /* Scene object referencing the root children */
     CORRADE_INTERNAL_ASSERT(_state->gltfScenes.isEmpty());
     const Containers::ScopeGuard gltfScenes = _state->gltfScenes.beginArrayScope();
@@ -1312,7 +1714,162 @@ void GltfSceneConverter::doSetMeshAttributeName(const MeshAttribute attribute, C
     arrayAppend(_state->customMeshAttributes, InPlaceInit, attribute, Containers::String::nullTerminatedGlobalView(name));
 }
 
-bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const Containers::StringView name) {
+#ifdef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+namespace {
+
+/* Writes the EXT_meshopt_compression object into a buffer view. The
+   compressed data are always in the first buffer. */
+void writeMeshoptCompression(Utility::JsonWriter& json, const std::size_t byteOffset, const std::size_t byteLength, const std::size_t byteStride, const std::size_t count, const Containers::StringView mode) {
+    json.writeKey("extensions"_s);
+    const Containers::ScopeGuard gltfExtensions = json.beginObjectScope();
+    json.writeKey("EXT_meshopt_compression"_s);
+    const Containers::ScopeGuard gltfMeshoptCompression = json.beginObjectScope();
+    json.writeKey("buffer"_s).write(0)
+        .writeKey("byteOffset"_s).write(byteOffset)
+        .writeKey("byteLength"_s).write(byteLength)
+        .writeKey("byteStride"_s).write(byteStride)
+        .writeKey("count"_s).write(count)
+        .writeKey("mode"_s).write(mode);
+}
+
+}
+#endif
+
+namespace {
+
+/* Quantizes a floating-point attribute, returning the max absolute error */
+template<class T, class U> Float quantizeAttribute(const Containers::StridedArrayView1D<const U>& src, const Containers::StridedArrayView1D<T>& dst, const U& offset, const Float scale) {
+    Float maxError = 0.0f;
+    for(std::size_t i = 0; i != src.size(); ++i) {
+        dst[i] = Math::pack<T>(Math::clamp((src[i] - offset)/scale, std::is_signed<typename T::Type>::value ? -1.0f : 0.0f, 1.0f));
+        maxError = Math::max(maxError, Math::abs(Math::unpack<U>(dst[i])*scale + offset - src[i]).max());
+    }
+    return maxError;
+}
+
+/* Converts float positions, normals, tangents and texture coordinates to
+   normalized 8- or 16-bit formats allowed by KHR_mesh_quantization, returning
+   NullOpt if there's nothing to quantize. All attributes are put into a new
+   interleaved buffer with each attribute padded to four bytes as glTF
+   requires. Positions are scaled into the unit cube, the translation and
+   uniform scale undoing that is saved into `dequantization`. The scale is
+   uniform because a non-uniform one would skew the normals. Texture
+   coordinates are quantized only if they're in the [0, 1] range, as signed or
+   unnormalized formats couldn't be Y-flipped. */
+Containers::Optional<MeshData> quantizeMesh(const MeshData& mesh, const UnsignedInt positionBits, const UnsignedInt normalBits, const UnsignedInt textureCoordinateBits, Containers::Optional<Containers::Pair<Vector3, Float>>& dequantization, const bool verbose) {
+    /* Let the actual export deal with invalid meshes */
+    if(!mesh.vertexCount() ||
+       (mesh.isIndexed() && isMeshIndexTypeImplementationSpecific(mesh.indexType())))
+        return {};
+
+    /* Decide on the output format of each attribute and calculate the
+       interleaved layout */
+    Containers::Array<VertexFormat> formats{NoInit, mesh.attributeCount()};
+    Containers::Array<std::size_t> offsets{NoInit, mesh.attributeCount()};
+    bool quantized = false;
+    std::size_t stride = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const MeshAttribute name = mesh.attributeName(i);
+        const VertexFormat format = mesh.attributeFormat(i);
+        if(isVertexFormatImplementationSpecific(format) || mesh.attributeStride(i) <= 0)
+            return {};
+
+        formats[i] = format;
+        if(!mesh.attributeArraySize(i)) {
+            /* Only the first position gets quantized, as the
+               dequantization transform is a property of the node */
+            if(name == MeshAttribute::Position && format == VertexFormat::Vector3 && mesh.attributeId(i) == 0)
+                formats[i] = positionBits == 8 ? VertexFormat::Vector3ubNormalized : VertexFormat::Vector3usNormalized;
+            else if(name == MeshAttribute::Normal && format == VertexFormat::Vector3)
+                formats[i] = normalBits == 8 ? VertexFormat::Vector3bNormalized : VertexFormat::Vector3sNormalized;
+            else if(name == MeshAttribute::Tangent && format == VertexFormat::Vector4)
+                formats[i] = normalBits == 8 ? VertexFormat::Vector4bNormalized : VertexFormat::Vector4sNormalized;
+            else if(name == MeshAttribute::TextureCoordinates && format == VertexFormat::Vector2) {
+                const Containers::Pair<Vector2, Vector2> minmax = Math::minmax(mesh.attribute<Vector2>(i));
+                if((minmax.first() >= Vector2{0.0f}).all() && (minmax.second() <= Vector2{1.0f}).all())
+                    formats[i] = textureCoordinateBits == 8 ? VertexFormat::Vector2ubNormalized : VertexFormat::Vector2usNormalized;
+            }
+        }
+
+        if(formats[i] != format)
+            quantized = true;
+
+        offsets[i] = stride;
+        const std::size_t size = vertexFormatSize(formats[i])*(mesh.attributeArraySize(i) ? mesh.attributeArraySize(i) : 1);
+        stride += 4*((size + 3)/4);
+    }
+
+    if(!quantized)
+        return {};
+
+    Containers::Array<char> vertexData{ValueInit, stride*mesh.vertexCount()};
+    Containers::Array<MeshAttributeData> attributeData{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const Containers::StridedArrayView1D<void> data{vertexData, vertexData.data() + offsets[i], mesh.vertexCount(), std::ptrdiff_t(stride)};
+        attributeData[i] = MeshAttributeData{mesh.attributeName(i), formats[i], data, mesh.attributeArraySize(i)};
+
+        const VertexFormat format = mesh.attributeFormat(i);
+        Float maxError = 0.0f;
+        if(formats[i] == format) {
+            Utility::copy(mesh.attribute(i), Containers::StridedArrayView2D<char>{vertexData, static_cast<char*>(data.data()), {mesh.vertexCount(), mesh.attribute(i).size()[1]}, {std::ptrdiff_t(stride), 1}});
+            continue;
+        } else if(format == VertexFormat::Vector3 && mesh.attributeName(i) == MeshAttribute::Position) {
+            const Containers::StridedArrayView1D<const Vector3> positions = mesh.attribute<Vector3>(i);
+            const Containers::Pair<Vector3, Vector3> minmax = Math::minmax(positions);
+            const Float extent = (minmax.second() - minmax.first()).max();
+            dequantization.emplace(minmax.first(), extent > 0.0f ? extent : 1.0f);
+            if(formats[i] == VertexFormat::Vector3ubNormalized)
+                maxError = quantizeAttribute(positions, Containers::arrayCast<Vector3ub>(data), dequantization->first(), dequantization->second());
+            else
+                maxError = quantizeAttribute(positions, Containers::arrayCast<Vector3us>(data), dequantization->first(), dequantization->second());
+        } else if(format == VertexFormat::Vector3) {
+            if(formats[i] == VertexFormat::Vector3bNormalized)
+                maxError = quantizeAttribute(mesh.attribute<Vector3>(i), Containers::arrayCast<Vector3b>(data), Vector3{}, 1.0f);
+            else
+                maxError = quantizeAttribute(mesh.attribute<Vector3>(i), Containers::arrayCast<Vector3s>(data), Vector3{}, 1.0f);
+        } else if(format == VertexFormat::Vector4) {
+            if(formats[i] == VertexFormat::Vector4bNormalized)
+                maxError = quantizeAttribute(mesh.attribute<Vector4>(i), Containers::arrayCast<Vector4b>(data), Vector4{}, 1.0f);
+            else
+                maxError = quantizeAttribute(mesh.attribute<Vector4>(i), Containers::arrayCast<Vector4s>(data), Vector4{}, 1.0f);
+        } else if(format == VertexFormat::Vector2) {
+            if(formats[i] == VertexFormat::Vector2ubNormalized)
+                maxError = quantizeAttribute(mesh.attribute<Vector2>(i), Containers::arrayCast<Vector2ub>(data), Vector2{}, 1.0f);
+            else
+                maxError = quantizeAttribute(mesh.attribute<Vector2>(i), Containers::arrayCast<Vector2us>(data), Vector2{}, 1.0f);
+        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+        if(verbose)
+            Debug{} << "Trade::GltfSceneConverter::add(): quantized" << mesh.attributeName(i) << "to" << formats[i] << "with a max error of" << maxError;
+    }
+
+    if(mesh.isIndexed())
+        return MeshData{mesh.primitive(), {}, mesh.indexData(), MeshIndexData{mesh.indices()}, Utility::move(vertexData), Utility::move(attributeData), mesh.vertexCount()};
+    return MeshData{mesh.primitive(), Utility::move(vertexData), Utility::move(attributeData), mesh.vertexCount()};
+}
+
+}
+
+bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& originalMesh, const Containers::StringView name) {
+    /* Quantize float attributes first, if requested, and then export the
+       quantized mesh instead */
+    Containers::Optional<MeshData> quantizedMesh;
+    Containers::Optional<Containers::Pair<Vector3, Float>> dequantization;
+    if(configuration().value<bool>("quantize")) {
+        const UnsignedInt positionBits = configuration().value<UnsignedInt>("quantizePositionBits");
+        const UnsignedInt normalBits = configuration().value<UnsignedInt>("quantizeNormalBits");
+        const UnsignedInt textureCoordinateBits = configuration().value<UnsignedInt>("quantizeTextureCoordinateBits");
+        if((positionBits != 8 && positionBits != 16) ||
+           (normalBits != 8 && normalBits != 16) ||
+           (textureCoordinateBits != 8 && textureCoordinateBits != 16)) {
+            Error{} << "Trade::GltfSceneConverter::add(): expected quantization bit depth to be 8 or 16 but got" << positionBits << Debug::nospace << "," << normalBits << "and" << textureCoordinateBits << "for positions, normals and texture coordinates";
+            return {};
+        }
+
+        quantizedMesh = quantizeMesh(originalMesh, positionBits, normalBits, textureCoordinateBits, dequantization, bool(flags() & SceneConverterFlag::Verbose));
+    }
+    const MeshData& mesh = quantizedMesh ? *quantizedMesh : originalMesh;
+
     /* Check and convert mesh primitive */
     /** @todo check primitive count according to the spec */
     Int gltfMode;
@@ -1866,6 +2423,34 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
         }
     }
 
+    /* Decide what gets compressed with EXT_meshopt_compression. The codecs
+       can only handle 16- and 32-bit indices and vertex strides that are a
+       multiple of four and at most 256 bytes, everything else is saved
+       uncompressed. The index codecs additionally need to know the vertex
+       count, so attribute-less meshes aren't compressed either. */
+    bool meshoptCompressIndices = false;
+    bool meshoptCompressVertices = false;
+    if(configuration().value<bool>("meshoptCompression")) {
+        #ifndef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+        Error{} << "Trade::GltfSceneConverter::add(): EXT_meshopt_compression requested but the plugin was built without meshoptimizer";
+        return {};
+        #else
+        meshoptCompressIndices = mesh.isIndexed() && mesh.indexCount() && mesh.vertexCount() && mesh.indexType() != MeshIndexType::UnsignedByte;
+        meshoptCompressVertices = mesh.vertexCount() && bufferViewOffset;
+        for(const Containers::Pair<std::size_t, std::size_t> bufferView: bufferViews.prefix(bufferViewOffset)) {
+            if(bufferView.second() % 4 || bufferView.second() > 256) {
+                if(flags() & SceneConverterFlag::Verbose)
+                    Debug{} << "Trade::GltfSceneConverter::add(): vertex stride" << bufferView.second() << "can't be compressed with EXT_meshopt_compression, saving vertex data uncompressed";
+                meshoptCompressVertices = false;
+                break;
+            }
+        }
+        #endif
+    }
+
+    /* Whether to reuse buffer views and accessors with identical contents */
+    const bool deduplicate = configuration().value<bool>("deduplicate");
+
     /* At this point we're sure nothing will fail so we can start writing the
        JSON. Otherwise we'd end up with a partly-written JSON in case of an
        unsupported mesh, corruputing the output. */
@@ -1881,20 +2466,30 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
 
     CORRADE_INTERNAL_ASSERT(_state->meshes.size() == id);
     MeshProperties& meshProperties = arrayAppend(_state->meshes, InPlaceInit);
+    meshProperties.dequantization = dequantization;
     {
         /* Index view and accessor if the mesh is indexed */
         if(mesh.isIndexed()) {
+            /* If the indices get compressed, the uncompressed data go into the
+               fallback buffer instead */
+            Containers::Array<char>& indexBuffer = meshoptCompressIndices ?
+                _state->meshoptFallbackBuffer : _state->buffer;
+
             /* § 3.6.2.4 requires that "the offset of an accessor [...] MUST be
                a multiple of the size of the accessor’s component type". The
                byteOffset could be something else for example if there's
                (unaligned) image data preceding it. */
+            const std::size_t indexTypeSize = meshIndexTypeSize(mesh.indexType());
+            const std::size_t indexBufferSize = indexBuffer.size();
+            /* Offset of the in-memory data in case they're being streamed */
+            const std::size_t indexBufferOffset = meshoptCompressIndices ?
+                0 : _state->bufferStreamSize;
             {
-                const std::size_t indexTypeSize = meshIndexTypeSize(mesh.indexType());
-                const std::size_t padding = indexTypeSize*((_state->buffer.size() + indexTypeSize - 1)/indexTypeSize) - _state->buffer.size();
+                const std::size_t padding = indexTypeSize*((indexBuffer.size() + indexTypeSize - 1)/indexTypeSize) - indexBuffer.size();
                 CORRADE_INTERNAL_ASSERT(padding <= 3);
                 /** @todo any better API for this? Utility::fill()? this is
                     silly */
-                for(char& i: arrayAppend(_state->buffer, NoInit, padding))
+                for(char& i: arrayAppend(indexBuffer, NoInit, padding))
                     i = '\0';
             }
 
@@ -1902,141 +2497,287 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
                padding before and after */
             /** @todo or put the whole thing there, consistently with
                 vertexData()? */
-            const Containers::ArrayView<char> indexData = arrayAppend(_state->buffer, mesh.indices().asContiguous());
-
-            const std::size_t gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
-            const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
-            _state->gltfBufferViews
-                .writeKey("buffer"_s).write(0)
-                /** @todo could be omitted if zero, is that useful for anything? */
-                .writeKey("byteOffset"_s).write(indexData - _state->buffer)
-                .writeKey("byteLength"_s).write(indexData.size())
-                .writeKey("target"_s).write(Implementation::GltfTargetHintElementArray);
-            if(configuration().value<bool>("accessorNames"))
-                _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
-                    name ? "mesh {0} ({1}) indices" : "mesh {0} indices",
-                    id, name));
+            const Containers::ArrayView<char> indexData = arrayAppend(indexBuffer, mesh.indices().asContiguous());
+
+            #ifdef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+            /* Compress the indices already before the deduplication below, as
+               the triangle codec may rotate vertices in each triangle. The
+               data are decoded back to make the fallback match what decoders
+               produce, and the deduplication then has to both look up and
+               remember the data in this rotated form. */
+            bool meshoptTriangles = false;
+            Containers::Array<char> meshoptCompressedIndices;
+            std::size_t meshoptCompressedIndexSize = 0;
+            if(meshoptCompressIndices) {
+                /* Triangle lists can use the more efficient triangle codec,
+                   everything else is compressed as an index sequence */
+                meshoptTriangles = mesh.primitive() == MeshPrimitive::Triangles && mesh.indexCount() % 3 == 0;
+                /* The codecs take only 32-bit indices */
+                const Containers::Array<UnsignedInt> indices = mesh.indicesAsArray();
+
+                const std::size_t compressedBound = meshoptTriangles ?
+                    meshopt_encodeIndexBufferBound(indices.size(), mesh.vertexCount()) :
+                    meshopt_encodeIndexSequenceBound(indices.size(), mesh.vertexCount());
+                meshoptCompressedIndices = Containers::Array<char>{NoInit, compressedBound};
+                unsigned char* const compressed = reinterpret_cast<unsigned char*>(meshoptCompressedIndices.data());
+                meshoptCompressedIndexSize = meshoptTriangles ?
+                    meshopt_encodeIndexBuffer(compressed, compressedBound, indices.data(), indices.size()) :
+                    meshopt_encodeIndexSequence(compressed, compressedBound, indices.data(), indices.size());
+                CORRADE_INTERNAL_ASSERT(meshoptCompressedIndexSize);
+
+                if(meshoptTriangles)
+                    CORRADE_INTERNAL_ASSERT_OUTPUT(meshopt_decodeIndexBuffer(indexData.data(), indices.size(), indexTypeSize, compressed, meshoptCompressedIndexSize) == 0);
+            }
+            #endif
+
+            /* If the same index data were written already, reuse the buffer
+               view and drop the data again. The index type and count are
+               checked by the accessor below. */
+            const Containers::String indexBufferViewProperties = deduplicate ?
+                Utility::format("indices {} {} {}", indexTypeSize, Int(meshoptCompressIndices), meshoptCompressIndices ? UnsignedInt(mesh.primitive()) : 0u) : Containers::String{};
+            const Int deduplicatedIndexBufferView = deduplicate ?
+                _state->deduplication.findBufferView(meshoptCompressIndices, indexBuffer, indexBufferOffset, _state->bufferStreamFilename, indexData, indexBufferViewProperties) : -1;
+            std::size_t gltfBufferViewIndex;
+            if(deduplicatedIndexBufferView != -1) {
+                arrayRemoveSuffix(indexBuffer, indexBuffer.size() - indexBufferSize);
+                gltfBufferViewIndex = std::size_t(deduplicatedIndexBufferView);
+            } else {
+                gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
+                const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+                _state->gltfBufferViews
+                    /* The fallback buffer is always the second one */
+                    .writeKey("buffer"_s).write(meshoptCompressIndices ? 1 : 0)
+                    /** @todo could be omitted if zero, is that useful for
+                        anything? */
+                    .writeKey("byteOffset"_s).write(indexBufferOffset + (indexData - indexBuffer))
+                    .writeKey("byteLength"_s).write(indexData.size())
+                    .writeKey("target"_s).write(Implementation::GltfTargetHintElementArray);
+                if(configuration().value<bool>("accessorNames"))
+                    _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                        name ? "mesh {0} ({1}) indices" : "mesh {0} indices",
+                        id, name));
+
+                #ifdef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+                if(meshoptCompressIndices) {
+                    /* Compressed data are appended to the main buffer,
+                       four-byte aligned to be consistent with other buffer
+                       views */
+                    const std::size_t padding = 4*((_state->buffer.size() + 3)/4) - _state->buffer.size();
+                    for(char& i: arrayAppend(_state->buffer, NoInit, padding))
+                        i = '\0';
+                    const std::size_t compressedOffset = _state->bufferStreamSize + _state->buffer.size();
+                    arrayAppend(_state->buffer, meshoptCompressedIndices.prefix(meshoptCompressedIndexSize));
+
+                    writeMeshoptCompression(_state->gltfBufferViews, compressedOffset, meshoptCompressedIndexSize, indexTypeSize, mesh.indexCount(), meshoptTriangles ? "TRIANGLES"_s : "INDICES"_s);
+                }
+                #endif
 
-            const std::size_t gltfAccessorIndex = _state->gltfAccessors.currentArraySize();
-            const Containers::ScopeGuard gltfAccessor = _state->gltfAccessors.beginObjectScope();
-            _state->gltfAccessors
-                .writeKey("bufferView"_s).write(gltfBufferViewIndex)
-                /* bufferOffset is implicitly 0 */
-                .writeKey("componentType"_s).write(gltfIndexType)
-                .writeKey("count"_s).write(mesh.indexCount())
-                .writeKey("type"_s).write("SCALAR"_s);
-            if(configuration().value<bool>("accessorNames"))
-                _state->gltfAccessors.writeKey("name"_s).write(Utility::format(
-                    name ? "mesh {0} ({1}) indices" : "mesh {0} indices",
-                    id, name));
+                if(deduplicate)
+                    _state->deduplication.addBufferView(meshoptCompressIndices, indexBuffer, indexBufferOffset, indexData, indexBufferViewProperties, gltfBufferViewIndex);
+            }
 
-            meshProperties.gltfIndices = gltfAccessorIndex;
+            /* Same for the accessor */
+            const Containers::String indexAccessorProperties = deduplicate ?
+                Utility::format("{} 0 {} 0 {} SCALAR", gltfBufferViewIndex, gltfIndexType, mesh.indexCount()) : Containers::String{};
+            const Int deduplicatedIndexAccessor = deduplicate ?
+                _state->deduplication.findAccessor(indexAccessorProperties) : -1;
+            if(deduplicatedIndexAccessor != -1) {
+                meshProperties.gltfIndices = UnsignedInt(deduplicatedIndexAccessor);
+            } else {
+                const std::size_t gltfAccessorIndex = _state->gltfAccessors.currentArraySize();
+                if(deduplicate)
+                    _state->deduplication.addAccessor(indexAccessorProperties, gltfAccessorIndex);
+                const Containers::ScopeGuard gltfAccessor = _state->gltfAccessors.beginObjectScope();
+                _state->gltfAccessors
+                    .writeKey("bufferView"_s).write(gltfBufferViewIndex)
+                    /* bufferOffset is implicitly 0 */
+                    .writeKey("componentType"_s).write(gltfIndexType)
+                    .writeKey("count"_s).write(mesh.indexCount())
+                    .writeKey("type"_s).write("SCALAR"_s);
+                if(configuration().value<bool>("accessorNames"))
+                    _state->gltfAccessors.writeKey("name"_s).write(Utility::format(
+                        name ? "mesh {0} ({1}) indices" : "mesh {0} indices",
+                        id, name));
+
+                meshProperties.gltfIndices = gltfAccessorIndex;
+            }
         }
 
+        /* If the vertices get compressed, the uncompressed data go into the
+           fallback buffer instead */
+        Containers::Array<char>& vertexBuffer = meshoptCompressVertices ?
+            _state->meshoptFallbackBuffer : _state->buffer;
+
         /* § 3.6.2.4 requires that "For performance and compatibility reasons,
            [...] accessor.byteOffset and bufferView.byteStride MUST be
            multiples of 4". The byteOffset could be something else for example
            if there's (unaligned) image data preceding it, or an odd number of
            8- or 16-bit indices. Pad the buffer appropriately. */
         /** @todo enforce also 4-byte-aligned stride */
+        const std::size_t vertexBufferSize = vertexBuffer.size();
+        const std::size_t vertexBufferOffset = meshoptCompressVertices ?
+            0 : _state->bufferStreamSize;
         {
-            const std::size_t padding = 4*((_state->buffer.size() + 3)/4) - _state->buffer.size();
+            const std::size_t padding = 4*((vertexBuffer.size() + 3)/4) - vertexBuffer.size();
             CORRADE_INTERNAL_ASSERT(padding <= 3);
             /** @todo any better API for this? Utility::fill()? this is silly */
-            for(char& i: arrayAppend(_state->buffer, NoInit, padding))
+            for(char& i: arrayAppend(vertexBuffer, NoInit, padding))
                 i = '\0';
         }
 
         /* Vertex data, plus any padding after. The view needs to include also
            the padding so it can get sliced to strided views without asserts. */
-        Containers::ArrayView<char> vertexData = arrayAppend(_state->buffer, NoInit, mesh.vertexData().size() + vertexBufferPadding);
+        Containers::ArrayView<char> vertexData = arrayAppend(vertexBuffer, NoInit, mesh.vertexData().size() + vertexBufferPadding);
         Utility::copy(mesh.vertexData(), vertexData.prefix(mesh.vertexData().size()));
         /** @todo any better API for this? Utility::fill()? this is silly */
         for(char& i: vertexData.exceptPrefix(mesh.vertexData().size()))
             i = '\0';
 
+        /* Flip texture coordinates unless they're meant to be flipped in the
+           material. Done before writing the buffer views so the compressed
+           data, if any, contain the flipped values as well. */
+        if(!configuration().value<bool>("textureCoordinateYFlipInMaterial")) for(const GltfAttribute& gltfAttribute: gltfAttributes) {
+            if(mesh.attributeName(gltfAttribute.originalId) != MeshAttribute::TextureCoordinates)
+                continue;
+
+            const VertexFormat format = mesh.attributeFormat(gltfAttribute.originalId);
+            CORRADE_INTERNAL_ASSERT(gltfAttribute.offset == 0);
+            Containers::StridedArrayView1D<char> data{vertexData,
+                vertexData + mesh.attributeOffset(gltfAttribute.originalId),
+                mesh.vertexCount(), mesh.attributeStride(gltfAttribute.originalId)};
+            if(format == VertexFormat::Vector2)
+                for(auto& c: Containers::arrayCast<Vector2>(data))
+                    c.y() = 1.0f - c.y();
+            else if(format == VertexFormat::Vector2ubNormalized)
+                for(auto& c: Containers::arrayCast<Vector2ub>(data))
+                    c.y() = 255 - c.y();
+            else if(format == VertexFormat::Vector2usNormalized)
+                for(auto& c: Containers::arrayCast<Vector2us>(data))
+                    c.y() = 65535 - c.y();
+            /* Other formats are not possible to flip, and thus have to be
+               flipped in the material instead. This was already checked at
+               the top, failing if textureCoordinateYFlipInMaterial isn't set
+               for those formats, so it should never get here. */
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
         /* Remember the base buffer view index to which `bufferViewAssignments`
            are relative to. If there are no buffer views, the buffer view
            array might not even be opened yet. There are also no attributes in
            that case, thus use a deliberately wrong value to catch accidental
            access. */
-        const std::size_t gltfBaseBufferViewIndex = bufferViewOffset ?
+        std::size_t gltfBaseBufferViewIndex = bufferViewOffset ?
             _state->gltfBufferViews.currentArraySize() : ~std::size_t{};
 
-        /* Write buffer views (minOffset, maxOffset, stride) */
-        for(const Containers::Pair<std::size_t, std::size_t> bufferView: bufferViews.prefix(bufferViewOffset)) {
-            const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
-
-            _state->gltfBufferViews
-                .writeKey("buffer"_s).write(0)
-                /* Byte offset could be omitted if zero but since that
-                   happens only for the very first view in a buffer and we
-                   have always at most one buffer, the minimal savings are
-                   not worth the inconsistency */
-                .writeKey("byteOffset"_s).write(vertexData - _state->buffer + bufferView.first())
-                .writeKey("byteLength"_s).write(mesh.vertexCount()*bufferView.second())
-                /* Byte stride could be omitted if there would be just one
-                   tightly packed accessor (in which case it'd be implicitly
-                   treated as tightly packed, same as in GL). Tracking count of
-                   accessors assigned to each view and then also maintaining an
-                   info about whether the single accessor is tightly-packed is
-                   a lot of extra work and the gains from being able to
-                   omit byteStride are dubious.
-
-                   It could be somewhat doable by just tracking count of
-                   strided accessors to each buffer view and omitting
-                   byteStride if there's 0, but this would omit byteStride also
-                   if there's multiple tightly-packed accessors (for example,
-                   for an aliased attribute) and § 3.6.2.4 disallows that:
-                   "When two or more vertex attribute accessors use the same
-                   bufferView, its byteStride MUST be defined." */
-                /** @todo if vertex count is zero, this value is higher than
-                    byteLength, is that a problem? glTF explicitly disallows
-                    byteLength == 0 so this is uncharted waters anyway :D */
-                .writeKey("byteStride"_s).write(bufferView.second())
-                .writeKey("target"_s).write(Implementation::GltfTargetHintArray);
-
-            if(configuration().value<bool>("accessorNames"))
-                _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
-                    name ? "mesh {0} ({1}) vertices" : "mesh {0} vertices",
-                    id, name));
+        /* If the same vertex data with the same buffer view layout were
+           written already, reuse the buffer views and drop the data again */
+        Containers::String vertexBufferViewProperties;
+        Int deduplicatedVertexBufferView = -1;
+        if(deduplicate && bufferViewOffset) {
+            vertexBufferViewProperties = Utility::format("vertices {} {}", mesh.vertexCount(), Int(meshoptCompressVertices));
+            for(const Containers::Pair<std::size_t, std::size_t> bufferView: bufferViews.prefix(bufferViewOffset))
+                vertexBufferViewProperties = vertexBufferViewProperties + Utility::format(" {}:{}", bufferView.first(), bufferView.second());
+            deduplicatedVertexBufferView = _state->deduplication.findBufferView(meshoptCompressVertices, vertexBuffer, vertexBufferOffset, _state->bufferStreamFilename, vertexData, vertexBufferViewProperties);
+        }
+        if(deduplicatedVertexBufferView != -1) {
+            arrayRemoveSuffix(vertexBuffer, vertexBuffer.size() - vertexBufferSize);
+            gltfBaseBufferViewIndex = std::size_t(deduplicatedVertexBufferView);
+        } else {
+            if(deduplicate && bufferViewOffset)
+                _state->deduplication.addBufferView(meshoptCompressVertices, vertexBuffer, vertexBufferOffset, vertexData, vertexBufferViewProperties, gltfBaseBufferViewIndex);
+
+            /* Write buffer views (minOffset, maxOffset, stride) */
+            for(const Containers::Pair<std::size_t, std::size_t> bufferView: bufferViews.prefix(bufferViewOffset)) {
+                const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+
+                _state->gltfBufferViews
+                    /* The fallback buffer is always the second one */
+                    .writeKey("buffer"_s).write(meshoptCompressVertices ? 1 : 0)
+                    /* Byte offset could be omitted if zero but since that
+                       happens only for the very first view in a buffer and we
+                       have always at most one buffer, the minimal savings are
+                       not worth the inconsistency */
+                    .writeKey("byteOffset"_s).write(vertexBufferOffset + (vertexData - vertexBuffer) + bufferView.first())
+                    .writeKey("byteLength"_s).write(mesh.vertexCount()*bufferView.second())
+                    /* Byte stride could be omitted if there would be just
+                       one tightly packed accessor (in which case it'd be
+                       implicitly treated as tightly packed, same as in GL).
+                       Tracking count of accessors assigned to each view and
+                       then also maintaining an info about whether the single
+                       accessor is tightly-packed is a lot of extra work and
+                       the gains from being able to omit byteStride are
+                       dubious.
+
+                       It could be somewhat doable by just tracking count of
+                       strided accessors to each buffer view and omitting
+                       byteStride if there's 0, but this would omit byteStride
+                       also if there's multiple tightly-packed accessors (for
+                       example, for an aliased attribute) and § 3.6.2.4
+                       disallows that: "When two or more vertex attribute
+                       accessors use the same bufferView, its byteStride MUST
+                       be defined." */
+                    /** @todo if vertex count is zero, this value is higher than
+                        byteLength, is that a problem? glTF explicitly disallows
+                        byteLength == 0 so this is uncharted waters anyway :D */
+                    .writeKey("byteStride"_s).write(bufferView.second())
+                    .writeKey("target"_s).write(Implementation::GltfTargetHintArray);
+
+                if(configuration().value<bool>("accessorNames"))
+                    _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                        name ? "mesh {0} ({1}) vertices" : "mesh {0} vertices",
+                        id, name));
+
+                #ifdef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+                if(meshoptCompressVertices) {
+                    /* Compressed data are appended to the main buffer,
+                       four-byte aligned to be consistent with other buffer
+                       views. The vertex data are in the fallback buffer so
+                       this doesn't invalidate the view. */
+                    const std::size_t padding = 4*((_state->buffer.size() + 3)/4) - _state->buffer.size();
+                    for(char& i: arrayAppend(_state->buffer, NoInit, padding))
+                        i = '\0';
+                    const std::size_t compressedOffset = _state->bufferStreamSize + _state->buffer.size();
+                    const std::size_t compressedBound = meshopt_encodeVertexBufferBound(mesh.vertexCount(), bufferView.second());
+                    unsigned char* const compressed = reinterpret_cast<unsigned char*>(arrayAppend(_state->buffer, NoInit, compressedBound).data());
+                    const std::size_t compressedSize = meshopt_encodeVertexBuffer(compressed, compressedBound, vertexData + bufferView.first(), mesh.vertexCount(), bufferView.second());
+                    CORRADE_INTERNAL_ASSERT(compressedSize);
+                    arrayRemoveSuffix(_state->buffer, compressedBound - compressedSize);
+
+                    writeMeshoptCompression(_state->gltfBufferViews, compressedOffset, compressedSize, bufferView.second(), mesh.vertexCount(), "ATTRIBUTES"_s);
+                }
+                #endif
+            }
         }
 
         /* Attribute views and accessors */
         for(const GltfAttribute& gltfAttribute: gltfAttributes) {
             const MeshAttribute attributeName = mesh.attributeName(gltfAttribute.originalId);
             const VertexFormat format = mesh.attributeFormat(gltfAttribute.originalId);
-
-            /* Flip texture coordinates unless they're meant to be flipped in
-               the material */
-            if(attributeName == MeshAttribute::TextureCoordinates && !configuration().value<bool>("textureCoordinateYFlipInMaterial")) {
-                CORRADE_INTERNAL_ASSERT(gltfAttribute.offset == 0);
-                Containers::StridedArrayView1D<char> data{vertexData,
-                    vertexData + mesh.attributeOffset(gltfAttribute.originalId),
-                    mesh.vertexCount(), mesh.attributeStride(gltfAttribute.originalId)};
-                if(format == VertexFormat::Vector2)
-                    for(auto& c: Containers::arrayCast<Vector2>(data))
-                        c.y() = 1.0f - c.y();
-                else if(format == VertexFormat::Vector2ubNormalized)
-                    for(auto& c: Containers::arrayCast<Vector2ub>(data))
-                        c.y() = 255 - c.y();
-                else if(format == VertexFormat::Vector2usNormalized)
-                    for(auto& c: Containers::arrayCast<Vector2us>(data))
-                        c.y() = 65535 - c.y();
-                /* Other formats are not possible to flip, and thus have to be
-                   flipped in the material instead. This was already checked
-                   at the top, failing if textureCoordinateYFlipInMaterial
-                   isn't set for those formats, so it should never get here. */
-                else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            const std::size_t gltfBufferViewIndex = gltfBaseBufferViewIndex + bufferViewAssignments[gltfAttribute.originalId];
+            const std::size_t gltfByteOffset = mesh.attributeOffset(gltfAttribute.originalId) + gltfAttribute.offset - bufferViews[bufferViewAssignments[gltfAttribute.originalId]].first();
+
+            /* If an accessor with the same properties was written already,
+               reuse it. The min/max bounds are implied by the buffer view
+               contents. */
+            Containers::String accessorProperties;
+            if(deduplicate) {
+                accessorProperties = Utility::format("{} {} {} {} {} {}", gltfBufferViewIndex, gltfByteOffset, gltfAttribute.accessorComponentType, Int(isVertexFormatNormalized(format)), mesh.vertexCount(), gltfAttribute.accessorType);
+                const Int deduplicatedAccessor = _state->deduplication.findAccessor(accessorProperties);
+                if(deduplicatedAccessor != -1) {
+                    arrayAppend(meshProperties.gltfAttributes, InPlaceInit, gltfAttribute.name, UnsignedInt(deduplicatedAccessor));
+                    continue;
+                }
             }
 
             const UnsignedInt gltfAccessorIndex = _state->gltfAccessors.currentArraySize();
+            if(deduplicate)
+                _state->deduplication.addAccessor(accessorProperties, gltfAccessorIndex);
             const Containers::ScopeGuard gltfAccessor = _state->gltfAccessors.beginObjectScope();
             _state->gltfAccessors
-                .writeKey("bufferView"_s).write(gltfBaseBufferViewIndex + bufferViewAssignments[gltfAttribute.originalId]);
+                .writeKey("bufferView"_s).write(gltfBufferViewIndex);
             /* Write byteOffset only if non-zero. Compared to byteStride in the
                buffer view above, this is easy to do, so why not. */
-            if(const std::size_t gltfByteOffset = mesh.attributeOffset(gltfAttribute.originalId) + gltfAttribute.offset - bufferViews[bufferViewAssignments[gltfAttribute.originalId]].first())
+            if(gltfByteOffset)
                 _state->gltfAccessors.writeKey("byteOffset"_s).write(gltfByteOffset);
             _state->gltfAccessors
                 .writeKey("componentType"_s).write(gltfAttribute.accessorComponentType);
@@ -2103,6 +2844,9 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const MeshData& mesh, const
 
     if(name) meshProperties.gltfName = name;
 
+    /* If streaming, write the mesh data to the file right away */
+    flushBuffer(false);
+
     return true;
 }
 
@@ -3219,6 +3963,9 @@ bool GltfSceneConverter::doAdd(CORRADE_UNUSED const UnsignedInt id, const Textur
 
             Containers::StringView textureExtensionString;
             switch(textureExtension) {
+                case GltfExtension::ExtTextureWebp:
+                    textureExtensionString = "EXT_texture_webp"_s;
+                    break;
                 case GltfExtension::KhrTextureBasisu:
                     textureExtensionString = "KHR_texture_basisu"_s;
                     break;
@@ -3228,6 +3975,7 @@ bool GltfSceneConverter::doAdd(CORRADE_UNUSED const UnsignedInt id, const Textur
                     textureExtensionString = "KHR_texture_ktx"_s;
                     break;
                 /* LCOV_EXCL_START */
+                case GltfExtension::ExtMeshoptCompression:
                 case GltfExtension::KhrMaterialsUnlit:
                 case GltfExtension::KhrMaterialsClearCoat:
                 case GltfExtension::KhrMeshQuantization:
@@ -3303,36 +4051,69 @@ Containers::Pointer<AbstractImageConverter> loadAndInstantiateImageConverter(Plu
     return imageConverter;
 }
 
+template<UnsignedInt dimensions> ImageData<dimensions> copyImage(const ImageData<dimensions>& image) {
+    Containers::Array<char> data{NoInit, image.data().size()};
+    Utility::copy(image.data(), data);
+    if(image.isCompressed())
+        return ImageData<dimensions>{image.compressedStorage(), image.compressedFormat(), image.size(), Utility::move(data), image.flags()};
+    return ImageData<dimensions>{image.storage(), image.format(), image.formatExtra(), image.pixelSize(), image.size(), Utility::move(data), image.flags()};
+}
+
+void setQueuedImage(QueuedImage& queued, const ImageData2D& image) {
+    queued.image2D = copyImage(image);
+}
+
+void setQueuedImage(QueuedImage& queued, const ImageData3D& image) {
+    queued.image3D = copyImage(image);
+}
+
+/* Called from worker threads, so it should touch only the queued image
+   itself */
+bool convertQueuedImage(QueuedImage& queued) {
+    if(queued.filename) return queued.image2D ?
+        queued.imageConverter->convertToFile(*queued.image2D, queued.filename) :
+        queued.imageConverter->convertToFile(*queued.image3D, queued.filename);
+
+    queued.data = queued.image2D ?
+        queued.imageConverter->convertToData(*queued.image2D) :
+        queued.imageConverter->convertToData(*queued.image3D);
+    return !!queued.data;
+}
+
+}
+
+Containers::String GltfSceneConverter::externalImageFilename(const UnsignedInt id, AbstractImageConverter& imageConverter) {
+    /* All existing image converters that return a MIME type return an
+       extension as well, so we can (currently) get away with an assert.
+       Might need to be revisited eventually. */
+    const Containers::String extension = imageConverter.extension();
+    CORRADE_INTERNAL_ASSERT(extension);
+
+    if(!_state->filename) {
+        Error{} << "Trade::GltfSceneConverter::add(): can only write a glTF with external images if converting to a file";
+        return {};
+    }
+
+    return Utility::format("{}.{}.{}",
+        Utility::Path::splitExtension(*_state->filename).first(),
+        id,
+        extension);
 }
 
 template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(const UnsignedInt id, const Containers::StringView name, AbstractImageConverter& imageConverter, const ImageData<dimensions>& image, bool bundleImages) {
     /* Only one of these two is filled */
-    Containers::ArrayView<char> imageData;
+    Containers::Optional<Containers::Array<char>> imageData;
     Containers::String imageFilename;
     if(bundleImages) {
-        const Containers::Optional<Containers::Array<char>> out = imageConverter.convertToData(image);
-        if(!out) {
+        imageData = imageConverter.convertToData(image);
+        if(!imageData) {
             Error{} << "Trade::GltfSceneConverter::add(): can't convert an image";
             return {};
         }
-
-        imageData = arrayAppend(_state->buffer, *out);
     } else {
-        /* All existing image converters that return a MIME type return an
-           extension as well, so we can (currently) get away with an assert.
-           Might need to be revisited eventually. */
-        const Containers::String extension = imageConverter.extension();
-        CORRADE_INTERNAL_ASSERT(extension);
-
-        if(!_state->filename) {
-            Error{} << "Trade::GltfSceneConverter::add(): can only write a glTF with external images if converting to a file";
+        imageFilename = externalImageFilename(id, imageConverter);
+        if(!imageFilename)
             return {};
-        }
-
-        imageFilename = Utility::format("{}.{}.{}",
-            Utility::Path::splitExtension(*_state->filename).first(),
-            id,
-            extension);
 
         if(!imageConverter.convertToFile(image, imageFilename)) {
             Error{} << "Trade::GltfSceneConverter::add(): can't convert an image file";
@@ -3343,7 +4124,30 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
     /* At this point we're sure nothing will fail so we can start writing the
        JSON. Otherwise we'd end up with a partly-written JSON in case of an
        unsupported mesh, corruputing the output. */
+    writeImage(id, name, imageConverter, imageData ? Containers::arrayView(*imageData) : nullptr, imageFilename, configuration().value<bool>("accessorNames"), configuration().value<bool>("deduplicate"));
+    return true;
+}
+
+template<UnsignedInt dimensions> bool GltfSceneConverter::queueImage(const UnsignedInt id, const Containers::StringView name, Containers::Pointer<AbstractImageConverter>&& imageConverter, const ImageData<dimensions>& image, bool bundleImages) {
+    /* Check that external images can be written already here so the error
+       is reported from the add() that caused it */
+    Containers::String filename;
+    if(!bundleImages && !(filename = externalImageFilename(id, *imageConverter)))
+        return {};
+
+    QueuedImage& queued = arrayAppend(_state->queuedImages, InPlaceInit);
+    queued.id = id;
+    queued.name = Containers::String::nullTerminatedGlobalView(name);
+    queued.filename = Utility::move(filename);
+    queued.imageConverter = Utility::move(imageConverter);
+    queued.accessorNames = configuration().value<bool>("accessorNames");
+    queued.deduplicate = configuration().value<bool>("deduplicate");
+    queued.converted = false;
+    setQueuedImage(queued, image);
+    return true;
+}
 
+void GltfSceneConverter::writeImage(const UnsignedInt id, const Containers::StringView name, AbstractImageConverter& imageConverter, const Containers::ArrayView<const char> bundledData, const Containers::StringView filename, const bool accessorNames, const bool deduplicate) {
     /* If this is a first image, open the images array */
     if(_state->gltfImages.isEmpty())
         _state->gltfImages.beginArray();
@@ -3351,26 +4155,42 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
     const Containers::ScopeGuard gltfImage = _state->gltfImages.beginObjectScope();
 
     /* Bundled image, needs a buffer view and a MIME type */
-    if(bundleImages) {
+    if(!filename) {
         /* The caller should have already checked the MIME type is not empty */
         const Containers::String mimeType = imageConverter.mimeType();
         CORRADE_INTERNAL_ASSERT(mimeType);
 
-        /* If this is a first buffer view, open the buffer view array */
-        if(_state->gltfBufferViews.isEmpty())
-            _state->gltfBufferViews.beginArray();
+        /* If the same encoded image was bundled already, reference its
+           buffer view instead of appending the data again */
+        const Containers::String bufferViewProperties = deduplicate ?
+            "image "_s + mimeType : Containers::String{};
+        const Int deduplicatedBufferView = deduplicate ?
+            _state->deduplication.findBufferView(0, _state->buffer, _state->bufferStreamSize, _state->bufferStreamFilename, bundledData, bufferViewProperties) : -1;
+        std::size_t gltfBufferViewIndex;
+        if(deduplicatedBufferView != -1) {
+            gltfBufferViewIndex = std::size_t(deduplicatedBufferView);
+        } else {
+            const Containers::ArrayView<char> imageData = arrayAppend(_state->buffer, bundledData);
 
-        /* Reference the image data from a buffer view */
-        const std::size_t gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
-        const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
-        _state->gltfBufferViews
-            .writeKey("buffer"_s).write(0)
-            /** @todo could be omitted if zero, is that useful for anything? */
-            .writeKey("byteOffset"_s).write(imageData - _state->buffer)
-            .writeKey("byteLength"_s).write(imageData.size());
-        if(configuration().value<bool>("accessorNames"))
-            _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
-                name ? "image {0} ({1})" : "image {0}", id, name));
+            /* If this is a first buffer view, open the buffer view array */
+            if(_state->gltfBufferViews.isEmpty())
+                _state->gltfBufferViews.beginArray();
+
+            /* Reference the image data from a buffer view */
+            gltfBufferViewIndex = _state->gltfBufferViews.currentArraySize();
+            if(deduplicate)
+                _state->deduplication.addBufferView(0, _state->buffer, _state->bufferStreamSize, imageData, bufferViewProperties, gltfBufferViewIndex);
+            const Containers::ScopeGuard gltfBufferView = _state->gltfBufferViews.beginObjectScope();
+            _state->gltfBufferViews
+                .writeKey("buffer"_s).write(0)
+                /** @todo could be omitted if zero, is that useful for
+                    anything? */
+                .writeKey("byteOffset"_s).write(_state->bufferStreamSize + (imageData - _state->buffer))
+                .writeKey("byteLength"_s).write(imageData.size());
+            if(accessorNames)
+                _state->gltfBufferViews.writeKey("name"_s).write(Utility::format(
+                    name ? "image {0} ({1})" : "image {0}", id, name));
+        }
 
         /* Reference the buffer view from the image */
         _state->gltfImages
@@ -3382,12 +4202,84 @@ template<UnsignedInt dimensions> bool GltfSceneConverter::convertAndWriteImage(c
         /* Reference the file from the image. Writing just the filename as the
            two files are expected to be next to each other. */
         _state->gltfImages
-            .writeKey("uri"_s).write(Utility::Path::split(imageFilename).second());
+            .writeKey("uri"_s).write(Utility::Path::split(filename).second());
     }
 
     if(name)
         _state->gltfImages.writeKey("name"_s).write(name);
 
+    /* If streaming, write the image data to the file right away */
+    flushBuffer(false);
+}
+
+bool GltfSceneConverter::encodeQueuedImages() {
+    Containers::ArrayView<QueuedImage> queuedImages = _state->queuedImages;
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) {
+        threadCount = std::thread::hardware_concurrency();
+        if(flags() & SceneConverterFlag::Verbose)
+            Debug{} << "Trade::GltfSceneConverter::endData(): autodetected hardware concurrency to" << threadCount << "threads";
+    }
+
+    /* Each thread picks the next image from the queue until there's none
+       left. Nothing can be printed directly from the worker threads as the
+       output redirection is thread-local and the user-installed redirection
+       wouldn't be respected, and messages would be interleaved with other
+       threads. The output is thus captured for each image and printed below
+       in the order the images were added. */
+    std::atomic<std::size_t> next{0};
+    const auto encode = [&]() {
+        for(std::size_t i; (i = next++) < queuedImages.size(); ) {
+            QueuedImage& queued = queuedImages[i];
+            std::ostringstream debugOut, warningOut, errorOut;
+            {
+                Debug redirectOutput{&debugOut};
+                Warning redirectWarning{&warningOut};
+                Error redirectError{&errorOut};
+                queued.converted = convertQueuedImage(queued);
+            }
+            queued.debug = debugOut.str();
+            queued.warning = warningOut.str();
+            queued.error = errorOut.str();
+        }
+    };
+
+    /* The calling thread does its share of the work as well */
+    Containers::Array<std::thread> threads{Math::min(std::size_t(Math::max(threadCount, 1u)), queuedImages.size()) - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{encode};
+    encode();
+    for(std::thread& thread: threads)
+        thread.join();
+
+    /* Write the images in the order they were added, independently of the
+       order in which they finished encoding */
+    for(QueuedImage& queued: queuedImages) {
+        /* The relative order of debug, warning and error messages isn't
+           preserved, but that's the case for the separate output streams in
+           general as well */
+        if(queued.debug)
+            Debug{Debug::Flag::NoNewlineAtTheEnd} << queued.debug;
+        if(queued.warning)
+            Warning{Debug::Flag::NoNewlineAtTheEnd} << queued.warning;
+        if(queued.error)
+            Error{Debug::Flag::NoNewlineAtTheEnd} << queued.error;
+
+        if(!queued.converted) {
+            Error e;
+            e << "Trade::GltfSceneConverter::endData(): can't convert";
+            if(queued.image2D) e << "2D";
+            else e << "3D";
+            e << "image" << queued.id;
+            if(queued.filename) e << "to a file";
+            return {};
+        }
+
+        writeImage(queued.id, queued.name, *queued.imageConverter, queued.data ? Containers::arrayView(*queued.data) : nullptr, queued.filename, queued.accessorNames, queued.deduplicate);
+    }
+
+    _state->queuedImages = {};
     return true;
 }
 
@@ -3436,7 +4328,9 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, c
         extension = GltfExtension::KhrTextureBasisu;
     } else if(mimeType == "image/ktx2"_s && configuration().value<bool>("experimentalKhrTextureKtx")) {
         extension = GltfExtension::KhrTextureKtx;
-    /** @todo EXT_texture_webp and MSFT_texture_dds, once we have converters */
+    } else if(mimeType == "image/webp"_s) {
+        extension = GltfExtension::ExtTextureWebp;
+    /** @todo MSFT_texture_dds, once we have a converter */
     } else {
         if(!mimeType) {
             Error{} << "Trade::GltfSceneConverter::add():" << imageConverterPluginName << "doesn't specify any MIME type, can't save an image";
@@ -3455,13 +4349,19 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData2D& image, c
         extension = GltfExtension{};
     }
 
+    /* Images that are queued are written to the images array only in
+       doEndData(), so count them as well */
     const UnsignedInt gltfImageId = image2DCount() + image3DCount();
-    CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()));
+    CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()) + _state->queuedImages.size());
 
     /* If the image writing fails due to an error, don't add any extensions
        -- otherwise we'd blow up on the asserts below when adding the next
-       image */
-    if(!convertAndWriteImage(id, name, *imageConverter, image, bundleImages))
+       image. If any image got queued already, queue all following ones as
+       well to preserve the order. */
+    if(configuration().value<UnsignedInt>("threads") != 1 || !_state->queuedImages.isEmpty()) {
+        if(!queueImage(id, name, Utility::move(imageConverter), image, bundleImages))
+            return false;
+    } else if(!convertAndWriteImage(id, name, *imageConverter, image, bundleImages))
         return false;
 
     CORRADE_INTERNAL_ASSERT(_state->image2DIdsTextureExtensions.size() == id);
@@ -3526,13 +4426,19 @@ bool GltfSceneConverter::doAdd(const UnsignedInt id, const ImageData3D& image, c
         return {};
     }
 
+    /* Images that are queued are written to the images array only in
+       doEndData(), so count them as well */
     const UnsignedInt gltfImageId = image2DCount() + image3DCount();
-    CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()));
+    CORRADE_INTERNAL_ASSERT(gltfImageId == (_state->gltfImages.isEmpty() ? 0 : _state->gltfImages.currentArraySize()) + _state->queuedImages.size());
 
     /* If the image writing fails due to an error, don't add any extensions
        -- otherwise we'd blow up on the asserts below when adding the next
-       image */
-    if(!convertAndWriteImage(id, name, *imageConverter, image, bundleImages))
+       image. If any image got queued already, queue all following ones as
+       well to preserve the order. */
+    if(configuration().value<UnsignedInt>("threads") != 1 || !_state->queuedImages.isEmpty()) {
+        if(!queueImage(id, name, Utility::move(imageConverter), image, bundleImages))
+            return false;
+    } else if(!convertAndWriteImage(id, name, *imageConverter, image, bundleImages))
         return false;
 
     CORRADE_INTERNAL_ASSERT(_state->image3DIdsTextureExtensionsLayerCount.size() == id);
@@ -111,12 +111,53 @@ conversion warnings to be suppressed. Both @ref SceneConverterFlag::Quiet and
 @ref ImageConverterFlags and propagated to image converter plugins the
 converter delegates to.
 
+All binary data are by default accumulated in memory and written together
+with the JSON at the end. When converting to a file, the
+@cb{.ini} streamBuffer @ce
+@ref Trade-GltfSceneConverter-configuration "configuration option" makes the
+plugin write the data to the file at the end of each @ref add() instead. For a
+`*.glb` output the data go first to a temporary `*.glb.tmp` file next to it,
+which gets copied into the binary chunk and removed at the end, as the binary
+chunk has to come after the JSON. Peak memory use is then given by the
+largest mesh or image added instead of the whole scene. The only exception is
+the uncompressed `*.fallback.bin` buffer written if both the
+@cb{.ini} meshoptCompression @ce and @cb{.ini} meshoptCompressionFallback @ce
+options are enabled, which is always accumulated in memory and written at the
+end. A `*.glb` file is limited to 4 GB by the 32-bit sizes in its headers,
+conversion to a larger one fails at the end with an error, a text glTF with
+an external buffer has no such limit.
+
 @subsection Trade-GltfSceneConverter-behavior-meshes Mesh export
 
 -   The @ref MeshData is exported with its exact binary layout. Only padding
     before and after an index view is omitted, the vertex buffer is saved
     verbatim into the glTF buffer. The vertex buffer may get padded with zeros
     at the end to satisfy glTF buffer bounds requirements.
+-   If the @cb{.ini} deduplicate @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    enabled, index and vertex data that are byte-for-byte equal to data of a
+    previously added mesh, including the vertex buffer layout, reuse the
+    existing buffer views instead of being written again, and accessors with
+    equal properties are reused as well. The same is done for bundled images
+    that encode to the same data. With @ref SceneConverterFlag::Verbose
+    enabled, the count of reused buffer views and accessors together with the
+    amount of saved bytes is printed at the end.
+-   If the @cb{.ini} quantize @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    enabled, @ref VertexFormat::Vector3 positions and normals,
+    @ref VertexFormat::Vector4 tangents and @ref VertexFormat::Vector2 texture
+    coordinates in the @f$ [0, 1] @f$ range are converted to 8- or 16-bit
+    normalized formats based on the @cb{.ini} quantizePositionBits @ce,
+    @cb{.ini} quantizeNormalBits @ce and
+    @cb{.ini} quantizeTextureCoordinateBits @ce options, with
+    [KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_mesh_quantization/README.md)
+    being added to required extensions. The mesh is then saved as an
+    interleaved buffer with each attribute padded to four bytes. Positions are
+    scaled into a unit cube with a uniform scale, and the translation and scale
+    to undo this is written into a dedicated child node for each object that
+    references the mesh in a scene, which means the imported scene will have
+    additional objects. With @ref SceneConverterFlag::Verbose enabled, the
+    maximum absolute error of each quantized attribute is printed.
 -   @ref MeshPrimitive::Points, @relativeref{MeshPrimitive,Lines},
     @relativeref{MeshPrimitive,LineLoop},
     @relativeref{MeshPrimitive,LineStrip},
@@ -256,6 +297,24 @@ converter delegates to.
     that were not referenced by any scene are written at the end, without any
     material assignment.
 -   At the moment, alignment rules for vertex stride are not respected.
+-   If the plugin is built with [meshoptimizer](https://github.com/zeux/meshoptimizer)
+    and the @cb{.ini} meshoptCompression @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is
+    enabled, index and vertex buffer views are compressed using the
+    [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_meshopt_compression/README.md)
+    extension. Triangle index buffers use the triangle codec, which may rotate
+    vertex order in each triangle while preserving the winding, other index
+    buffers are compressed as index sequences. @ref MeshIndexType::UnsignedByte
+    indices and vertex data with a stride that isn't a multiple of four or is
+    larger than 256 bytes are saved uncompressed. Compressed data are put into
+    the main buffer and the extension is marked as required, unless the
+    @cb{.ini} meshoptCompressionFallback @ce option is enabled, in which case
+    uncompressed data are saved to an external `*.fallback.bin` file and the
+    extension is only marked as used. The meshoptimizer encoder codec
+    versions are a process-wide setting, the plugin sets them to the versions
+    required by the extension just once, in @ref initialize() when the plugin
+    is loaded. Code in the same process that uses meshoptimizer directly and
+    changes the versions afterwards affects the plugin output as well.
 -   In some cases it might happen that the official Khronos glTF validator
     will warn about `min` / `max` accessor bounds very slightly differing from
     the calculated values. This is a known issue due to the
@@ -280,11 +339,12 @@ converter delegates to.
     per-image basis.
 -   Core glTF supports only JPEG and PNG file formats. Basis-encoded KTX2 files
     can be saved with the [KHR_texture_basisu](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_texture_basisu/README.md) extension by
-    setting @cb{.ini} imageConverter=BasisKtxImageConverter @ce. The
-    [MSFT_texture_dds](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/MSFT_texture_dds/README.md)
-    and [EXT_texture_webp](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_texture_webp/README.md)
-    extensions are not exported because there's currently no image converter
-    capable of saving DDS and WebP files. Other formats (such as TGA,
+    setting @cb{.ini} imageConverter=BasisKtxImageConverter @ce. WebP files
+    can be saved with the [EXT_texture_webp](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/EXT_texture_webp/README.md)
+    extension by setting @cb{.ini} imageConverter=WebPImageConverter @ce.
+    The [MSFT_texture_dds](https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Vendor/MSFT_texture_dds/README.md)
+    extension is not exported because there's currently no image converter
+    capable of saving DDS files. Other formats (such as TGA,
     OpenEXR...) are not supported by the spec but @ref GltfImporter supports
     them and they can be exported if the @cb{.ini} strict
     @ce @ref Trade-GltfSceneConverter-configuration "configuration option"
@@ -301,6 +361,16 @@ converter delegates to.
     @ref Trade-GltfSceneConverter-configuration "configuration option" is
     enabled.
 -   The texture is required to only be added after all images it references
+-   By default, images are encoded right in the @ref add() call. If the
+    @cb{.ini} threads @ce
+    @ref Trade-GltfSceneConverter-configuration "configuration option" is set
+    to a value other than @cpp 1 @ce, images are instead copied, queued and
+    encoded in parallel on given count of threads (or all hardware threads if
+    @cpp 0 @ce) at the end of the conversion, with the output preserving the
+    order in which they were added. Failures are then reported only from
+    @ref endFile() / @ref endData(), which also prints all messages from
+    the image converters, again in the order in which the images were
+    added.
 -   At the moment, there's no support for exporting multi-level images even
     though the KTX2 container is capable of storing these.
 
@@ -472,8 +542,10 @@ the plugin supports also 3D images and 2D array textures using a proposed
 -   The scene is required to only be added after all meshes and materials it
     references
 -   Multiple @ref SceneField::Mesh and @ref SceneField::MeshMaterial entries
-    per object are turned into multi-mesh primitives. Other duplicate builtin
-    fields are ignored with a warning.
+    per object are turned into multi-mesh primitives, except for meshes
+    quantized with the @cb{.ini} quantize @ce option, which are each put into
+    a dedicated child node carrying the dequantization transform. Other
+    duplicate builtin fields are ignored with a warning.
 -   Custom @ref SceneFieldType::Float, @relativeref{SceneFieldType,UnsignedInt},
     @relativeref{SceneFieldType,Int}, @relativeref{SceneFieldType,Bit} and
     string fields are exported if a name is set for them via
@@ -502,6 +574,15 @@ to edit the configuration values.
 */
 class MAGNUM_GLTFSCENECONVERTER_EXPORT GltfSceneConverter: public AbstractSceneConverter {
     public:
+        /**
+         * @brief Initialize meshoptimizer codec versions
+         * @m_since_latest
+         *
+         * Called by the plugin manager when the plugin is loaded, see
+         * @ref Trade-GltfSceneConverter-behavior-meshes for details.
+         */
+        static void initialize();
+
         /** @brief Plugin manager constructor */
         explicit GltfSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
@@ -511,7 +592,10 @@ class MAGNUM_GLTFSCENECONVERTER_EXPORT GltfSceneConverter: public AbstractSceneC
         MAGNUM_GLTFSCENECONVERTER_LOCAL SceneConverterFeatures doFeatures() const override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doBeginFile(Containers::StringView filename) override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doBeginData() override;
+        MAGNUM_GLTFSCENECONVERTER_LOCAL bool writeJson(Utility::JsonWriter& json);
         MAGNUM_GLTFSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doEndData() override;
+        MAGNUM_GLTFSCENECONVERTER_LOCAL bool doEndFile(Containers::StringView filename) override;
+        MAGNUM_GLTFSCENECONVERTER_LOCAL void flushBuffer(bool all);
         MAGNUM_GLTFSCENECONVERTER_LOCAL void doAbort() override;
 
         MAGNUM_GLTFSCENECONVERTER_LOCAL void doSetDefaultScene(UnsignedInt id) override;
@@ -526,7 +610,11 @@ class MAGNUM_GLTFSCENECONVERTER_EXPORT GltfSceneConverter: public AbstractSceneC
 
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const TextureData& texture, Containers::StringView name) override;
 
+        MAGNUM_GLTFSCENECONVERTER_LOCAL Containers::String externalImageFilename(UnsignedInt id, AbstractImageConverter& imageConverter);
         template<UnsignedInt dimensions> MAGNUM_GLTFSCENECONVERTER_LOCAL bool convertAndWriteImage(UnsignedInt id, Containers::StringView name, AbstractImageConverter& imageConverter, const ImageData<dimensions>& image, bool bundleImages);
+        template<UnsignedInt dimensions> MAGNUM_GLTFSCENECONVERTER_LOCAL bool queueImage(UnsignedInt id, Containers::StringView name, Containers::Pointer<AbstractImageConverter>&& imageConverter, const ImageData<dimensions>& image, bool bundleImages);
+        MAGNUM_GLTFSCENECONVERTER_LOCAL void writeImage(UnsignedInt id, Containers::StringView name, AbstractImageConverter& imageConverter, Containers::ArrayView<const char> bundledData, Containers::StringView filename, bool accessorNames, bool deduplicate);
+        MAGNUM_GLTFSCENECONVERTER_LOCAL bool encodeQueuedImages();
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const ImageData2D& image, Containers::StringView name) override;
         MAGNUM_GLTFSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const ImageData3D& image, Containers::StringView name) override;
 
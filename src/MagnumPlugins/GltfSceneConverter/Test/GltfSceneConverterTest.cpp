@@ -52,6 +52,7 @@
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Swizzle.h>
 #include <Magnum/MaterialTools/Filter.h>
 #include <Magnum/MaterialTools/Merge.h>
 #include <Magnum/MeshTools/Transform.h>
@@ -86,6 +87,10 @@ struct GltfSceneConverterTest: TestSuite::Tester {
     void addMeshBufferViewsMixed();
     void addMeshNoAttributes();
     void addMeshNoIndices();
+    void addMeshDeduplicate();
+    void addMeshStreamBuffer();
+    void addMeshQuantize();
+    void addMeshQuantizeInvalidBits();
     void addMeshNoIndicesNoAttributes();
     void addMeshNoIndicesNoVertices();
     void addMeshAttribute();
@@ -97,6 +102,9 @@ struct GltfSceneConverterTest: TestSuite::Tester {
     void addMeshCustomObjectIdAttributeName();
     void addMeshMultiple();
     void addMeshBufferAlignment();
+    void addMeshMeshoptCompression();
+    void addMeshMeshoptCompressionFallbackToData();
+    void addMeshMeshoptCompressionDeduplicate();
     void addMeshInvalid();
 
     void addImage2D();
@@ -108,6 +116,8 @@ struct GltfSceneConverterTest: TestSuite::Tester {
     void addImagePropagateConfigurationUnknown();
     void addImagePropagateConfigurationGroup();
     void addImageMultiple();
+    void addImageParallelMessages();
+    void addImageParallelInvalid();
     /* Multiple 2D + 3D images tested in addMaterial2DArrayTextures() */
     void addImageNoConverterManager();
     void addImageExternalToData();
@@ -352,6 +362,14 @@ const struct {
     {"with compatibility skinning attributes", true}
 };
 
+const struct {
+    const char* name;
+    bool fallback;
+} AddMeshMeshoptCompressionData[]{
+    {"", false},
+    {"with fallback", true},
+};
+
 const UnsignedInt AddMeshInvalidIndices[4]{};
 const Vector4d AddMeshInvalidVertices[4]{};
 const struct {
@@ -605,6 +623,15 @@ const struct {
         "Trade::TgaImageConverter::convertToData(): converting from RGB to BGR\n"}
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} AddImageMultipleData[]{
+    {"", 1},
+    {"two threads", 2},
+    {"autodetected thread count", 0},
+};
+
 const struct {
     const char* name;
     const char* plugin;
@@ -716,6 +743,9 @@ const struct {
     {"TGA", "TgaImageConverter",
         {}, {}, false,
         "texture-tga.gltf"},
+    {"WebP", "WebPImageConverter",
+        {}, {}, {},
+        "texture-webp.gltf"},
 };
 
 const struct {
@@ -2010,7 +2040,14 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
     addInstancedTests({&GltfSceneConverterTest::addMeshNoAttributes},
         Containers::arraySize(QuietData));
 
-    addTests({&GltfSceneConverterTest::addMeshNoIndices});
+    addTests({&GltfSceneConverterTest::addMeshNoIndices,
+              &GltfSceneConverterTest::addMeshDeduplicate});
+
+    addInstancedTests({&GltfSceneConverterTest::addMeshStreamBuffer},
+        Containers::arraySize(FileVariantData));
+
+    addTests({&GltfSceneConverterTest::addMeshQuantize,
+              &GltfSceneConverterTest::addMeshQuantizeInvalidBits});
 
     addInstancedTests({&GltfSceneConverterTest::addMeshNoIndicesNoAttributes,
                        &GltfSceneConverterTest::addMeshNoIndicesNoVertices},
@@ -2036,6 +2073,12 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
               &GltfSceneConverterTest::addMeshMultiple,
               &GltfSceneConverterTest::addMeshBufferAlignment});
 
+    addInstancedTests({&GltfSceneConverterTest::addMeshMeshoptCompression},
+        Containers::arraySize(AddMeshMeshoptCompressionData));
+
+    addTests({&GltfSceneConverterTest::addMeshMeshoptCompressionFallbackToData,
+              &GltfSceneConverterTest::addMeshMeshoptCompressionDeduplicate});
+
     addInstancedTests({&GltfSceneConverterTest::addMeshInvalid},
         Containers::arraySize(AddMeshInvalidData));
 
@@ -2059,7 +2102,11 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
         &GltfSceneConverterTest::addImagePropagateConfigurationGroup},
         Containers::arraySize(QuietData));
 
-    addTests({&GltfSceneConverterTest::addImageMultiple,
+    addInstancedTests({&GltfSceneConverterTest::addImageMultiple},
+        Containers::arraySize(AddImageMultipleData));
+
+    addTests({&GltfSceneConverterTest::addImageParallelMessages,
+              &GltfSceneConverterTest::addImageParallelInvalid,
               &GltfSceneConverterTest::addImageNoConverterManager,
               &GltfSceneConverterTest::addImageExternalToData});
 
@@ -2170,6 +2217,9 @@ GltfSceneConverterTest::GltfSceneConverterTest() {
     #ifdef STBIMAGEIMPORTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STBIMAGEIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+    #ifdef WEBPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_imageConverterManager.load(WEBPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
 
     /* Try to load Magnum's own TgaImageConverter plugin, if it exists. Do it
        after StbImageConverter so if TgaImageConverter is aliased to it, it
@@ -2947,6 +2997,284 @@ void GltfSceneConverterTest::addMeshNoIndices() {
         TestSuite::Compare::Container);
 }
 
+void GltfSceneConverterTest::addMeshDeduplicate() {
+    const UnsignedShort indices[] {
+        0, 2, 1
+    };
+    const Vector3 positions[] {
+        {1.0f, 2.0f, 3.0f},
+        {4.0f, 5.0f, 6.0f},
+        {7.0f, 8.0f, 9.0f}
+    };
+
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}}
+    };
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->addFlags(SceneConverterFlag::Verbose);
+    converter->configuration().setValue("deduplicate", true);
+
+    /* The same mesh added twice under a different name */
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(mesh, "first"));
+    CORRADE_VERIFY(converter->add(mesh, "second"));
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> data;
+    {
+        Debug redirectOutput{&out};
+        data = converter->endData();
+    }
+    CORRADE_VERIFY(data);
+    /* Both the index and the vertex buffer view is reused, together with
+       both accessors */
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfSceneConverter::endData(): deduplicated 2 buffer views and 2 accessors, saving 42 bytes\n");
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    /* Both meshes should be still there, with the same data */
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    CORRADE_COMPARE(importer->meshName(1), "second");
+    for(UnsignedInt i: {0, 1}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<MeshData> imported = importer->mesh(i);
+        CORRADE_VERIFY(imported);
+        CORRADE_VERIFY(imported->isIndexed());
+        CORRADE_COMPARE_AS(imported->indices<UnsignedShort>(),
+            Containers::arrayView(indices),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(imported->attributeCount(), 1);
+        CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView(positions),
+            TestSuite::Compare::Container);
+    }
+}
+
+void GltfSceneConverterTest::addMeshStreamBuffer() {
+    auto&& data = FileVariantData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Three 8-bit indices, so the index data aren't a multiple of four */
+    const UnsignedByte indices[] {
+        0, 2, 1
+    };
+    /* Positions followed by 8-bit texture coordinates, 42 bytes in total, so
+       the buffer isn't a multiple of four bytes after the mesh is added and
+       the remaining two bytes stay in memory until the next flush */
+    const struct Vertices {
+        Vector3 positions[3];
+        Vector2ub textureCoordinates[3];
+    } vertices{
+        {{1.0f, 2.0f, 3.0f},
+         {4.0f, 5.0f, 6.0f},
+         {7.0f, 8.0f, 9.0f}},
+        {{0, 255}, {128, 0}, {255, 64}}
+    };
+    const Containers::ArrayView<const char> vertexData{reinterpret_cast<const char*>(&vertices), sizeof(vertices.positions) + sizeof(vertices.textureCoordinates)};
+    CORRADE_COMPARE(vertexData.size() % 4, 2);
+
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, vertexData, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(vertices.positions)},
+            MeshAttributeData{MeshAttribute::TextureCoordinates, VertexFormat::Vector2ubNormalized, Containers::arrayView(vertices.textureCoordinates)}
+        }
+    };
+
+    /* A different mesh with 16-bit indices, added after the above to verify
+       the alignment is still correct after the remaining bytes */
+    const UnsignedShort indices16[] {
+        1, 0, 2
+    };
+    const Vector3 positions[] {
+        {1.5f, 2.5f, 3.5f},
+        {4.5f, 5.5f, 6.5f},
+        {7.5f, 8.5f, 9.5f}
+    };
+    MeshData mesh16{MeshPrimitive::Triangles,
+        {}, indices16, MeshIndexData{indices16},
+        {}, positions, {MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}}
+    };
+
+    const Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-stream-buffer" + data.suffix);
+    const Containers::String bufferFilename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-stream-buffer.bin");
+
+    /* Convert without streaming first to have something to compare to.
+       Adding the mesh twice with deduplication enabled, which then has to
+       read the data of the first mesh back from the streamed file. */
+    Containers::Optional<Containers::String> expected;
+    Containers::Optional<Containers::String> expectedBuffer;
+    for(bool streamBuffer: {false, true}) {
+        CORRADE_ITERATION(streamBuffer);
+
+        Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+        converter->configuration().setValue("deduplicate", true);
+        converter->configuration().setValue("streamBuffer", streamBuffer);
+
+        CORRADE_VERIFY(converter->beginFile(filename));
+        CORRADE_VERIFY(converter->add(mesh));
+        CORRADE_VERIFY(converter->add(mesh));
+        CORRADE_VERIFY(converter->add(mesh16));
+        CORRADE_VERIFY(converter->endFile());
+
+        if(!streamBuffer) {
+            expected = Utility::Path::readString(filename);
+            CORRADE_VERIFY(expected);
+            if(!data.binary) {
+                expectedBuffer = Utility::Path::readString(bufferFilename);
+                CORRADE_VERIFY(expectedBuffer);
+            }
+            continue;
+        }
+
+        CORRADE_COMPARE_AS(filename, *expected,
+            TestSuite::Compare::FileToString);
+        if(!data.binary) CORRADE_COMPARE_AS(bufferFilename, *expectedBuffer,
+            TestSuite::Compare::FileToString);
+
+        /* The temporary file should be removed after */
+        CORRADE_VERIFY(!Utility::Path::exists(filename + ".tmp"_s));
+    }
+}
+
+void GltfSceneConverterTest::addMeshQuantize() {
+    /* Chosen so that all quantized values are exactly representable, which
+       makes the reported errors zero */
+    const struct Vertex {
+        Vector3 position;
+        Vector3 normal;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f}},
+        {{5.0f, 2.0f, 3.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
+        {{1.0f, 6.0f, 7.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 1.0f}}
+    };
+    const auto view = Containers::stridedArrayView(vertices);
+
+    MeshData mesh{MeshPrimitive::Triangles, {}, vertices, {
+        MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+        MeshAttributeData{MeshAttribute::Normal, view.slice(&Vertex::normal)},
+        MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->addFlags(SceneConverterFlag::Verbose);
+    converter->configuration().setValue("quantize", true);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(converter->add(mesh));
+    }
+    CORRADE_COMPARE(out.str(),
+        "Trade::GltfSceneConverter::add(): quantized Trade::MeshAttribute::Position to VertexFormat::Vector3usNormalized with a max error of 0\n"
+        "Trade::GltfSceneConverter::add(): quantized Trade::MeshAttribute::Normal to VertexFormat::Vector3bNormalized with a max error of 0\n"
+        "Trade::GltfSceneConverter::add(): quantized Trade::MeshAttribute::TextureCoordinates to VertexFormat::Vector2usNormalized with a max error of 0\n");
+
+    /* Object 0 references the mesh and has object 1 as a child, which
+       shouldn't be affected by the dequantization transform */
+    const struct Scene {
+        Containers::Pair<UnsignedInt, Int> parents[2];
+        Containers::Pair<UnsignedInt, UnsignedInt> meshes[1];
+    } sceneData[]{{
+        {{0, -1}, {1, 0}},
+        {{0, 0}}
+    }};
+    CORRADE_VERIFY(converter->add(SceneData{SceneMappingType::UnsignedInt, 2, {}, sceneData, {
+        /* To mark the scene as 3D */
+        SceneFieldData{SceneField::Transformation,
+            SceneMappingType::UnsignedInt, nullptr,
+            SceneFieldType::Matrix4x4, nullptr},
+        SceneFieldData{SceneField::Parent,
+            Containers::stridedArrayView(sceneData->parents).slice(&Containers::Pair<UnsignedInt, Int>::first),
+            Containers::stridedArrayView(sceneData->parents).slice(&Containers::Pair<UnsignedInt, Int>::second)},
+        SceneFieldData{SceneField::Mesh,
+            Containers::stridedArrayView(sceneData->meshes).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(sceneData->meshes).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second)},
+    }}));
+
+    Containers::Optional<Containers::Array<char>> data = converter->endData();
+    CORRADE_VERIFY(data);
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->attributeCount(), 3);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3usNormalized);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3us>(MeshAttribute::Position), Containers::arrayView<Vector3us>({
+        {0, 0, 0},
+        {65535, 0, 0},
+        {0, 65535, 65535}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3bNormalized);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3b>(MeshAttribute::Normal), Containers::arrayView<Vector3b>({
+        {127, 0, 0},
+        {0, 127, 0},
+        {0, 0, -127}
+    }), TestSuite::Compare::Container);
+    /* Y-flipped on export and back on import */
+    CORRADE_COMPARE(imported->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2usNormalized);
+    CORRADE_COMPARE_AS(imported->attribute<Vector2us>(MeshAttribute::TextureCoordinates), Containers::arrayView<Vector2us>({
+        {0, 65535},
+        {65535, 0},
+        {65535, 65535}
+    }), TestSuite::Compare::Container);
+
+    /* The mesh is moved to a new child node of object 0 with the
+       dequantization transform */
+    Containers::Optional<SceneData> scene = importer->scene(0);
+    CORRADE_VERIFY(scene);
+    CORRADE_COMPARE(scene->mappingBound(), 3);
+    CORRADE_COMPARE_AS(scene->parentsAsArray(), (Containers::arrayView<Containers::Pair<UnsignedInt, Int>>({
+        {0, -1},
+        {1, 0},
+        {2, 0}
+    })), TestSuite::Compare::Container);
+    CORRADE_VERIFY(scene->meshesMaterialsFor(0).isEmpty());
+    CORRADE_COMPARE_AS(scene->meshesMaterialsFor(2), (Containers::arrayView<Containers::Pair<UnsignedInt, Int>>({
+        {0, -1}
+    })), TestSuite::Compare::Container);
+
+    Containers::Optional<Containers::Triple<Vector3, Quaternion, Vector3>> trs = scene->translationRotationScaling3DFor(2);
+    CORRADE_VERIFY(trs);
+    CORRADE_COMPARE(trs->first(), (Vector3{1.0f, 2.0f, 3.0f}));
+    CORRADE_COMPARE(trs->third(), Vector3{4.0f});
+}
+
+void GltfSceneConverterTest::addMeshQuantizeInvalidBits() {
+    const Vector3 positions[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, positions, {MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}}
+    };
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("quantize", true);
+    converter->configuration().setValue("quantizeNormalBits", 10);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!converter->add(mesh));
+    }
+    CORRADE_COMPARE(out.str(), "Trade::GltfSceneConverter::add(): expected quantization bit depth to be 8 or 16 but got 16, 10 and 16 for positions, normals and texture coordinates\n");
+}
+
 void GltfSceneConverterTest::addMeshNoIndicesNoAttributes() {
     auto&& data = FileVariantStrictWarningData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -3709,6 +4037,196 @@ void GltfSceneConverterTest::addMeshBufferAlignment() {
         TestSuite::Compare::Container);
 }
 
+void GltfSceneConverterTest::addMeshMeshoptCompression() {
+    auto&& data = AddMeshMeshoptCompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("meshoptCompression", true);
+    converter->configuration().setValue("meshoptCompressionFallback", data.fallback);
+
+    Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-meshopt.gltf");
+    Containers::String fallbackFilename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "mesh-meshopt.fallback.bin");
+    if(Utility::Path::exists(fallbackFilename))
+        CORRADE_VERIFY(Utility::Path::remove(fallbackFilename));
+    CORRADE_VERIFY(converter->beginFile(filename));
+
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {0.0f, 0.25f}},
+        {{4.0f, 5.0f, 6.0f}, {0.5f, 0.75f}},
+        {{7.0f, 8.0f, 9.0f}, {1.0f, 0.5f}},
+        {{1.5f, 2.5f, 3.5f}, {0.25f, 1.0f}},
+    };
+    const UnsignedShort indices[]{0, 1, 2, 2, 1, 3};
+    Containers::StridedArrayView1D<const Vertex> view = vertices;
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)}
+        }};
+
+    #ifndef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::GltfSceneConverter::add(): EXT_meshopt_compression requested but the plugin was built without meshoptimizer\n");
+    #else
+    CORRADE_VERIFY(converter->add(mesh));
+    CORRADE_VERIFY(converter->endFile());
+
+    const Containers::Optional<Containers::String> gltf = Utility::Path::readString(filename);
+    CORRADE_VERIFY(gltf);
+    /* The compressed data depend on meshoptimizer version, so not comparing
+       against a file but just checking the important bits */
+    CORRADE_COMPARE_AS(*gltf,
+        data.fallback ?
+            "\"extensionsUsed\": [\n    \"EXT_meshopt_compression\"\n  ]" :
+            "\"extensionsRequired\": [\n    \"EXT_meshopt_compression\"\n  ]",
+        TestSuite::Compare::StringContains);
+    CORRADE_COMPARE_AS(*gltf,
+        "\"mode\": \"TRIANGLES\"",
+        TestSuite::Compare::StringContains);
+    CORRADE_COMPARE_AS(*gltf,
+        "\"mode\": \"ATTRIBUTES\"",
+        TestSuite::Compare::StringContains);
+    CORRADE_COMPARE_AS(*gltf,
+        "\"fallback\": true",
+        TestSuite::Compare::StringContains);
+    CORRADE_COMPARE(Utility::Path::exists(fallbackFilename), data.fallback);
+    if(data.fallback) CORRADE_COMPARE_AS(*gltf,
+        "\"uri\": \"mesh-meshopt.fallback.bin\"",
+        TestSuite::Compare::StringContains);
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_VERIFY(imported->isIndexed());
+    CORRADE_COMPARE(imported->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(imported->indexCount(), 6);
+
+    /* The triangle codec may rotate vertices in each triangle, the winding
+       stays the same however */
+    Containers::StridedArrayView1D<const UnsignedShort> importedIndices = imported->indices<UnsignedShort>();
+    for(std::size_t i = 0; i != 6; i += 3) {
+        CORRADE_ITERATION(i);
+        const Vector3us expected{indices[i], indices[i + 1], indices[i + 2]};
+        const Vector3us actual{importedIndices[i], importedIndices[i + 1], importedIndices[i + 2]};
+        CORRADE_VERIFY(actual == expected ||
+                       actual == Math::gather<'y', 'z', 'x'>(expected) ||
+                       actual == Math::gather<'z', 'x', 'y'>(expected));
+    }
+
+    CORRADE_COMPARE(imported->attributeCount(), 2);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        view.slice(&Vertex::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        view.slice(&Vertex::textureCoordinates),
+        TestSuite::Compare::Container);
+    #endif
+}
+
+void GltfSceneConverterTest::addMeshMeshoptCompressionFallbackToData() {
+    #ifndef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin is built without meshoptimizer, can't test EXT_meshopt_compression encoding.");
+    #else
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("meshoptCompression", true);
+    converter->configuration().setValue("meshoptCompressionFallback", true);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    const Vector3 positions[]{{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+    CORRADE_VERIFY(converter->add(MeshData{MeshPrimitive::Triangles,
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+        }}));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->endData());
+    CORRADE_COMPARE(out.str(), "Trade::GltfSceneConverter::endData(): can only write an EXT_meshopt_compression fallback buffer if converting to a file\n");
+    #endif
+}
+
+void GltfSceneConverterTest::addMeshMeshoptCompressionDeduplicate() {
+    #ifndef MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin is built without meshoptimizer, can't test EXT_meshopt_compression encoding.");
+    #else
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->addFlags(SceneConverterFlag::Verbose);
+    converter->configuration().setValue("meshoptCompression", true);
+    converter->configuration().setValue("deduplicate", true);
+
+    const struct Vertex {
+        Vector3 position;
+        Vector2 textureCoordinates;
+    } vertices[]{
+        {{1.0f, 2.0f, 3.0f}, {0.0f, 0.25f}},
+        {{4.0f, 5.0f, 6.0f}, {0.5f, 0.75f}},
+        {{7.0f, 8.0f, 9.0f}, {1.0f, 0.5f}},
+        {{1.5f, 2.5f, 3.5f}, {0.25f, 1.0f}},
+    };
+    /* Triangles where the triangle codec is likely to rotate the vertices,
+       which then has to be taken into account when looking up the data of
+       the second mesh */
+    const UnsignedShort indices[]{3, 1, 2, 2, 0, 3, 1, 0, 2};
+    Containers::StridedArrayView1D<const Vertex> view = vertices;
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, view.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::TextureCoordinates, view.slice(&Vertex::textureCoordinates)}
+        }};
+
+    /* The same mesh added twice under a different name */
+    CORRADE_VERIFY(converter->beginData());
+    CORRADE_VERIFY(converter->add(mesh, "first"));
+    CORRADE_VERIFY(converter->add(mesh, "second"));
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> data;
+    {
+        Debug redirectOutput{&out};
+        data = converter->endData();
+    }
+    CORRADE_VERIFY(data);
+    /* Both the index and the vertex buffer view is reused, together with all
+       three accessors */
+    CORRADE_COMPARE_AS(out.str(),
+        "Trade::GltfSceneConverter::endData(): deduplicated 2 buffer views and 3 accessors, saving ",
+        TestSuite::Compare::StringHasPrefix);
+
+    if(_importerManager.loadState("GltfImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("GltfImporter plugin not found, cannot test a roundtrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("GltfImporter");
+    CORRADE_VERIFY(importer->openData(*data));
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    Containers::Optional<MeshData> first = importer->mesh(0);
+    Containers::Optional<MeshData> second = importer->mesh(1);
+    CORRADE_VERIFY(first);
+    CORRADE_VERIFY(second);
+    CORRADE_COMPARE_AS(second->indices<UnsignedShort>(),
+        first->indices<UnsignedShort>(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(second->attribute<Vector3>(MeshAttribute::Position),
+        view.slice(&Vertex::position),
+        TestSuite::Compare::Container);
+    #endif
+}
+
 void GltfSceneConverterTest::addMeshInvalid() {
     auto&& data = AddMeshInvalidData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -4120,6 +4638,9 @@ void GltfSceneConverterTest::addImagePropagateConfigurationGroup() {
 }
 
 void GltfSceneConverterTest::addImageMultiple() {
+    auto&& data = AddImageMultipleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
     if(_imageConverterManager.loadState("PngImageConverter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("PngImageConverter plugin not found, cannot test");
     if(_imageConverterManager.loadState("JpegImageConverter") == PluginManager::LoadState::NotFound)
@@ -4127,6 +4648,10 @@ void GltfSceneConverterTest::addImageMultiple() {
 
     Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
 
+    /* With more than one thread the images are encoded only in endFile(),
+       the output should be the same regardless */
+    converter->configuration().setValue("threads", data.threads);
+
     Containers::String filename = Utility::Path::join(GLTFSCENECONVERTER_TEST_OUTPUT_DIR, "image-multiple.gltf");
     CORRADE_VERIFY(converter->beginFile(filename));
 
@@ -4194,6 +4719,72 @@ void GltfSceneConverterTest::addImageMultiple() {
     CORRADE_COMPARE(imported2->pixels<Color3ub>()[0][0], 0xff6632_rgb);
 }
 
+void GltfSceneConverterTest::addImageParallelMessages() {
+    if(_imageConverterManager.loadState("TgaImageConverter") == PluginManager::LoadState::NotFound ||
+       /* TgaImageConverter is also provided by StbImageConverter, which
+          doesn't make use of Flags::Verbose, so that one can't be used to test
+          anything */
+       _imageConverterManager.metadata("TgaImageConverter")->name() != "TgaImageConverter")
+        CORRADE_SKIP("(Non-aliased) TgaImageConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->addFlags(SceneConverterFlag::Verbose);
+    converter->configuration().setValue("threads", 2);
+
+    converter->configuration().setValue("imageConverter", "TgaImageConverter");
+    /* So it allows using a TGA image */
+    converter->configuration().setValue("strict", false);
+    /* So it doesn't try to use RLE first and then falls back to uncompressed
+       because RLE is larger, producing one extra verbose message */
+    converter->configuration().group("imageConverter")->setValue("rle", false);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    /* The first image produces a warning in addition to the verbose output,
+       the second just the verbose output */
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGB8Unorm, {1, 1}, "yey", ImageFlag2D::Array}));
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGB8Unorm, {1, 1}, "yey"}));
+
+    /* The images are encoded only at the end on the worker threads, the
+       output should still reach the redirection on this thread and be in the
+       order the images were added */
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(converter->endData());
+    }
+    CORRADE_COMPARE(out.str(),
+        "Trade::TgaImageConverter::convertToData(): converting from RGB to BGR\n"
+        "Trade::TgaImageConverter::convertToData(): 1D array images are unrepresentable in TGA, saving as a regular 2D image\n"
+        "Trade::TgaImageConverter::convertToData(): converting from RGB to BGR\n");
+}
+
+void GltfSceneConverterTest::addImageParallelInvalid() {
+    if(_imageConverterManager.loadState("PngImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImageConverter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("GltfSceneConverter");
+    converter->configuration().setValue("threads", 2);
+
+    CORRADE_VERIFY(converter->beginData());
+
+    /* The first image is fine, the second fails only once encoded at the
+       end */
+    Color4ub imageData0[]{0xff3366_rgb};
+    CORRADE_VERIFY(converter->add(ImageView2D{PixelFormat::RGB8Unorm, {1, 1}, imageData0}));
+    CORRADE_VERIFY(converter->add(ImageData2D{PixelFormat::R32F, {1, 1}, DataFlags{}, "abc"}));
+
+    /* Only the messages for the failed image get printed, and not
+       interleaved with anything else */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->endData());
+    CORRADE_COMPARE(out.str(),
+        "Trade::StbImageConverter::convertToData(): PixelFormat::R32F is not supported for BMP/JPEG/PNG/TGA output\n"
+        "Trade::GltfSceneConverter::endData(): can't convert 2D image 1\n");
+}
+
 void GltfSceneConverterTest::addImageNoConverterManager() {
     /* Create a new manager that doesn't have the image converter manager
        registered; load the plugin directly from the build tree. Otherwise it's
@@ -33,5 +33,7 @@
 #cmakedefine STBDXTIMAGECONVERTER_PLUGIN_FILENAME "${STBDXTIMAGECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGECONVERTER_PLUGIN_FILENAME "${STBIMAGECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine WEBPIMAGECONVERTER_PLUGIN_FILENAME "${WEBPIMAGECONVERTER_PLUGIN_FILENAME}"
 #define GLTFSCENECONVERTER_TEST_DIR "${GLTFSCENECONVERTER_TEST_DIR}"
 #define GLTFSCENECONVERTER_TEST_OUTPUT_DIR "${GLTFSCENECONVERTER_TEST_OUTPUT_DIR}"
+#cmakedefine MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MAGNUM_GLTFSCENECONVERTER_BUILD_STATIC
+#cmakedefine MAGNUM_GLTFSCENECONVERTER_HAS_MESHOPTIMIZER
@@ -26,13 +26,16 @@
 #include "JpegImageConverter.h"
 
 #include <csetjmp>
+#include <thread>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 
 #ifdef CORRADE_TARGET_WINDOWS
 /* On Windows we need to circumvent conflicting definition of INT32 in
@@ -61,6 +64,8 @@ using namespace Containers::Literals;
 JpegImageConverter::JpegImageConverter() {
     /** @todo horrible workaround, fix this properly */
     configuration().setValue("jpegQuality", 0.8f);
+    configuration().setValue("strips", 1);
+    configuration().setValue("restartInterval", 0);
 }
 
 JpegImageConverter::JpegImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter(manager, Utility::move(plugin)) {}
@@ -73,41 +78,13 @@ Containers::String JpegImageConverter::doMimeType() const {
     return "image/jpeg"_s;
 }
 
-Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToData(const ImageView2D& image) {
-    /* Warn about lost metadata */
-    if(image.flags() & ImageFlag2D::Array && !(flags() & ImageConverterFlag::Quiet)) {
-        Warning{} << "Trade::JpegImageConverter::convertToData(): 1D array images are unrepresentable in JPEG, saving as a regular 2D image";
-    }
-
-    static_assert(BITS_IN_JSAMPLE == 8, "Only 8-bit JPEG is supported");
-
-    Int components;
-    J_COLOR_SPACE colorSpace;
-    switch(image.format()) {
-        case PixelFormat::R8Unorm:
-            components = 1;
-            colorSpace = JCS_GRAYSCALE;
-            break;
-        case PixelFormat::RGB8Unorm:
-            components = 3;
-            colorSpace = JCS_RGB;
-            break;
-        case PixelFormat::RGBA8Unorm:
-            #ifdef JCS_EXTENSIONS
-            components = 4;
-            colorSpace = JCS_EXT_RGBX;
-            if(!(flags() & ImageConverterFlag::Quiet))
-                Warning{} << "Trade::JpegImageConverter::convertToData(): ignoring alpha channel";
-            break;
-            #else
-            Error{} << "Trade::JpegImageConverter::convertToData(): RGBA input (with alpha ignored) requires libjpeg-turbo";
-            return {};
-            #endif
-        default:
-            Error() << "Trade::JpegImageConverter::convertToData(): unsupported pixel format" << image.format();
-            return {};
-    }
+namespace {
 
+/* Encodes given rows into a standalone JPEG file. Used for both the whole
+   image and for individual strips, in which case it's called from multiple
+   threads at once and thus doesn't print anything. On failure returns false
+   and fills the message. */
+bool compress(const Containers::StridedArrayView3D<const char>& pixels, const Int components, const J_COLOR_SPACE colorSpace, const Int quality, const UnsignedInt restartInRows, const UnsignedInt expectedMcuHeight, Containers::Array<char>& out, char* const message) {
     /* Initialize structures. Needs to be before the setjmp crap in order to
        avoid leaks on error. */
     jpeg_compress_struct info;
@@ -116,16 +93,14 @@ Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToDat
         Containers::Array<char> output;
     } destinationManager;
 
-    Containers::Array<JSAMPROW> rows;
-    Containers::Array<char> data;
-
     /* Fugly error handling stuff */
     /** @todo Get rid of this crap */
     struct ErrorManager {
         jpeg_error_mgr jpegErrorManager;
         std::jmp_buf setjmpBuffer;
-        char message[JMSG_LENGTH_MAX]{};
+        char* message;
     } errorManager;
+    errorManager.message = message;
     info.err = jpeg_std_error(&errorManager.jpegErrorManager);
     errorManager.jpegErrorManager.error_exit = [](j_common_ptr info) {
         auto& errorManager = *reinterpret_cast<ErrorManager*>(info->err);
@@ -133,9 +108,8 @@ Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToDat
         std::longjmp(errorManager.setjmpBuffer, 1);
     };
     if(setjmp(errorManager.setjmpBuffer)) {
-        Error{} << "Trade::JpegImageConverter::convertToData(): error:" << errorManager.message;
         jpeg_destroy_compress(&info);
-        return {};
+        return false;
     }
 
     /* Create the compression structure */
@@ -165,24 +139,39 @@ Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToDat
     };
 
     /* Fill the info structure */
-    info.image_width = image.size().x();
-    info.image_height = image.size().y();
+    info.image_width = pixels.size()[1];
+    info.image_height = pixels.size()[0];
     info.input_components = components;
     info.in_color_space = colorSpace;
 
     jpeg_set_defaults(&info);
-    jpeg_set_quality(&info, Int(configuration().value<Float>("jpegQuality")*100.0f), boolean(true));
+    jpeg_set_quality(&info, quality, boolean(true));
+    info.restart_in_rows = restartInRows;
+    /* Strips are stitched together using headers of the first one, so they
+       all need to use the same Huffman tables and a single scan. This matters
+       only for implementations such as MozJPEG that default to optimized
+       tables and progressive encoding. */
+    if(expectedMcuHeight) {
+        info.optimize_coding = boolean(false);
+        info.scan_info = nullptr;
+        info.num_scans = 0;
+    }
     jpeg_start_compress(&info, boolean(true));
 
-    /* Write rows in reverse order. While the rows may have some padding after,
-       the actual pixels in the row should be contiguous so it should be safe
-       to pass a pointer to the first byte of each. */
-    const Containers::StridedArrayView3D<const char> pixelsFlipped = image.pixels().flipped<0>();
-    CORRADE_INTERNAL_ASSERT(pixelsFlipped.isContiguous<1>());
+    /* The strips are calculated assuming default sampling factors, and that
+       the restart interval isn't clamped to 16 bits */
+    CORRADE_INTERNAL_ASSERT(!expectedMcuHeight || (
+        UnsignedInt(info.max_v_samp_factor*DCTSIZE) == expectedMcuHeight &&
+        info.restart_interval == restartInRows*info.MCUs_per_row));
+
+    /* While the rows may have some padding after, the actual pixels in the
+       row should be contiguous so it should be safe to pass a pointer to the
+       first byte of each. */
+    CORRADE_INTERNAL_ASSERT(pixels.isContiguous<1>());
     while(info.next_scanline < info.image_height) {
         /* libJPEG HAVE YOU EVER HEARD ABOUT CONST ARGUMENTS?! IT'S NOT 1978
            ANYMORE */
-        JSAMPROW row = static_cast<JSAMPROW>(const_cast<void*>(pixelsFlipped[info.next_scanline].data()));
+        JSAMPROW row = static_cast<JSAMPROW>(const_cast<void*>(pixels[info.next_scanline].data()));
         /** @todo would it be any faster to pass more than one at a time? 64,
             for example? needs benchmarking, docs don't really suggest it as
             being good for perf, just "may be more convenient" */
@@ -195,9 +184,199 @@ Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToDat
     /* Convert the growable array back to a non-growable with the default
        deleter so we can return it */
     arrayShrink(destinationManager.output);
+    out = Utility::move(destinationManager.output);
+    return true;
+}
+
+/* Returns offset of the SOFn marker and offset of the entropy-coded data
+   right after the SOS marker segment in a file produced by compress() above.
+   Everything before is a sequence of marker segments with a length. */
+Containers::Pair<std::size_t, std::size_t> findFrameAndScanData(const Containers::ArrayView<const char> data) {
+    std::size_t frame = 0;
+    /* Skip the SOI marker */
+    std::size_t i = 2;
+    for(;;) {
+        CORRADE_INTERNAL_ASSERT(i + 4 <= data.size() && data[i] == '\xff');
+        const UnsignedByte marker = data[i + 1];
+        const std::size_t length = UnsignedByte(data[i + 2]) << 8 | UnsignedByte(data[i + 3]);
+        if(marker >= 0xc0 && marker <= 0xc2)
+            frame = i;
+        else if(marker == 0xda) {
+            CORRADE_INTERNAL_ASSERT(frame);
+            return {frame, i + 2 + length};
+        }
+        i += 2 + length;
+    }
+}
+
+}
+
+Containers::Optional<Containers::Array<char>> JpegImageConverter::doConvertToData(const ImageView2D& image) {
+    /* Warn about lost metadata */
+    if(image.flags() & ImageFlag2D::Array && !(flags() & ImageConverterFlag::Quiet)) {
+        Warning{} << "Trade::JpegImageConverter::convertToData(): 1D array images are unrepresentable in JPEG, saving as a regular 2D image";
+    }
+
+    static_assert(BITS_IN_JSAMPLE == 8, "Only 8-bit JPEG is supported");
+
+    Int components;
+    J_COLOR_SPACE colorSpace;
+    switch(image.format()) {
+        case PixelFormat::R8Unorm:
+            components = 1;
+            colorSpace = JCS_GRAYSCALE;
+            break;
+        case PixelFormat::RGB8Unorm:
+            components = 3;
+            colorSpace = JCS_RGB;
+            break;
+        case PixelFormat::RGBA8Unorm:
+            #ifdef JCS_EXTENSIONS
+            components = 4;
+            colorSpace = JCS_EXT_RGBX;
+            if(!(flags() & ImageConverterFlag::Quiet))
+                Warning{} << "Trade::JpegImageConverter::convertToData(): ignoring alpha channel";
+            break;
+            #else
+            Error{} << "Trade::JpegImageConverter::convertToData(): RGBA input (with alpha ignored) requires libjpeg-turbo";
+            return {};
+            #endif
+        default:
+            Error() << "Trade::JpegImageConverter::convertToData(): unsupported pixel format" << image.format();
+            return {};
+    }
+
+    const Int quality = Int(configuration().value<Float>("jpegQuality")*100.0f);
+
+    /* The strips would pass the dimension check in libjpeg individually, and
+       for too wide images the restart interval calculation below would
+       divide by zero, so it has to be done upfront */
+    if(image.size().x() > JPEG_MAX_DIMENSION || image.size().y() > JPEG_MAX_DIMENSION) {
+        Error{} << "Trade::JpegImageConverter::convertToData(): error: Maximum supported image dimension is" << JPEG_MAX_DIMENSION << "pixels";
+        return {};
+    }
+
+    /* With the default sampling factors, a MCU is 16x16 pixels for YCbCr and
+       8x8 for grayscale. Restart intervals are counted in MCUs and stored in
+       16 bits, libjpeg would silently clamp larger values. */
+    const std::size_t mcuSize = components == 1 ? 8 : 16;
+    const std::size_t mcuRows = (image.size().y() + mcuSize - 1)/mcuSize;
+    const std::size_t mcusPerRow = (image.size().x() + mcuSize - 1)/mcuSize;
+    const UnsignedInt restartInterval = configuration().value<UnsignedInt>("restartInterval");
+    if(restartInterval*mcusPerRow > 65535) {
+        Error{} << "Trade::JpegImageConverter::convertToData(): restart interval of" << restartInterval << "MCU rows is too large for an image" << mcusPerRow << "MCUs wide, expected at most" << 65535/mcusPerRow;
+        return {};
+    }
+
+    /* Split the image into strips of whole MCU rows. If no restart interval
+       is specified, place restart markers only between the strips, or more
+       often if the strips would be too large for a single interval. Strip
+       height is then rounded up to a multiple of the interval so the restart
+       markers coincide with strip boundaries. */
+    std::size_t stripCount = configuration().value<UnsignedInt>("strips");
+    if(!stripCount) {
+        stripCount = std::thread::hardware_concurrency();
+        if(flags() & ImageConverterFlag::Verbose)
+            Debug{} << "Trade::JpegImageConverter::convertToData(): autodetected hardware concurrency to" << stripCount << "strips";
+    }
+    stripCount = Math::max(Math::min(stripCount, mcuRows), std::size_t{1});
+    std::size_t stripMcuRows = mcuRows;
+    UnsignedInt stripRestartInterval = restartInterval;
+    if(stripCount > 1) {
+        stripMcuRows = (mcuRows + stripCount - 1)/stripCount;
+        if(!stripRestartInterval)
+            stripRestartInterval = UnsignedInt(Math::min(stripMcuRows, 65535/mcusPerRow));
+        stripMcuRows = (stripMcuRows + stripRestartInterval - 1)/stripRestartInterval*stripRestartInterval;
+        stripCount = (mcuRows + stripMcuRows - 1)/stripMcuRows;
+    }
+
+    /* Write rows in reverse order */
+    const Containers::StridedArrayView3D<const char> pixelsFlipped = image.pixels().flipped<0>();
+
+    /* Serial encoding, also in case the image is too small for more than one
+       strip */
+    if(stripCount == 1) {
+        Containers::Array<char> out;
+        char message[JMSG_LENGTH_MAX]{};
+        if(!compress(pixelsFlipped, components, colorSpace, quality, restartInterval, 0, out, message)) {
+            Error{} << "Trade::JpegImageConverter::convertToData(): error:" << message;
+            return {};
+        }
+
+        /* GCC 4.8 needs extra help here */
+        return Containers::optional(Utility::move(out));
+    }
+
+    if(flags() & ImageConverterFlag::Verbose)
+        Debug{} << "Trade::JpegImageConverter::convertToData(): encoding" << stripCount << "strips of" << stripMcuRows*mcuSize << "rows with a restart interval of" << stripRestartInterval << "MCU rows";
+
+    /* Encode each strip as a standalone file on its own thread, with the
+       calling thread encoding the first strip */
+    struct Strip {
+        Containers::Array<char> data;
+        char message[JMSG_LENGTH_MAX];
+        bool success;
+    };
+    Containers::Array<Strip> strips{ValueInit, stripCount};
+    const auto encodeStrip = [&](const std::size_t i) {
+        const std::size_t begin = i*stripMcuRows*mcuSize;
+        const std::size_t end = Math::min((i + 1)*stripMcuRows*mcuSize, std::size_t(image.size().y()));
+        strips[i].success = compress(pixelsFlipped.slice(begin, end), components, colorSpace, quality, stripRestartInterval, mcuSize, strips[i].data, strips[i].message);
+    };
+    Containers::Array<std::thread> threads{stripCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{encodeStrip, i + 1};
+    encodeStrip(0);
+    for(std::thread& thread: threads)
+        thread.join();
+
+    for(const Strip& strip: strips) if(!strip.success) {
+        Error{} << "Trade::JpegImageConverter::convertToData(): error:" << strip.message;
+        return {};
+    }
+
+    /* Take the headers from the first strip, with the image height in the
+       frame header patched to the full height. The frame header is the SOFn
+       marker, 16-bit length, 8-bit sample precision and 16-bit big-endian
+       height. As all strips use the same tables and restart interval, the
+       headers are otherwise the same for all. */
+    Containers::Array<char> out;
+    const Containers::Pair<std::size_t, std::size_t> header = findFrameAndScanData(strips[0].data);
+    arrayAppend(out, strips[0].data.prefix(header.second()));
+    out[header.first() + 5] = char(image.size().y() >> 8);
+    out[header.first() + 6] = char(image.size().y() & 0xff);
+
+    /* Concatenate entropy-coded data of all strips, separated with restart
+       markers. The restart markers inside each strip are renumbered to
+       continue from the previous strips. Entropy-coded data have each 0xff
+       byte followed by a stuffed zero, so 0xff followed by 0xd0 to 0xd7 is
+       always a restart marker. */
+    UnsignedInt restartCount = 0;
+    for(std::size_t i = 0; i != strips.size(); ++i) {
+        const Containers::ArrayView<const char> data = strips[i].data;
+        const std::size_t begin = i ? findFrameAndScanData(data).second() : header.second();
+        /* Each file ends with an EOI marker, which is skipped */
+        CORRADE_INTERNAL_ASSERT(data.size() >= begin + 2 && data[data.size() - 2] == '\xff' && data[data.size() - 1] == '\xd9');
+
+        if(i) arrayAppend(out, {'\xff', char(0xd0 + (restartCount++ & 7))});
+
+        const std::size_t outBegin = out.size();
+        arrayAppend(out, data.slice(begin, data.size() - 2));
+        for(std::size_t j = outBegin; j + 1 < out.size(); ++j) {
+            if(out[j] == '\xff' && UnsignedByte(out[j + 1]) >= 0xd0 && UnsignedByte(out[j + 1]) <= 0xd7) {
+                out[j + 1] = char(0xd0 + (restartCount++ & 7));
+                ++j;
+            }
+        }
+    }
+    arrayAppend(out, {'\xff', '\xd9'});
+
+    /* Convert the growable array back to a non-growable with the default
+       deleter so we can return it */
+    arrayShrink(out);
 
     /* GCC 4.8 needs extra help here */
-    return Containers::optional(Utility::move(destinationManager.output));
+    return Containers::optional(Utility::move(out));
 }
 
 }}
@@ -126,7 +126,26 @@ While JPEG files can have several extensions, @ref extension() always returns
 @cpp "jpg" @ce as that's the most common one.
 
 The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
-conversion warnings to be suppressed.
+conversion warnings to be suppressed. @ref ImageConverterFlag::Verbose is
+recognized as well, printing the strip layout used for parallel encoding.
+
+@subsection Trade-JpegImageConverter-behavior-strips Parallel encoding
+
+By default the whole image is encoded serially on the calling thread. Setting
+the @cb{.ini} strips @ce
+@ref Trade-JpegImageConverter-configuration "configuration option" to a value
+other than @cpp 1 @ce splits the image into horizontal strips of whole MCU
+rows that are encoded in parallel, each on its own thread. The strips are then
+concatenated into a single baseline JPEG with restart markers between them,
+and the headers of the first strip patched to the full image height. The
+output is the same as a serial encoding with the same restart interval, with
+the restart interval being either the one specified in the
+@cb{.ini} restartInterval @ce option or picked automatically to place markers
+only at strip boundaries. As restart markers add a few bytes each and reset
+DC prediction, the file is slightly larger than without them.
+Implementations that default to progressive encoding or optimized Huffman
+tables such as MozJPEG produce a baseline file with default tables in this
+case.
 
 @subsection Trade-JpegImageConverter-behavior-implementations libJPEG implementations
 
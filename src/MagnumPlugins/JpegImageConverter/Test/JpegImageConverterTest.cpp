@@ -66,6 +66,12 @@ struct JpegImageConverterTest: TestSuite::Tester {
 
     void unsupportedMetadata();
 
+    void strips();
+    void stripsRestartIntervalTooLarge();
+    void stripsTooWide();
+
+    void benchmarkStrips();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -92,6 +98,61 @@ const struct {
         nullptr},
 };
 
+const struct {
+    const char* name;
+    PixelFormat format;
+    Vector2i size;
+    UnsignedInt strips;
+    UnsignedInt restartInterval;
+    UnsignedInt expectedRestartInterval;
+    const char* message;
+} StripsData[]{
+    {"2 strips", PixelFormat::RGB8Unorm, {37, 70}, 2, 0, 3,
+        "encoding 2 strips of 48 rows with a restart interval of 3 MCU rows"},
+    {"3 strips", PixelFormat::RGB8Unorm, {37, 70}, 3, 0, 2,
+        "encoding 3 strips of 32 rows with a restart interval of 2 MCU rows"},
+    {"3 strips, restart interval 1", PixelFormat::RGB8Unorm, {37, 70}, 3, 1, 1,
+        "encoding 3 strips of 32 rows with a restart interval of 1 MCU rows"},
+    /* Strip height gets rounded up to a multiple of the interval, resulting
+       in less strips */
+    {"4 strips, restart interval 3", PixelFormat::RGB8Unorm, {37, 70}, 4, 3, 3,
+        "encoding 2 strips of 48 rows with a restart interval of 3 MCU rows"},
+    {"more strips than MCU rows", PixelFormat::RGB8Unorm, {37, 70}, 16, 0, 1,
+        "encoding 5 strips of 16 rows with a restart interval of 1 MCU rows"},
+    /* More than eight restart markers, both inside and between strips, to
+       verify they're renumbered correctly */
+    {"restart marker wraparound", PixelFormat::RGB8Unorm, {37, 200}, 3, 1, 1,
+        "encoding 3 strips of 80 rows with a restart interval of 1 MCU rows"},
+    /* MCUs are 8x8 for grayscale */
+    {"grayscale, 2 strips", PixelFormat::R8Unorm, {37, 30}, 2, 0, 2,
+        "encoding 2 strips of 16 rows with a restart interval of 2 MCU rows"},
+    /* Falls back to serial encoding */
+    {"single MCU row", PixelFormat::RGB8Unorm, {37, 10}, 4, 0, 0,
+        nullptr},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt strips;
+} BenchmarkStripsData[]{
+    {"serial", 1},
+    {"2 strips", 2},
+    {"4 strips", 4},
+    {"8 strips", 8},
+};
+
+/* Some non-trivial contents so the encoder has something to do, rows padded
+   to four bytes */
+Containers::Array<char> stripsImageData(const Vector2i& size, const std::size_t pixelSize) {
+    const std::size_t stride = (size.x()*pixelSize + 3)/4*4;
+    Containers::Array<char> out{ValueInit, stride*size.y()};
+    for(std::size_t y = 0; y != std::size_t(size.y()); ++y)
+        for(std::size_t x = 0; x != std::size_t(size.x()); ++x)
+            for(std::size_t c = 0; c != pixelSize; ++c)
+                out[y*stride + x*pixelSize + c] = char(x*x/3 + y*7 + c*85 + (x*y & 0x1f));
+    return out;
+}
+
 JpegImageConverterTest::JpegImageConverterTest() {
     addTests({&JpegImageConverterTest::wrongFormat,
               &JpegImageConverterTest::conversionError,
@@ -108,6 +169,15 @@ JpegImageConverterTest::JpegImageConverterTest() {
     addInstancedTests({&JpegImageConverterTest::unsupportedMetadata},
         Containers::arraySize(UnsupportedMetadataData));
 
+    addInstancedTests({&JpegImageConverterTest::strips},
+        Containers::arraySize(StripsData));
+
+    addTests({&JpegImageConverterTest::stripsRestartIntervalTooLarge,
+              &JpegImageConverterTest::stripsTooWide});
+
+    addInstancedBenchmarks({&JpegImageConverterTest::benchmarkStrips}, 10,
+        Containers::arraySize(BenchmarkStripsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef JPEGIMAGECONVERTER_PLUGIN_FILENAME
@@ -422,6 +492,97 @@ void JpegImageConverterTest::unsupportedMetadata() {
         CORRADE_COMPARE(out.str(), Utility::formatString("Trade::JpegImageConverter::convertToData(): {}\n", data.message));
 }
 
+void JpegImageConverterTest::strips() {
+    auto&& data = StripsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Containers::Array<char> imageData = stripsImageData(data.size, pixelFormatSize(data.format));
+    const ImageView2D image{data.format, data.size, imageData};
+
+    Containers::Pointer<AbstractImageConverter> serialConverter = _converterManager.instantiate("JpegImageConverter");
+    serialConverter->configuration().setValue("restartInterval", data.expectedRestartInterval);
+    Containers::Optional<Containers::Array<char>> expected = serialConverter->convertToData(image);
+    CORRADE_VERIFY(expected);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->addFlags(ImageConverterFlag::Verbose);
+    converter->configuration().setValue("strips", data.strips);
+    converter->configuration().setValue("restartInterval", data.restartInterval);
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> converted;
+    {
+        Debug redirectOutput{&out};
+        converted = converter->convertToData(image);
+    }
+    CORRADE_VERIFY(converted);
+    if(!data.message)
+        CORRADE_COMPARE(out.str(), "");
+    else
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::JpegImageConverter::convertToData(): {}\n", data.message));
+
+    /* The stitched file should be bit-identical to a serially encoded one
+       with the same restart interval */
+    CORRADE_COMPARE_AS(Containers::arrayView(*converted),
+        Containers::arrayView(*expected),
+        TestSuite::Compare::Container);
+
+    if(_importerManager.loadState("JpegImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("JpegImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openData(*converted));
+    Containers::Optional<Trade::ImageData2D> imported = importer->image2D(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->size(), data.size);
+}
+
+void JpegImageConverterTest::stripsRestartIntervalTooLarge() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("restartInterval", 65535);
+
+    const Containers::Array<char> imageData = stripsImageData({37, 70}, 3);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGB8Unorm, {37, 70}, imageData}));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImageConverter::convertToData(): restart interval of 65535 MCU rows is too large for an image 3 MCUs wide, expected at most 21845\n");
+}
+
+void JpegImageConverterTest::stripsTooWide() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("strips", 2);
+
+    /* Two MCU rows, each 65536 MCUs wide, which wouldn't fit even a single
+       row into a restart interval. Should fail on the dimension check
+       instead of dividing by zero when calculating the interval. */
+    const Containers::Array<char> imageData{ValueInit, 8*65536*16};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::R8Unorm, {8*65536, 16}, imageData}));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImageConverter::convertToData(): error: Maximum supported image dimension is 65500 pixels\n");
+}
+
+void JpegImageConverterTest::benchmarkStrips() {
+    auto&& data = BenchmarkStripsData[testCaseInstanceId()];
+    /* Tall enough for each of the eight strips to have eight MCU rows, which
+       makes the cost of the extra restart markers and stitching negligible */
+    setTestCaseDescription(Utility::formatString("{}, 1024x1024", data.name));
+
+    const Containers::Array<char> imageData = stripsImageData({1024, 1024}, 3);
+    const ImageView2D image{PixelFormat::RGB8Unorm, {1024, 1024}, imageData};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("strips", data.strips);
+
+    Containers::Optional<Containers::Array<char>> converted;
+    CORRADE_BENCHMARK(1)
+        converted = converter->convertToData(image);
+
+    CORRADE_VERIFY(converted);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::JpegImageConverterTest)
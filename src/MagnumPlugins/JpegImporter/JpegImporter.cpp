@@ -28,8 +28,10 @@
 #include <csetjmp>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
 #ifdef CORRADE_TARGET_WINDOWS
@@ -54,7 +56,11 @@
 
 namespace Magnum { namespace Trade {
 
-JpegImporter::JpegImporter() = default;
+JpegImporter::JpegImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("scaleDenominator", 1);
+    configuration().setValue("targetSize", 0);
+}
 
 JpegImporter::JpegImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
@@ -91,9 +97,26 @@ void JpegImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
 UnsignedInt JpegImporter::doImage2DCount() const { return 1; }
 
 Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    /* Check the scaling options upfront to not need to clean up the decoder
+       state on failure. Vanilla libjpeg supports only power-of-two scales, so
+       libjpeg-turbo's M/8 scaling isn't exposed. */
+    const UnsignedInt scaleDenominator = configuration().value<UnsignedInt>("scaleDenominator");
+    if(scaleDenominator != 1 && scaleDenominator != 2 && scaleDenominator != 4 && scaleDenominator != 8) {
+        Error{} << "Trade::JpegImporter::image2D(): expected scaleDenominator to be 1, 2, 4 or 8 but got" << configuration().value<Containers::StringView>("scaleDenominator");
+        return {};
+    }
+    const Int targetSize = configuration().value<Int>("targetSize");
+    if(targetSize < 0) {
+        Error{} << "Trade::JpegImporter::image2D(): expected targetSize to be non-negative but got" << targetSize;
+        return {};
+    }
+
     /* Initialize structures */
     jpeg_decompress_struct file;
     Containers::Array<char> data;
+    /* Declared here and not later so the longjmp() in the error handler
+       doesn't skip its destructor */
+    Containers::Array<JSAMPROW> rows;
 
     /* Fugly error handling stuff */
     /** @todo Get rid of this crap */
@@ -124,6 +147,21 @@ Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedI
        'boolean' for 2nd argument" (boolean is an enum instead of a typedef to
        int there) so doing the conversion implicitly. */
     jpeg_read_header(&file, boolean(true));
+
+    /* Scale down in the DCT domain if requested. If a target size is set,
+       pick the largest factor that keeps the smaller side at least that large,
+       with the output size rounded up the same way libjpeg does. */
+    file.scale_num = 1;
+    file.scale_denom = scaleDenominator;
+    if(targetSize) {
+        const UnsignedInt minSide = Math::min(file.image_width, file.image_height);
+        file.scale_denom = 8;
+        while(file.scale_denom != 1 && (minSide + file.scale_denom - 1)/file.scale_denom < UnsignedInt(targetSize))
+            file.scale_denom /= 2;
+    }
+    if(file.scale_denom != 1 && (flags() & ImporterFlag::Verbose))
+        Debug{} << "Trade::JpegImporter::image2D(): decoding at 1/" << Debug::nospace << file.scale_denom << "scale";
+
     jpeg_start_decompress(&file);
 
     /* Image size and type */
@@ -153,11 +191,13 @@ Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedI
     const std::size_t stride = ((size.x()*file.out_color_components*BITS_IN_JSAMPLE/8 + 3)/4)*4;
     data = Containers::Array<char>{stride*std::size_t(size.y())};
 
-    /* Read image row by row */
-    while(file.output_scanline < file.output_height) {
-        JSAMPROW row = reinterpret_cast<JSAMPROW>(data.data() + (size.y() - file.output_scanline - 1)*stride);
-        jpeg_read_scanlines(&file, &row, 1);
-    }
+    /* Prepare Y-flipped row pointers and let libjpeg read as many rows as it
+       can in a single call, instead of going row by row */
+    rows = Containers::Array<JSAMPROW>{NoInit, std::size_t(size.y())};
+    for(std::size_t i = 0; i != rows.size(); ++i)
+        rows[i] = reinterpret_cast<JSAMPROW>(data.data() + (size.y() - i - 1)*stride);
+    while(file.output_scanline < file.output_height)
+        jpeg_read_scanlines(&file, rows.data() + file.output_scanline, file.output_height - file.output_scanline);
 
     /* Cleanup */
     jpeg_finish_decompress(&file);
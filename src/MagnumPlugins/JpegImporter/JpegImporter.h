@@ -60,6 +60,13 @@ imported with @ref PixelFormat::RGB8Unorm or @ref PixelFormat::R8Unorm. All
 imported images use default @ref PixelStorage parameters. You can use
 @ref JpegImageConverter to encode images into this format.
 
+For thumbnails and low mip levels the image can be decoded scaled down by a
+factor of 2, 4 or 8 using the @cb{.ini} scaleDenominator @ce or
+@cb{.ini} targetSize @ce @ref Trade-JpegImporter-configuration "configuration options",
+which is done directly in the DCT domain and is considerably faster than a
+full-size decode. The importer recognizes @ref ImporterFlag::Verbose, printing
+the scale used when the image is scaled down.
+
 @m_class{m-block m-success}
 
 @thirdparty This plugin makes use of the [libJPEG](http://ijg.org/) library,
@@ -116,6 +123,16 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 While some systems (such as macOS) still ship only with the vanilla libJPEG,
 you can get a much better decoding performance by using
 [libjpeg-turbo](https://libjpeg-turbo.org/).
+
+@section Trade-JpegImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/JpegImporter/JpegImporter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_JPEGIMPORTER_EXPORT JpegImporter: public AbstractImporter {
     public:
@@ -29,7 +29,9 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/AbstractImporter.h>
@@ -37,6 +39,10 @@
 
 #include "configure.h"
 
+#ifndef JPEGIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/JpegImporter/JpegImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct JpegImporterTest: TestSuite::Tester {
@@ -47,15 +53,56 @@ struct JpegImporterTest: TestSuite::Tester {
 
     void gray();
     void rgb();
+    void scaled();
+    void scaledTargetSize();
+    void scaledInvalid();
 
     void openMemory();
     void openTwice();
     void importTwice();
 
+    void defaultConstructed();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+const struct {
+    const char* name;
+    const char* scaleDenominator;
+    Vector2i size;
+    const char* message;
+} ScaledData[]{
+    {"1/1", "1", {3, 2}, ""},
+    /* The output size is rounded up */
+    {"1/2", "2", {2, 1},
+        "Trade::JpegImporter::image2D(): decoding at 1/2 scale\n"},
+    {"1/8", "8", {1, 1},
+        "Trade::JpegImporter::image2D(): decoding at 1/8 scale\n"},
+};
+
+const struct {
+    const char* name;
+    Int targetSize;
+    Vector2i size;
+} ScaledTargetSizeData[]{
+    {"larger than the image", 16, {3, 2}},
+    {"equal to the smaller side", 2, {3, 2}},
+    {"one pixel", 1, {1, 1}},
+};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* value;
+    const char* message;
+} ScaledInvalidData[]{
+    {"scale denominator", "scaleDenominator", "3",
+        "expected scaleDenominator to be 1, 2, 4 or 8 but got 3"},
+    {"target size", "targetSize", "-1",
+        "expected targetSize to be non-negative but got -1"},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -79,11 +126,22 @@ JpegImporterTest::JpegImporterTest() {
               &JpegImporterTest::gray,
               &JpegImporterTest::rgb});
 
+    addInstancedTests({&JpegImporterTest::scaled},
+        Containers::arraySize(ScaledData));
+
+    addInstancedTests({&JpegImporterTest::scaledTargetSize},
+        Containers::arraySize(ScaledTargetSizeData));
+
+    addInstancedTests({&JpegImporterTest::scaledInvalid},
+        Containers::arraySize(ScaledInvalidData));
+
     addInstancedTests({&JpegImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
     addTests({&JpegImporterTest::openTwice,
-              &JpegImporterTest::importTwice});
+              &JpegImporterTest::importTwice,
+
+              &JpegImporterTest::defaultConstructed});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -170,6 +228,57 @@ void JpegImporterTest::rgb() {
     }), TestSuite::Compare::Container);
 }
 
+void JpegImporterTest::scaled() {
+    auto&& data = ScaledData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->addFlags(ImporterFlag::Verbose);
+    importer->configuration().setValue("scaleDenominator", data.scaleDenominator);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Debug redirectOutput{&out};
+        image = importer->image2D(0);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), data.size);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE(out.str(), data.message);
+}
+
+void JpegImporterTest::scaledTargetSize() {
+    auto&& data = ScaledTargetSizeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("targetSize", data.targetSize);
+    /* Should take precedence over this */
+    importer->configuration().setValue("scaleDenominator", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), data.size);
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+}
+
+void JpegImporterTest::scaledInvalid() {
+    auto&& data = ScaledInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue(data.option, data.value);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::JpegImporter::image2D(): {}\n", data.message));
+}
+
 void JpegImporterTest::openMemory() {
     /* same as gray() except that it uses openData() & openMemory() instead of
        openFile() to test data copying on import */
@@ -224,6 +333,26 @@ void JpegImporterTest::importTwice() {
     }
 }
 
+void JpegImporterTest::defaultConstructed() {
+    #ifdef JPEGIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific APIs can be tested only with a static build of the plugin.");
+    #else
+    /* Without a plugin manager there's no configuration file to take the
+       defaults from, verify the constructor fills them in so the import
+       isn't scaled by zero */
+    JpegImporter importer;
+    CORRADE_COMPARE(importer.configuration().value<Int>("scaleDenominator"), 1);
+    CORRADE_COMPARE(importer.configuration().value<Int>("targetSize"), 0);
+
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::JpegImporterTest)
@@ -45,6 +45,12 @@
 #include "Magnum/Implementation/formatPluginsVersion.h"
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
+#ifdef MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
+#include <atomic>
+#include <thread>
+#include <zstd.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
 namespace {
@@ -504,7 +510,7 @@ Containers::Pair<UnsignedInt, UnsignedInt> channelMapping(Implementation::VkForm
     CORRADE_ASSERT_UNREACHABLE("channelMapping(): invalid format suffix" << UnsignedInt(suffix), {}); /* LCOV_EXCL_LINE */
 }
 
-template<typename Format> Containers::Array<char> fillDataFormatDescriptor(Format format, Implementation::VkFormatSuffix suffix) {
+template<typename Format> Containers::Array<char> fillDataFormatDescriptor(Format format, Implementation::VkFormatSuffix suffix, Implementation::SuperCompressionScheme supercompressionScheme) {
     const auto sampleData = samples(format);
     CORRADE_INTERNAL_ASSERT(!sampleData.second().isEmpty());
 
@@ -619,8 +625,11 @@ template<typename Format> Containers::Array<char> fillDataFormatDescriptor(Forma
        an odd exception because as far as Vulkan is concerned, it's a packed
        type (_PACK32), so the byte count is 4, not 3. The check below works
        because Depth24Unorm is the only single-channel format where
-       extent/8 < unitDataSize. */
-    if(samples.size() > 1)
+       extent/8 < unitDataSize. With supercompression, the byte count is
+       required to be zero, as the planes are no longer byte-addressable. */
+    if(supercompressionScheme != Implementation::SuperCompressionScheme::None)
+        header.bytesPlane[0] = 0;
+    else if(samples.size() > 1)
         header.bytesPlane[0] = extent/8;
     else
         header.bytesPlane[0] = unitDataSize;
@@ -683,6 +692,43 @@ void endianSwap(Containers::ArrayView<char> data, UnsignedInt typeSize) {
     CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
+#ifdef MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
+/* Compresses each level independently, distributing the levels across
+   threadCount threads. Largest levels are picked first, as those take the
+   longest. Returns the compressed size for each level in sizes, or a zstd
+   error code if the compression failed. Returns false if a compression
+   context couldn't be created, in which case some levels may be left
+   unprocessed. */
+bool zstdCompressLevels(const Containers::ArrayView<const Containers::Array<char>> levels, const Containers::ArrayView<Containers::Array<char>> compressed, const Containers::ArrayView<std::size_t> sizes, const Int compressionLevel, const UnsignedInt threadCount) {
+    std::atomic<std::size_t> nextLevel{0};
+    std::atomic<bool> contextFailed{false};
+    auto compress = [&]() {
+        ZSTD_CCtx* const context = ZSTD_createCCtx();
+        /* LCOV_EXCL_START */
+        if(!context) {
+            contextFailed = true;
+            return;
+        }
+        /* LCOV_EXCL_STOP */
+        for(std::size_t i; (i = nextLevel++) < levels.size(); ) {
+            compressed[i] = Containers::Array<char>{NoInit, ZSTD_compressBound(levels[i].size())};
+            sizes[i] = ZSTD_compressCCtx(context, compressed[i].data(), compressed[i].size(), levels[i].data(), levels[i].size(), compressionLevel);
+        }
+        ZSTD_freeCCtx(context);
+    };
+
+    /* The calling thread does its share of work as well */
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{compress};
+    compress();
+    for(std::thread& thread: threads)
+        thread.join();
+
+    return !contextFailed;
+}
+#endif
+
 using namespace Containers::Literals;
 
 /* Having this inside convertLevels() leads to errors with GCC 4.8 ("cannot
@@ -709,7 +755,23 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         return {};
     }
 
-    const Containers::Array<char> dataFormatDescriptor = fillDataFormatDescriptor(format, vkFormat.second());
+    const auto supercompression = configuration.value<Containers::StringView>("supercompression");
+    Implementation::SuperCompressionScheme supercompressionScheme;
+    if(!supercompression)
+        supercompressionScheme = Implementation::SuperCompressionScheme::None;
+    else if(supercompression == "zstd"_s) {
+        #ifdef MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
+        supercompressionScheme = Implementation::SuperCompressionScheme::Zstandard;
+        #else
+        Error{} << "Trade::KtxImageConverter::convertToData(): Zstandard supercompression is not supported, the plugin was built without Zstd";
+        return {};
+        #endif
+    } else {
+        Error{} << "Trade::KtxImageConverter::convertToData(): unsupported supercompression scheme" << supercompression;
+        return {};
+    }
+
+    const Containers::Array<char> dataFormatDescriptor = fillDataFormatDescriptor(format, vkFormat.second(), supercompressionScheme);
 
     /* Fill key/value data. Values can be any byte-string but we only write
        constant text strings. Keys must be sorted alphabetically.
@@ -830,10 +892,7 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
     const Vector3i unitSize = formatUnitSize(format);
     const UnsignedInt unitDataSize = formatUnitDataSize(format);
 
-    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
-        /* Mip levels are required to be stored from smallest to largest for
-           efficient streaming */
-        const UnsignedInt mip = levelIndex.size() - 1 - i;
+    for(UnsignedInt mip = 0; mip != levelIndex.size(); ++mip) {
         const Math::Vector<dimensions, Int> mipSize = Math::max(size >> mip, 1)*mipMask + size*(Math::Vector<dimensions, Int>{1} - mipMask);
 
         const auto& image = imageLevels[mip];
@@ -844,19 +903,67 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
             return {};
         }
 
-        /* Offset needs to be aligned to the least common multiple of the
-           texel/block size and 4. Not needed with supercompression. */
-        const std::size_t alignment = leastCommonMultiple(unitDataSize, 4);
-        levelOffset = (levelOffset + alignment - 1)/alignment*alignment;
-
         const Vector3i unitCount = (Vector3i::pad(mipSize, 1) + unitSize - Vector3i{1})/unitSize;
         const std::size_t levelSize = unitDataSize*unitCount.product();
 
-        levelIndex[mip].byteOffset = levelOffset;
         levelIndex[mip].byteLength = levelSize;
         levelIndex[mip].uncompressedByteLength = levelSize;
+    }
 
-        levelOffset += levelSize;
+    /* With supercompression the pixels get copied and endian-swapped into
+       a temporary array for each level first, then each level gets
+       compressed and the level index updated with the compressed sizes. */
+    const UnsignedInt typeSize = formatTypeSize(format);
+    Containers::Array<Containers::Array<char>> supercompressedLevels;
+    #ifdef MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
+    if(supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+        Containers::Array<Containers::Array<char>> levels{numMipmaps};
+        for(UnsignedInt mip = 0; mip != numMipmaps; ++mip) {
+            levels[mip] = Containers::Array<char>{NoInit, std::size_t(levelIndex[mip].uncompressedByteLength)};
+            copyPixels(imageLevels[mip], levels[mip]);
+            endianSwap(levels[mip], typeSize);
+        }
+
+        UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+        if(!threadCount) {
+            threadCount = std::thread::hardware_concurrency();
+            if(converterFlags & ImageConverterFlag::Verbose)
+                Debug{} << "Trade::KtxImageConverter::convertToData(): autodetected hardware concurrency to" << threadCount << "threads";
+        }
+
+        /* There's no point in having more threads than levels. Errors can't
+           be printed from the worker threads as the output redirection is
+           thread-local, so check the sizes afterwards. */
+        supercompressedLevels = Containers::Array<Containers::Array<char>>{numMipmaps};
+        Containers::Array<std::size_t> sizes{NoInit, numMipmaps};
+        if(!zstdCompressLevels(levels, supercompressedLevels, sizes, configuration.value<Int>("zstdLevel"), Math::max(Math::min(threadCount, numMipmaps), 1u))) {
+            Error{} << "Trade::KtxImageConverter::convertToData(): can't create a Zstandard compression context"; /* LCOV_EXCL_LINE */
+            return {}; /* LCOV_EXCL_LINE */
+        }
+        for(UnsignedInt mip = 0; mip != numMipmaps; ++mip) {
+            if(ZSTD_isError(sizes[mip])) {
+                Error{} << "Trade::KtxImageConverter::convertToData(): Zstandard compression of level" << mip << "failed:" << ZSTD_getErrorName(sizes[mip]);
+                return {};
+            }
+            levelIndex[mip].byteLength = sizes[mip];
+        }
+    }
+    #endif
+
+    /* Mip levels are required to be stored from smallest to largest for
+       efficient streaming */
+    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+        const UnsignedInt mip = levelIndex.size() - 1 - i;
+
+        /* Offset needs to be aligned to the least common multiple of the
+           texel/block size and 4. Not needed with supercompression. */
+        if(supercompressionScheme == Implementation::SuperCompressionScheme::None) {
+            const std::size_t alignment = leastCommonMultiple(unitDataSize, 4);
+            levelOffset = (levelOffset + alignment - 1)/alignment*alignment;
+        }
+
+        levelIndex[mip].byteOffset = levelOffset;
+        levelOffset += levelIndex[mip].byteLength;
     }
 
     const std::size_t dataSize = levelOffset;
@@ -870,7 +977,7 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
     Utility::copy(Containers::arrayView(Implementation::KtxFileIdentifier), Containers::arrayView(header.identifier));
 
     header.vkFormat = vkFormat.first();
-    header.typeSize = formatTypeSize(format);
+    header.typeSize = typeSize;
     header.imageSize = Vector3ui{Vector3i::pad(size, 0u)};
     /* Array and cube images have the last dimension 0, instead layer and face
        count is filled. Face count is 6 for cube maps, layer count != 0 only if
@@ -889,15 +996,17 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         header.faceCount = 1;
     }
     header.levelCount = levelIndex.size();
-    header.supercompressionScheme = Implementation::SuperCompressionScheme::None;
+    header.supercompressionScheme = supercompressionScheme;
 
     for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
         const Implementation::KtxLevel& level = levelIndex[i];
-        const auto& image = imageLevels[i];
         const auto pixels = data.sliceSize(level.byteOffset, level.byteLength);
-        copyPixels(image, pixels);
-
-        endianSwap(pixels, header.typeSize);
+        if(supercompressionScheme != Implementation::SuperCompressionScheme::None) {
+            Utility::copy(supercompressedLevels[i].prefix(level.byteLength), pixels);
+        } else {
+            copyPixels(imageLevels[i], pixels);
+            endianSwap(pixels, header.typeSize);
+        }
 
         Utility::Endianness::littleEndianInPlace(
             level.byteOffset, level.byteLength,
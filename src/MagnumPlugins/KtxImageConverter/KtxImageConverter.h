@@ -105,7 +105,11 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 @section Trade-KtxImageConverter-behavior Behavior and limitations
 
 The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
-conversion warnings to be suppressed.
+conversion warnings to be suppressed. The
+@ref ImageConverterFlag::Verbose flag is recognized as well, printing the
+autodetected thread count if the @cb{.ini} threads @ce
+@ref Trade-KtxImageConverter-configuration "configuration option" is set to
+@cb{.ini} 0 @ce.
 
 @subsection Trade-KtxImageConverter-behavior-formats Supported formats
 
@@ -131,14 +135,24 @@ supported.
 
 @subsection Trade-KtxImageConverter-behavior-supercompression Supercompression
 
-Saving files with [supercompression](https://github.khronos.org/KTX-Specification/#supercompressionSchemes)
-is not supported. You can however use @ref BasisImageConverter to create
-Basis-supercompressed KTX2 files.
+If the plugin is built with [Zstd](https://github.com/facebook/zstd), which is
+an optional dependency used if found during the build, the level data can be
+saved with Zstandard [supercompression](https://github.khronos.org/KTX-Specification/#supercompressionSchemes)
+by setting the @cb{.ini} supercompression @ce
+@ref Trade-KtxImageConverter-configuration "configuration option" to
+@cb{.ini} zstd @ce. Compression level is controlled with
+@cb{.ini} zstdLevel @ce. Each level is compressed independently, which means
+the levels can be compressed in parallel with the @cb{.ini} threads @ce option
+and the importer can decompress just the levels it needs. The level index
+then contains the compressed size of each level together with its
+uncompressed size. Other supercompression schemes aren't supported. You can
+however use @ref BasisImageConverter to create Basis-supercompressed KTX2
+files.
 
 @section Trade-KtxImageConverter-configuration Plugin-specific configuration
 
-It's possible to tune various metadata options through @ref configuration().
-See below for all options and their default values:
+It's possible to tune various metadata and supercompression options through
+@ref configuration(). See below for all options and their default values:
 
 @snippet MagnumPlugins/KtxImageConverter/KtxImageConverter.conf configuration_
 
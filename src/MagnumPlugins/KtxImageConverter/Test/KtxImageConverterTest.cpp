@@ -27,12 +27,13 @@
 #include <algorithm> /* std::find() */
 #include <sstream>
 #include <unordered_map>
-#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/PluginManager/PluginMetadata.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -121,6 +122,10 @@ struct KtxImageConverterTest: TestSuite::Tester {
     void configurationEmpty();
     void configurationSorted();
 
+    void supercompressionZstd();
+    void supercompressionZstdNotSupported();
+    void supercompressionInvalid();
+
     void convertTwice();
 
     /* Explicitly forbid system-wide plugin dependencies */
@@ -339,6 +344,18 @@ const struct {
     {"invalid characters", "1012", "invalid characters in swizzle 1012"}
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    ImageConverterFlags flags;
+} SupercompressionZstdData[]{
+    {"", 1, {}},
+    {"2 threads", 2, {}},
+    {"more threads than levels", 16, {}},
+    {"autodetected thread count", 0, {}},
+    {"autodetected thread count, verbose", 0, ImageConverterFlag::Verbose},
+};
+
 Containers::Array<char> readDataFormatDescriptor(Containers::ArrayView<const char> fileData) {
     CORRADE_INTERNAL_ASSERT(fileData.size() >= sizeof(Implementation::KtxHeader));
     const Implementation::KtxHeader& header = *reinterpret_cast<const Implementation::KtxHeader*>(fileData.data());
@@ -439,7 +456,13 @@ KtxImageConverterTest::KtxImageConverterTest() {
     addInstancedTests({&KtxImageConverterTest::configurationEmpty},
         Containers::arraySize(QuietData));
 
-    addTests({&KtxImageConverterTest::configurationSorted,
+    addTests({&KtxImageConverterTest::configurationSorted});
+
+    addInstancedTests({&KtxImageConverterTest::supercompressionZstd},
+        Containers::arraySize(SupercompressionZstdData));
+
+    addTests({&KtxImageConverterTest::supercompressionZstdNotSupported,
+              &KtxImageConverterTest::supercompressionInvalid,
 
               &KtxImageConverterTest::convertTwice});
 
@@ -1441,6 +1464,126 @@ void KtxImageConverterTest::configurationSorted() {
     CORRADE_VERIFY(swizzleOffset.begin() < writerOffset.begin());
 }
 
+void KtxImageConverterTest::supercompressionZstd() {
+    auto&& data = SupercompressionZstdData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
+    CORRADE_SKIP("The plugin was built without Zstd, cannot test");
+    #else
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->addFlags(data.flags);
+    converter->configuration().setValue("supercompression", "zstd");
+    converter->configuration().setValue("threads", data.threads);
+
+    /* A full mip chain of a 64x32 image with a compressible pattern */
+    Containers::Array<Color4ub> levelData[7];
+    Containers::Array<ImageView2D> levels;
+    for(UnsignedInt i = 0; i != Containers::arraySize(levelData); ++i) {
+        const Vector2i size = Math::max(Vector2i{64, 32} >> i, 1);
+        levelData[i] = Containers::Array<Color4ub>{NoInit, std::size_t(size.product())};
+        for(std::size_t j = 0; j != levelData[i].size(); ++j)
+            levelData[i][j] = Color4ub{UnsignedByte(j%size.x()*4), UnsignedByte(j/size.x()*8), UnsignedByte(i*32), 0xff};
+        arrayAppend(levels, InPlaceInit, PixelFormat::RGBA8Unorm, size, levelData[i]);
+    }
+
+    std::ostringstream out;
+    Containers::Optional<Containers::Array<char>> output;
+    {
+        Debug redirectOutput{&out};
+        output = converter->convertToData(levels);
+    }
+    CORRADE_VERIFY(output);
+    if(data.flags & ImageConverterFlag::Verbose)
+        CORRADE_COMPARE_AS(out.str(),
+            "Trade::KtxImageConverter::convertToData(): autodetected hardware concurrency to ",
+            TestSuite::Compare::StringHasPrefix);
+    else
+        CORRADE_COMPARE(out.str(), "");
+
+    const Implementation::KtxHeader& header = *reinterpret_cast<const Implementation::KtxHeader*>(output->data());
+    CORRADE_COMPARE(header.supercompressionScheme, Implementation::SuperCompressionScheme::Zstandard);
+    CORRADE_COMPARE(header.levelCount, 7);
+
+    /* The DFD is the same as for an uncompressed file except for bytesPlane,
+       which is required to be zero with supercompression */
+    const Implementation::VkFormat vkFormat = Utility::Endianness::littleEndian(header.vkFormat);
+    CORRADE_COMPARE(dfdMap.count(vkFormat), 1);
+    Containers::Array<char> dfd = readDataFormatDescriptor(*output);
+    CORRADE_COMPARE(dfd.size(), dfdMap[vkFormat].size());
+    Implementation::KdfBasicBlockHeader& dfdHeader = *reinterpret_cast<Implementation::KdfBasicBlockHeader*>(dfd.data() + sizeof(UnsignedInt));
+    CORRADE_COMPARE(dfdHeader.bytesPlane[0], 0);
+    dfdHeader.bytesPlane[0] = 4;
+    CORRADE_COMPARE_AS(dfd, dfdMap[vkFormat], TestSuite::Compare::Container);
+
+    /* Levels are stored smallest first, tightly packed at the end of the
+       file, with the uncompressed length being the original data size */
+    const auto levelIndex = Containers::arrayCast<const Implementation::KtxLevel>(output->sliceSize(sizeof(Implementation::KtxHeader), 7*sizeof(Implementation::KtxLevel)));
+    CORRADE_COMPARE(levelIndex[0].byteOffset + levelIndex[0].byteLength, output->size());
+    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(levelIndex[i].uncompressedByteLength, levelData[i].size()*4);
+        if(i) CORRADE_COMPARE(levelIndex[i].byteOffset + levelIndex[i].byteLength, levelIndex[i - 1].byteOffset);
+    }
+    /* The largest level should get significantly smaller */
+    CORRADE_COMPARE_AS(levelIndex[0].byteLength, levelIndex[0].uncompressedByteLength/2,
+        TestSuite::Compare::Less);
+
+    /* The output should be the same regardless of the thread count */
+    if(data.threads != 1) {
+        Containers::Pointer<AbstractImageConverter> singleThreaded = _converterManager.instantiate("KtxImageConverter");
+        singleThreaded->configuration().setValue("supercompression", "zstd");
+        Containers::Optional<Containers::Array<char>> expected = singleThreaded->convertToData(levels);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE_AS(*output, *expected, TestSuite::Compare::Container);
+    }
+
+    if(_importerManager.loadState("KtxImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("KtxImporter plugin not found, cannot test");
+
+    /* Assuming KtxImporter is built with Zstd as well since it looks for it
+       the same way */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("KtxImporter");
+    CORRADE_VERIFY(importer->openData(*output));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 7);
+    for(UnsignedInt i = 0; i != levels.size(); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), levels[i].size());
+        CORRADE_COMPARE_AS(image->data(), levels[i].data(), TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void KtxImageConverterTest::supercompressionZstdNotSupported() {
+    #ifdef MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
+    CORRADE_SKIP("The plugin was built with Zstd, cannot test");
+    #else
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "zstd");
+
+    const UnsignedByte bytes[4]{};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, bytes}));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImageConverter::convertToData(): Zstandard supercompression is not supported, the plugin was built without Zstd\n");
+    #endif
+}
+
+void KtxImageConverterTest::supercompressionInvalid() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "lzma");
+
+    const UnsignedByte bytes[4]{};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, bytes}));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImageConverter::convertToData(): unsupported supercompression scheme lzma\n");
+}
+
 void KtxImageConverterTest::convertTwice() {
     Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
 
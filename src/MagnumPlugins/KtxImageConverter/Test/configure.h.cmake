@@ -24,6 +24,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#cmakedefine MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
 #cmakedefine KTXIMAGECONVERTER_PLUGIN_FILENAME "${KTXIMAGECONVERTER_PLUGIN_FILENAME}"
 #cmakedefine KTXIMPORTER_PLUGIN_FILENAME "${KTXIMPORTER_PLUGIN_FILENAME}"
 #define KTXIMPORTER_TEST_DIR "${KTXIMPORTER_TEST_DIR}"
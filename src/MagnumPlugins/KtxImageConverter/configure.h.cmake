@@ -25,3 +25,4 @@
 */
 
 #cmakedefine MAGNUM_KTXIMAGECONVERTER_BUILD_STATIC
+#cmakedefine MAGNUM_KTXIMAGECONVERTER_HAS_ZSTD
@@ -50,6 +50,13 @@
 #include <Magnum/Trade/ImageData.h>
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
+#ifdef MAGNUM_KTXIMPORTER_HAS_ZSTD
+#include <zstd.h>
+#endif
+#ifdef MAGNUM_KTXIMPORTER_HAS_ZLIB
+#include <zlib.h>
+#endif
+
 #ifdef MAGNUM_BUILD_DEPRECATED
 #include <Magnum/Trade/TextureData.h>
 #endif
@@ -280,8 +287,20 @@ struct KtxImporter::File {
     Format pixelFormat;
 
     /* Usually only one image with n or n+1 dimensions, multiple images for
-       3D array layers */
+       3D array layers. If the file is supercompressed, the data views are
+       null until given level is decompressed in doImage(). */
     Containers::Array<Containers::Array<LevelData>> imageData;
+
+    /* Supercompressed level data, indexed by level and shared by all images.
+       Empty if the file isn't supercompressed. */
+    struct SupercompressedLevel {
+        Containers::ArrayView<const char> compressed;
+        std::size_t uncompressedLength;
+        /* Populated on first access in doImage() */
+        Containers::Array<char> decompressed;
+    };
+    Implementation::SuperCompressionScheme supercompressionScheme;
+    Containers::Array<SupercompressedLevel> supercompressedLevels;
 };
 
 KtxImporter::KtxImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
@@ -499,11 +518,24 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
         return;
     }
 
-    /** @todo Support supercompression */
-    if(header.supercompressionScheme != Implementation::SuperCompressionScheme::None) {
-        Error{} << "Trade::KtxImporter::openData(): supercompression is currently not supported";
+    /* Zstandard and ZLIB supercompressed levels get decompressed on demand in
+       doImage(), BasisLZ was handled above already */
+    if(header.supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+        #ifndef MAGNUM_KTXIMPORTER_HAS_ZSTD
+        Error{} << "Trade::KtxImporter::openData(): Zstandard supercompression is not supported, the plugin was built without Zstd";
+        return;
+        #endif
+    } else if(header.supercompressionScheme == Implementation::SuperCompressionScheme::ZLIB) {
+        #ifndef MAGNUM_KTXIMPORTER_HAS_ZLIB
+        Error{} << "Trade::KtxImporter::openData(): ZLIB supercompression is not supported, the plugin was built without zlib";
+        return;
+        #endif
+    } else if(header.supercompressionScheme != Implementation::SuperCompressionScheme::None) {
+        Error{} << "Trade::KtxImporter::openData(): unsupported supercompression scheme" << UnsignedInt(header.supercompressionScheme);
         return;
     }
+    f->supercompressionScheme = header.supercompressionScheme;
+    const bool isSupercompressed = header.supercompressionScheme != Implementation::SuperCompressionScheme::None;
 
     /* typeSize is the size of the format's underlying type, not the texel
        size, e.g. 2 for RG16F. For any sane format it should be a
@@ -566,6 +598,8 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
     f->imageData = Containers::Array<Containers::Array<File::LevelData>>{numImages};
     for(UnsignedInt image = 0; image != numImages; ++image)
         f->imageData[image] = Containers::Array<File::LevelData>{numMipmaps};
+    if(isSupercompressed)
+        f->supercompressedLevels = Containers::Array<File::SupercompressedLevel>{numMipmaps};
 
     Vector3i mipSize{size};
     for(UnsignedInt i = 0; i != numMipmaps; ++i) {
@@ -607,15 +641,35 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
             imageLength = levelSize.product()*f->pixelFormat.size;
         const std::size_t totalLength = imageLength*numImages;
 
-        if(level.byteLength < totalLength) {
-            Error{} << "Trade::KtxImporter::openData(): level data too short, "
-                "expected at least" << totalLength << "bytes but got" << level.byteLength;
-            return;
-        }
+        /* For supercompressed files only the uncompressed length can be
+           checked here, the actual data size is verified after decompressing
+           in doImage(). Until then the data views are null, with just the
+           size being set. The spec requires the uncompressed length to match
+           the level size exactly, which also prevents a crafted file from
+           making doImage() allocate an arbitrary amount of memory. */
+        if(isSupercompressed) {
+            if(level.uncompressedByteLength != totalLength) {
+                Error{} << "Trade::KtxImporter::openData(): expected uncompressed level data of"
+                    << totalLength << "bytes but got" << level.uncompressedByteLength;
+                return;
+            }
+
+            f->supercompressedLevels[i].compressed = f->in.sliceSize(level.byteOffset, level.byteLength);
+            f->supercompressedLevels[i].uncompressedLength = level.uncompressedByteLength;
+            for(UnsignedInt image = 0; image != numImages; ++image)
+                f->imageData[image][i] = {levelSize, {nullptr, imageLength}};
+
+        } else {
+            if(level.byteLength < totalLength) {
+                Error{} << "Trade::KtxImporter::openData(): level data too short, "
+                    "expected at least" << totalLength << "bytes but got" << level.byteLength;
+                return;
+            }
 
-        for(UnsignedInt image = 0; image != numImages; ++image) {
-            const std::size_t offset = level.byteOffset + image*imageLength;
-            f->imageData[image][i] = {levelSize, f->in.sliceSize(offset, imageLength)};
+            for(UnsignedInt image = 0; image != numImages; ++image) {
+                const std::size_t offset = level.byteOffset + image*imageLength;
+                f->imageData[image][i] = {levelSize, f->in.sliceSize(offset, imageLength)};
+            }
         }
 
         /* Halve each dimension, rounding down */
@@ -857,7 +911,58 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
     _f = Utility::move(f);
 }
 
-template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level) {
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> KtxImporter::doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level) {
+    /* Decompress a supercompressed level on first access. The data is shared
+       by all images, so update the views of all of them. */
+    if(!_f->supercompressedLevels.isEmpty() && !_f->supercompressedLevels[level].decompressed) {
+        File::SupercompressedLevel& supercompressedLevel = _f->supercompressedLevels[level];
+        Containers::Array<char> decompressed{NoInit, supercompressedLevel.uncompressedLength};
+
+        #ifdef MAGNUM_KTXIMPORTER_HAS_ZSTD
+        if(_f->supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+            const std::size_t size = ZSTD_decompress(decompressed.data(), decompressed.size(), supercompressedLevel.compressed.data(), supercompressedLevel.compressed.size());
+            if(ZSTD_isError(size)) {
+                Error{} << messagePrefix << "Zstandard decompression of level" << level << "failed:" << ZSTD_getErrorName(size);
+                return {};
+            }
+            if(size != decompressed.size()) {
+                Error{} << messagePrefix << "expected" << decompressed.size() << "bytes of decompressed data for level" << level << "but got" << size;
+                return {};
+            }
+        } else
+        #endif
+        #ifdef MAGNUM_KTXIMPORTER_HAS_ZLIB
+        if(_f->supercompressionScheme == Implementation::SuperCompressionScheme::ZLIB) {
+            uLongf size = decompressed.size();
+            const int result = uncompress(reinterpret_cast<Bytef*>(decompressed.data()), &size, reinterpret_cast<const Bytef*>(supercompressedLevel.compressed.data()), supercompressedLevel.compressed.size());
+            /* Z_BUF_ERROR means the output buffer was too small */
+            if(result == Z_BUF_ERROR) {
+                Error{} << messagePrefix << "expected" << decompressed.size() << "bytes of decompressed data for level" << level << "but got more";
+                return {};
+            }
+            if(result != Z_OK) {
+                Error{} << messagePrefix << "ZLIB decompression of level" << level << "failed with error" << result;
+                return {};
+            }
+            if(size != decompressed.size()) {
+                Error{} << messagePrefix << "expected" << decompressed.size() << "bytes of decompressed data for level" << level << "but got" << size;
+                return {};
+            }
+        } else
+        #endif
+        {
+            /* Other schemes are rejected in doOpenData() */
+            CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        supercompressedLevel.decompressed = Utility::move(decompressed);
+        for(std::size_t image = 0; image != _f->imageData.size(); ++image) {
+            File::LevelData& imageLevelData = _f->imageData[image][level];
+            const std::size_t imageLength = imageLevelData.data.size();
+            imageLevelData.data = supercompressedLevel.decompressed.sliceSize(image*imageLength, imageLength);
+        }
+    }
+
     const File::LevelData& levelData = _f->imageData[id][level];
     const auto size = Math::Vector<dimensions, Int>::pad(levelData.size);
     Containers::Array<char> data{NoInit, levelData.data.size()};
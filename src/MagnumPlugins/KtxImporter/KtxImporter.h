@@ -204,8 +204,24 @@ Calls to the @ref image1DCount() / @ref image2DCount() / @ref image3DCount(),
 
 @subsection Trade-KtxImporter-behavior-supercompression Supercompression
 
-Importing files with [supercompression](https://www.khronos.org/registry/KTX/specs/2.0/ktxspec_v2.html#supercompressionSchemes)
-is not supported. When @ref Trade-KtxImporter-behavior-basis "forwarding Basis Universal compressed files",
+Files with Zstandard and ZLIB [supercompression](https://www.khronos.org/registry/KTX/specs/2.0/ktxspec_v2.html#supercompressionSchemes)
+are supported if the plugin is built with [Zstd](https://github.com/facebook/zstd)
+and [zlib](https://zlib.net/), respectively. Both libraries are optional
+dependencies and are used if found during the build. If the plugin is built
+without the corresponding library, opening such a file fails with an error.
+
+Each mip level is decompressed only when it's first requested through
+@ref image1D() / @ref image2D() / @ref image3D() and the decompressed data are
+then kept for subsequent accesses until the file is closed. Opening a file
+thus only validates the level index and doesn't decompress anything, which
+makes it cheap to import for example just a single level out of a large cube
+map array. An uncompressed byte length in the level index that doesn't match
+the level size is reported already on opening. Errors in the compressed data,
+as well as a decompressed size not matching the uncompressed byte length, are
+reported when importing the affected level.
+
+Other supercompression schemes aren't supported. When
+@ref Trade-KtxImporter-behavior-basis "forwarding Basis Universal compressed files",
 some supercompression schemes like BasisLZ and Zstandard can be handled by
 @ref BasisImporter.
 
@@ -233,7 +249,7 @@ class MAGNUM_KTXIMPORTER_EXPORT KtxImporter: public AbstractImporter {
         MAGNUM_KTXIMPORTER_LOCAL void doClose() override;
         MAGNUM_KTXIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
-        template<UnsignedInt dimensions> MAGNUM_KTXIMPORTER_LOCAL ImageData<dimensions> doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level);
+        template<UnsignedInt dimensions> MAGNUM_KTXIMPORTER_LOCAL Containers::Optional<ImageData<dimensions>> doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level);
 
         MAGNUM_KTXIMPORTER_LOCAL UnsignedInt doImage1DCount() const override;
         MAGNUM_KTXIMPORTER_LOCAL UnsignedInt doImage1DLevelCount(UnsignedInt id) override;
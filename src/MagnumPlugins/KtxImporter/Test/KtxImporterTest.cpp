@@ -109,6 +109,12 @@ struct KtxImporterTest: TestSuite::Tester {
     void image3DCompressed();
     void image3DCompressedMipmaps();
 
+    void supercompression2DMipmaps();
+    void supercompression3DLayers();
+    void supercompressionNotSupported();
+    void supercompressionInvalid();
+    void supercompressionInvalidUncompressedLength();
+
     void forwardBasis();
     void forwardBasisFormat();
     void forwardBasisInvalid();
@@ -261,7 +267,7 @@ const struct {
         "invalid type size for compressed format, expected 1 but got 4"},
     {"supercompression", "2d-rgb.ktx2", {},
         offsetof(Implementation::KtxHeader, supercompressionScheme), 1,
-        "supercompression is currently not supported"},
+        "unsupported supercompression scheme 1"},
     {"3d depth", "3d.ktx2", {},
         offsetof(Implementation::KtxHeader, vkFormat), VK_FORMAT_D32_SFLOAT,
         "3D images can't have depth/stencil format"},
@@ -444,6 +450,57 @@ const struct {
         "Trade::BasisImporter::openData(): missing orientation metadata, assuming Y down. Set the assumeYUp option to suppress this warning.\n"}
 };
 
+const struct {
+    const char* name;
+    const char* file2DMipmaps;
+    const char* file3DLayers;
+    bool supported;
+    const char* message;
+} SupercompressionData[]{
+    {"Zstandard", "2d-mipmaps-zstd.ktx2", "3d-layers-zstd.ktx2",
+        #ifdef MAGNUM_KTXIMPORTER_HAS_ZSTD
+        true,
+        #else
+        false,
+        #endif
+        "Zstandard supercompression is not supported, the plugin was built without Zstd"},
+    {"ZLIB", "2d-mipmaps-zlib.ktx2", "3d-layers-zlib.ktx2",
+        #ifdef MAGNUM_KTXIMPORTER_HAS_ZLIB
+        true,
+        #else
+        false,
+        #endif
+        "ZLIB supercompression is not supported, the plugin was built without zlib"},
+};
+
+const struct {
+    const char* name;
+    const char* file;
+    bool supported;
+    std::size_t offset;
+    char value;
+    const char* message;
+} SupercompressionInvalidData[]{
+    /* Corrupt the zstd frame magic of the first level */
+    {"Zstandard invalid data", "2d-mipmaps-zstd.ktx2",
+        #ifdef MAGNUM_KTXIMPORTER_HAS_ZSTD
+        true,
+        #else
+        false,
+        #endif
+        327, 0,
+        "Zstandard decompression of level 0 failed: Unknown frame descriptor"},
+    /* Corrupt the zlib stream header of the first level */
+    {"ZLIB invalid data", "2d-mipmaps-zlib.ktx2",
+        #ifdef MAGNUM_KTXIMPORTER_HAS_ZLIB
+        true,
+        #else
+        false,
+        #endif
+        325, 0,
+        "ZLIB decompression of level 0 failed with error -3"},
+};
+
 using namespace Containers::Literals;
 
 const struct {
@@ -768,6 +825,15 @@ KtxImporterTest::KtxImporterTest() {
 
     addTests({&KtxImporterTest::image3DCompressedMipmaps});
 
+    addInstancedTests({&KtxImporterTest::supercompression2DMipmaps,
+                       &KtxImporterTest::supercompression3DLayers,
+                       &KtxImporterTest::supercompressionNotSupported,
+                       &KtxImporterTest::supercompressionInvalidUncompressedLength},
+        Containers::arraySize(SupercompressionData));
+
+    addInstancedTests({&KtxImporterTest::supercompressionInvalid},
+        Containers::arraySize(SupercompressionInvalidData));
+
     addInstancedTests({&KtxImporterTest::forwardBasis},
         Containers::arraySize(ForwardBasisData));
 
@@ -1900,6 +1966,150 @@ void KtxImporterTest::image3DCompressedMipmaps() {
     }
 }
 
+void KtxImporterTest::supercompression2DMipmaps() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this scheme, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file2DMipmaps)));
+
+    /* Same as image2DMipmaps() */
+    const auto mip0 = Containers::arrayCast<const Color3ub>(PatternRgbData[0]);
+    const Color3ub mip1[2]{0xffffff_rgb, 0x007f7f_rgb};
+    const Color3ub mip2[1]{0x000000_rgb};
+    const Containers::ArrayView<const Color3ub> mipViews[3]{mip0, mip1, mip2};
+    const Vector2i mipSizes[3]{{4, 3}, {2, 1}, {1, 1}};
+
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), Containers::arraySize(mipViews));
+
+    /* Levels are decompressed on demand, import them out of order and the
+       last one twice to verify the decompressed data get correctly reused */
+    for(UnsignedInt i: {2, 0, 1, 2}) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(!image->isCompressed());
+        CORRADE_COMPARE(image->format(), PixelFormat::RGB8Srgb);
+        CORRADE_COMPARE(image->size(), mipSizes[i]);
+        CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(mipViews[i]), TestSuite::Compare::Container);
+    }
+}
+
+void KtxImporterTest::supercompression3DLayers() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this scheme, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file3DLayers)));
+
+    /* Same as image3DLayers() */
+    const auto layer0 = Containers::arrayCast<const Color3ub>(PatternRgbData);
+    /* Pattern, black, black */
+    Color3ub layer1Data[3][3][4]{};
+    Utility::copy(Containers::arrayView(PatternRgbData[0]), layer1Data[0]);
+    const auto layer1 = Containers::arrayCast<const Color3ub>(layer1Data);
+
+    const Containers::ArrayView<const Color3ub> imageViews[2]{layer0, layer1};
+
+    CORRADE_COMPARE(importer->image3DCount(), Containers::arraySize(imageViews));
+
+    /* All layers are in a single supercompressed level, importing the second
+       layer first should make the first one available as well */
+    for(UnsignedInt i: {1, 0}) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::ImageData3D> image = importer->image3D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->format(), PixelFormat::RGB8Srgb);
+        CORRADE_COMPARE(image->size(), (Vector3i{4, 3, 3}));
+        CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(imageViews[i]), TestSuite::Compare::Container);
+    }
+}
+
+void KtxImporterTest::supercompressionNotSupported() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(data.supported)
+        CORRADE_SKIP("The plugin was built with support for this scheme, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file2DMipmaps)));
+    }
+    CORRADE_COMPARE(out.str(), Utility::format("Trade::KtxImporter::openData(): {}\n", data.message));
+}
+
+void KtxImporterTest::supercompressionInvalidUncompressedLength() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this scheme, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+
+    Containers::Optional<Containers::Array<char>> fileData = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file2DMipmaps));
+    CORRADE_VERIFY(fileData);
+
+    /* The first level is 36 bytes. Neither a larger nor a smaller length is
+       allowed, and a huge value shouldn't result in a huge allocation. */
+    const UnsignedLong lengths[]{35, 37, 0xffffffffffff0000ull};
+    for(UnsignedInt i = 0; i != Containers::arraySize(lengths); ++i) {
+        CORRADE_ITERATION(lengths[i]);
+
+        Implementation::KtxLevel& level = *reinterpret_cast<Implementation::KtxLevel*>(fileData->data() + sizeof(Implementation::KtxHeader));
+        level.uncompressedByteLength = Utility::Endianness::littleEndian(lengths[i]);
+
+        std::ostringstream out;
+        {
+            Error redirectError{&out};
+            CORRADE_VERIFY(!importer->openData(*fileData));
+        }
+        CORRADE_COMPARE(out.str(), Utility::format("Trade::KtxImporter::openData(): expected uncompressed level data of 36 bytes but got {}\n", lengths[i]));
+    }
+}
+
+void KtxImporterTest::supercompressionInvalid() {
+    auto&& data = SupercompressionInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this scheme, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+
+    Containers::Optional<Containers::Array<char>> fileData = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file));
+    CORRADE_VERIFY(fileData);
+    CORRADE_COMPARE_AS(data.offset, fileData->size(), TestSuite::Compare::Less);
+
+    (*fileData)[data.offset] = data.value;
+
+    /* Opening succeeds as the data get decompressed only on import */
+    CORRADE_VERIFY(importer->openData(*fileData));
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->image2D(0, 0));
+    }
+    CORRADE_COMPARE(out.str(), Utility::format("Trade::KtxImporter::image2D(): {}\n", data.message));
+
+    /* Other levels are unaffected */
+    CORRADE_VERIFY(importer->image2D(0, 1));
+}
+
 void KtxImporterTest::forwardBasis() {
     auto&& data = ForwardBasisData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -92,6 +92,13 @@ PVRTexToolCLI -i black.png,pattern.png,pattern.png,black.png,black.png,pattern.p
 printf '\x03\x00\x00\x00\x02\x00\x00\x00' | dd conv=notrunc of=3d-layers.ktx2 bs=1 seek=28
 # TODO: patch up KTXorientation for 3d-layers.ktx2 if we need it for the converter tests
 
+# Supercompressed variants of the above, with a Python script as the Khronos
+# tools don't support ZLIB. Zstandard needs the zstd command-line tool.
+./supercompress.py zstd 2d-mipmaps.ktx2 2d-mipmaps-zstd.ktx2
+./supercompress.py zlib 2d-mipmaps.ktx2 2d-mipmaps-zlib.ktx2
+./supercompress.py zstd 3d-layers.ktx2 3d-layers-zstd.ktx2
+./supercompress.py zlib 3d-layers.ktx2 3d-layers-zlib.ktx2
+
 # Compressed
 # PVRTC and BC* don't support non-power-of-2
 PVRTexToolCLI -i pattern-pot.png -o 2d-compressed-pvrtc.ktx2 -f PVRTC1_4,UBN,sRGB
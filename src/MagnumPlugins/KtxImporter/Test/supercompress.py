@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Takes an uncompressed KTX2 file and writes a copy of it with all levels
+# supercompressed with either Zstandard or ZLIB. Zstandard compression uses
+# the zstd command-line tool, as there's no zstd module in the Python standard
+# library.
+#
+#   ./supercompress.py zstd 2d-mipmaps.ktx2 2d-mipmaps-zstd.ktx2
+
+import struct
+import subprocess
+import sys
+import zlib
+
+scheme, input, output = sys.argv[1:]
+
+with open(input, 'rb') as f:
+    data = f.read()
+
+# Identifier, vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth,
+# layerCount, faceCount, levelCount, supercompressionScheme
+level_count, supercompression_scheme = struct.unpack_from('<II', data, 40)
+assert supercompression_scheme == 0
+levels = [list(struct.unpack_from('<QQQ', data, 80 + i*24)) for i in range(level_count)]
+
+# Level data is expected to be at the end of the file, smallest level first.
+# Everything before it (header, level index, DFD, key/value data) is kept
+# as-is, except for the supercompression scheme and the level index.
+level_data_offset = min(level[0] for level in levels)
+assert max(level[0] + level[1] for level in levels) == len(data)
+out = bytearray(data[:level_data_offset])
+
+if scheme == 'zstd':
+    struct.pack_into('<I', out, 44, 2)
+    compress = lambda level: subprocess.run(['zstd', '-19', '-c', '-q', '--no-check'], input=level, stdout=subprocess.PIPE, check=True).stdout
+elif scheme == 'zlib':
+    struct.pack_into('<I', out, 44, 3)
+    compress = lambda level: zlib.compress(level, 9)
+else: assert False, "unknown scheme {}".format(scheme)
+
+for i in sorted(range(level_count), key=lambda i: levels[i][0]):
+    level = data[levels[i][0]:levels[i][0] + levels[i][1]]
+    compressed = compress(level)
+    struct.pack_into('<QQQ', out, 80 + i*24, len(out), len(compressed), len(level))
+    out += compressed
+
+with open(output, 'wb') as f:
+    f.write(out)
@@ -25,3 +25,5 @@
 */
 
 #cmakedefine MAGNUM_KTXIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_KTXIMPORTER_HAS_ZSTD
+#cmakedefine MAGNUM_KTXIMPORTER_HAS_ZLIB
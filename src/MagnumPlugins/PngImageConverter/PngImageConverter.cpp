@@ -36,18 +36,28 @@
     New versions don't have that anymore: https://github.com/glennrp/libpng/commit/6c2e919c7eb736d230581a4c925fa67bd901fcf8
 */
 #include <csetjmp>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <zlib.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 
 namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
-PngImageConverter::PngImageConverter() = default;
+PngImageConverter::PngImageConverter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("compressionLevel", 6);
+    configuration().setValue("threads", 1);
+}
 
 PngImageConverter::PngImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
 
@@ -59,6 +69,149 @@ Containers::String PngImageConverter::doMimeType() const {
     return "image/png"_s;
 }
 
+namespace {
+
+/* Applies given PNG filter type to a row, writing the filter type byte
+   followed by the filtered bytes to out. For the first image row the previous
+   row is expected to be zero-filled. */
+void filterRow(const UnsignedByte type, const UnsignedByte* const row, const UnsignedByte* const previous, const std::size_t size, const std::size_t pixelSize, UnsignedByte* out) {
+    *out++ = type;
+    switch(type) {
+        case PNG_FILTER_VALUE_NONE:
+            std::memcpy(out, row, size);
+            return;
+        case PNG_FILTER_VALUE_SUB:
+            for(std::size_t i = 0; i != pixelSize; ++i)
+                out[i] = row[i];
+            for(std::size_t i = pixelSize; i != size; ++i)
+                out[i] = row[i] - row[i - pixelSize];
+            return;
+        case PNG_FILTER_VALUE_UP:
+            for(std::size_t i = 0; i != size; ++i)
+                out[i] = row[i] - previous[i];
+            return;
+        case PNG_FILTER_VALUE_AVG:
+            for(std::size_t i = 0; i != pixelSize; ++i)
+                out[i] = row[i] - previous[i]/2;
+            for(std::size_t i = pixelSize; i != size; ++i)
+                out[i] = row[i] - (row[i - pixelSize] + previous[i])/2;
+            return;
+        case PNG_FILTER_VALUE_PAETH:
+            /* For the first pixel the left and upper left neighbors are
+               zero, in which case the predictor is always the upper one */
+            for(std::size_t i = 0; i != pixelSize; ++i)
+                out[i] = row[i] - previous[i];
+            for(std::size_t i = pixelSize; i != size; ++i) {
+                const Int a = row[i - pixelSize];
+                const Int b = previous[i];
+                const Int c = previous[i - pixelSize];
+                const Int pa = Math::abs(b - c);
+                const Int pb = Math::abs(a - c);
+                const Int pc = Math::abs(a + b - 2*c);
+                out[i] = row[i] - (pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+            }
+            return;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Filters rows [begin, end) of the Y-flipped image into out, which is
+   expected to have (end - begin)*(rowSize + 1) bytes. If more than one filter
+   is enabled in the filters mask, picks the one with the smallest sum of
+   absolute differences for each row, same as libpng does. */
+void filterRows(const Containers::StridedArrayView3D<const char>& pixels, const std::size_t begin, const std::size_t end, const bool swap16, const UnsignedInt filters, char* out) {
+    const std::size_t pixelSize = pixels.size()[2];
+    const std::size_t rowSize = pixels.size()[1]*pixelSize;
+
+    /* Byte-swapped copies of the current and previous row for 16-bit images
+       on Little-Endian, a zero-filled row above the first image row and a
+       scratch row for trying out filters */
+    Containers::Array<UnsignedByte> scratch{ValueInit, rowSize*4 + 1};
+    UnsignedByte* const swapped[]{scratch.data(), scratch.data() + rowSize};
+    const UnsignedByte* const zeros = scratch.data() + rowSize*2;
+    UnsignedByte* const candidate = scratch.data() + rowSize*3;
+
+    const auto row = [&](const std::size_t y, UnsignedByte* const swappedRow) -> const UnsignedByte* {
+        const UnsignedByte* const data = static_cast<const UnsignedByte*>(pixels[y].data());
+        if(!swap16) return data;
+        for(std::size_t i = 0; i < rowSize; i += 2) {
+            swappedRow[i] = data[i + 1];
+            swappedRow[i + 1] = data[i];
+        }
+        return swappedRow;
+    };
+
+    const UnsignedByte* previous = begin == 0 ? zeros : row(begin - 1, swapped[(begin - 1) & 1]);
+    for(std::size_t y = begin; y != end; ++y) {
+        const UnsignedByte* const current = row(y, swapped[y & 1]);
+        UnsignedByte* const filtered = reinterpret_cast<UnsignedByte*>(out + (y - begin)*(rowSize + 1));
+
+        /* Just a single filter, no need to evaluate anything */
+        if(!(filters & (filters - 1))) {
+            UnsignedByte type = PNG_FILTER_VALUE_NONE;
+            while(!(filters & (PNG_FILTER_NONE << type))) ++type;
+            filterRow(type, current, previous, rowSize, pixelSize, filtered);
+
+        /* Otherwise try each and keep the best one. The filtered values are
+           treated as signed, ties are resolved in favor of the earlier
+           filter type. */
+        } else {
+            std::size_t bestSum = ~std::size_t{};
+            for(UnsignedByte type = PNG_FILTER_VALUE_NONE; type != PNG_FILTER_VALUE_LAST; ++type) {
+                if(!(filters & (PNG_FILTER_NONE << type))) continue;
+
+                filterRow(type, current, previous, rowSize, pixelSize, candidate);
+                std::size_t sum = 0;
+                for(std::size_t i = 1; i != rowSize + 1; ++i)
+                    sum += candidate[i] < 128 ? candidate[i] : 256 - candidate[i];
+                if(sum < bestSum) {
+                    bestSum = sum;
+                    std::memcpy(filtered, candidate, rowSize + 1);
+                }
+            }
+        }
+
+        previous = current;
+    }
+}
+
+struct Chunk {
+    Containers::Array<char> data;
+    std::size_t size;
+    uLong adler32;
+};
+
+/* Compresses [begin, end) of the filtered data into a raw deflate stream,
+   primed with up to 32 kB of data preceding the range. All chunks except the
+   last are terminated with a sync flush, which byte-aligns them and makes it
+   possible to concatenate them into a single stream. */
+void deflateRows(const Containers::ArrayView<const char> filtered, const std::size_t begin, const std::size_t end, const Int level, const Int strategy, const bool last, Chunk& out) {
+    z_stream stream{};
+    CORRADE_INTERNAL_ASSERT_OUTPUT(deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) == Z_OK);
+    if(begin) {
+        const std::size_t dictionaryBegin = begin > 32768 ? begin - 32768 : 0;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(filtered.data() + dictionaryBegin), begin - dictionaryBegin) == Z_OK);
+    }
+
+    /* Extra space for the sync flush marker, which deflateBound() doesn't
+       account for */
+    out.data = Containers::Array<char>{NoInit, deflateBound(&stream, end - begin) + 16};
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(filtered.data() + begin));
+    stream.avail_in = end - begin;
+    stream.next_out = reinterpret_cast<Bytef*>(out.data.data());
+    stream.avail_out = out.data.size();
+    const Int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    CORRADE_INTERNAL_ASSERT(result == (last ? Z_STREAM_END : Z_OK) && !stream.avail_in && stream.avail_out);
+    static_cast<void>(result);
+    out.size = stream.total_out;
+    deflateEnd(&stream);
+
+    out.adler32 = adler32(1, reinterpret_cast<const Bytef*>(filtered.data() + begin), end - begin);
+}
+
+}
+
 Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData(const ImageView2D& image) {
     /* Warn about lost metadata */
     if((image.flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
@@ -107,6 +260,62 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
             return {};
     }
 
+    /* Compression options */
+    const Int compressionLevel = configuration().value<Int>("compressionLevel");
+    if(compressionLevel < 0 || compressionLevel > 9) {
+        Error{} << "Trade::PngImageConverter::convertToData(): expected compressionLevel to be between 0 and 9, got" << configuration().value<Containers::StringView>("compressionLevel");
+        return {};
+    }
+
+    UnsignedInt filters = 0;
+    for(const Containers::StringView filter: configuration().value<Containers::StringView>("filters").splitOnWhitespaceWithoutEmptyParts()) {
+        /* LCOV_EXCL_START, it makes no sense to test each and every */
+        if(filter == "none"_s)
+            filters |= PNG_FILTER_NONE;
+        else if(filter == "sub"_s)
+            filters |= PNG_FILTER_SUB;
+        else if(filter == "up"_s)
+            filters |= PNG_FILTER_UP;
+        else if(filter == "average"_s)
+            filters |= PNG_FILTER_AVG;
+        else if(filter == "paeth"_s)
+            filters |= PNG_FILTER_PAETH;
+        /* LCOV_EXCL_STOP */
+        else {
+            Error{} << "Trade::PngImageConverter::convertToData(): expected filters to be empty or a combination of none, sub, up, average and paeth, got" << filter;
+            return {};
+        }
+    }
+
+    const Containers::StringView strategyString = configuration().value<Containers::StringView>("strategy");
+    Containers::Optional<Int> strategy;
+    /* LCOV_EXCL_START, it makes no sense to test each and every */
+    if(!strategyString) {}
+    else if(strategyString == "default"_s)
+        strategy = Z_DEFAULT_STRATEGY;
+    else if(strategyString == "filtered"_s)
+        strategy = Z_FILTERED;
+    else if(strategyString == "huffmanOnly"_s)
+        strategy = Z_HUFFMAN_ONLY;
+    else if(strategyString == "rle"_s)
+        strategy = Z_RLE;
+    else if(strategyString == "fixed"_s)
+        strategy = Z_FIXED;
+    /* LCOV_EXCL_STOP */
+    else {
+        Error{} << "Trade::PngImageConverter::convertToData(): expected strategy to be empty or one of default, filtered, huffmanOnly, rle or fixed, got" << strategyString;
+        return {};
+    }
+
+    std::size_t threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) {
+        threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+        if(flags() & ImageConverterFlag::Verbose)
+            Debug{} << "Trade::PngImageConverter::convertToData(): autodetected hardware concurrency to" << threadCount << "threads";
+    }
+    /* Not more threads than there are rows */
+    threadCount = Math::min(threadCount, std::size_t(image.size().y()));
+
     png_structp file = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     /** @todo this will assert if the PNG major/minor version doesn't match,
         with "libpng warning: Application built with libpng-1.7.0 but running
@@ -116,6 +325,10 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
     png_infop info = png_create_info_struct(file);
     CORRADE_INTERNAL_ASSERT(info);
     Containers::Array<char> output;
+    /* Declared here so a longjmp() from the error handler doesn't skip their
+       destructors */
+    Containers::Array<char> filtered;
+    Containers::Array<Chunk> chunks;
 
     /* Error handling routine. Since we're replacing the png_default_error()
        function, we need to call std::longjmp() ourselves -- otherwise the
@@ -145,6 +358,14 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
         arrayAppend(output, {reinterpret_cast<const char*>(data), length});
     }, [](png_structp){});
 
+    /* Compression options for the serial case. Not setting the filters and
+       strategy if not specified in order to use libpng's defaults. */
+    png_set_compression_level(file, compressionLevel);
+    if(filters)
+        png_set_filter(file, PNG_FILTER_TYPE_BASE, filters);
+    if(strategy)
+        png_set_compression_strategy(file, *strategy);
+
     /* Write header */
     png_set_IHDR(file, info, image.size().x(), image.size().y(),
         bitDepth, colorType, PNG_INTERLACE_NONE,
@@ -152,21 +373,104 @@ Containers::Optional<Containers::Array<char>> PngImageConverter::doConvertToData
     png_write_info(file, info);
 
     /* For 16 bit depth we need to swap to big endian */
+    bool swap16 = false;
     if(bitDepth == 16) {
         #ifndef CORRADE_TARGET_BIG_ENDIAN
         png_set_swap(file);
+        swap16 = true;
         #endif
     } else CORRADE_INTERNAL_ASSERT(bitDepth == 8);
 
-    /* Write rows in reverse order. While the rows may have some padding after,
-       the actual pixels in the row should be contiguous so it should be safe
-       to pass a pointer to the first byte of each. */
+    /* Rows are written in reverse order. While the rows may have some padding
+       after, the actual pixels in the row should be contiguous so it should
+       be safe to pass a pointer to the first byte of each. */
     const Containers::StridedArrayView3D<const char> pixelsFlipped = image.pixels().flipped<0>();
     CORRADE_INTERNAL_ASSERT(pixelsFlipped.isContiguous<1>());
-    for(Int y = 0; y != image.size().y(); ++y)
-        png_write_row(file, static_cast<unsigned char*>(const_cast<void*>(pixelsFlipped[y].data())));
 
-    png_write_end(file, nullptr);
+    /* Serial case, let libpng do everything */
+    if(threadCount == 1) {
+        for(Int y = 0; y != image.size().y(); ++y)
+            png_write_row(file, static_cast<unsigned char*>(const_cast<void*>(pixelsFlipped[y].data())));
+
+        png_write_end(file, nullptr);
+
+    /* Otherwise split the rows into chunks, filter and deflate each on a
+       separate thread and then concatenate the deflate streams into a single
+       IDAT zlib stream ourselves */
+    } else {
+        /* Resolve libpng defaults for the options that weren't specified */
+        if(!filters)
+            filters = PNG_ALL_FILTERS;
+        if(!strategy)
+            strategy = filters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+        const std::size_t height = image.size().y();
+        const std::size_t filteredRowSize = image.size().x()*image.pixelSize() + 1;
+        if(flags() & ImageConverterFlag::Verbose)
+            Debug{} << "Trade::PngImageConverter::convertToData(): compressing" << threadCount << "chunks of up to" << (height + threadCount - 1)/threadCount << "rows";
+
+        /* Filtering is done first for all chunks so each chunk can be then
+           primed with the data preceding it. The calling thread handles the
+           first chunk. */
+        filtered = Containers::Array<char>{NoInit, height*filteredRowSize};
+        const auto rowBegin = [&](std::size_t i) {
+            return height*i/threadCount;
+        };
+        Containers::Array<std::thread> threads{threadCount - 1};
+        for(std::size_t i = 0; i != threads.size(); ++i)
+            threads[i] = std::thread{filterRows, pixelsFlipped, rowBegin(i + 1), rowBegin(i + 2), swap16, filters, filtered.data() + rowBegin(i + 1)*filteredRowSize};
+        filterRows(pixelsFlipped, 0, rowBegin(1), swap16, filters, filtered.data());
+        for(std::thread& thread: threads)
+            thread.join();
+
+        chunks = Containers::Array<Chunk>{threadCount};
+        for(std::size_t i = 0; i != threads.size(); ++i)
+            threads[i] = std::thread{deflateRows, Containers::arrayView(filtered), rowBegin(i + 1)*filteredRowSize, rowBegin(i + 2)*filteredRowSize, compressionLevel, *strategy, i + 2 == threadCount, std::ref(chunks[i + 1])};
+        deflateRows(filtered, 0, rowBegin(1)*filteredRowSize, compressionLevel, *strategy, false, chunks[0]);
+        for(std::thread& thread: threads)
+            thread.join();
+
+        /* The zlib header, with the compression level hint calculated the
+           same way as zlib itself does, and the check bits making the header
+           a multiple of 31 */
+        const UnsignedInt levelFlags =
+            *strategy >= Z_HUFFMAN_ONLY || compressionLevel < 2 ? 0 :
+            compressionLevel < 6 ? 1 :
+            compressionLevel == 6 ? 2 : 3;
+        UnsignedInt header = 0x7800|levelFlags << 6;
+        header += 31 - header % 31;
+        const UnsignedByte headerBytes[]{UnsignedByte(header >> 8), UnsignedByte(header)};
+
+        /* Adler-32 checksum of all data, big-endian */
+        uLong checksum = chunks[0].adler32;
+        for(std::size_t i = 1; i != chunks.size(); ++i)
+            checksum = adler32_combine(checksum, chunks[i].adler32, (rowBegin(i + 1) - rowBegin(i))*filteredRowSize);
+        const UnsignedByte checksumBytes[]{
+            UnsignedByte(checksum >> 24),
+            UnsignedByte(checksum >> 16),
+            UnsignedByte(checksum >> 8),
+            UnsignedByte(checksum)
+        };
+
+        /* Write each chunk as a separate IDAT, with the header in the first
+           and checksum in the last */
+        for(std::size_t i = 0; i != chunks.size(); ++i) {
+            const bool first = i == 0;
+            const bool last = i + 1 == chunks.size();
+            png_write_chunk_start(file, reinterpret_cast<png_const_bytep>("IDAT"), chunks[i].size + (first ? 2 : 0) + (last ? 4 : 0));
+            if(first)
+                png_write_chunk_data(file, headerBytes, 2);
+            png_write_chunk_data(file, reinterpret_cast<png_const_bytep>(chunks[i].data.data()), chunks[i].size);
+            if(last)
+                png_write_chunk_data(file, checksumBytes, 4);
+            png_write_chunk_end(file);
+        }
+
+        /* As libpng doesn't know about the IDAT chunks written above,
+           png_write_end() would fail, so the end chunk is written directly */
+        png_write_chunk(file, reinterpret_cast<png_const_bytep>("IEND"), nullptr, 0);
+    }
+
     png_destroy_write_struct(&file, &info);
 
     /* Convert the growable array back to a non-growable with the default
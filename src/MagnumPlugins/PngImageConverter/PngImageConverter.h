@@ -121,7 +121,41 @@ the file is saved as a regular 2D image.
 
 The plugin recognizes @ref ImageConverterFlag::Quiet, which will cause all
 conversion warnings, coming either from the plugin or libpng itself, to be
-suppressed.
+suppressed. @ref ImageConverterFlag::Verbose is recognized as well, printing
+the chunk layout used for parallel compression.
+
+@subsection Trade-PngImageConverter-behavior-compression Compression options
+
+The deflate compression level, row filters and deflate strategy can be
+changed using the @cb{.ini} compressionLevel @ce, @cb{.ini} filters @ce and
+@cb{.ini} strategy @ce @ref Trade-PngImageConverter-configuration "configuration options".
+For fastest possible output, set the level to @cpp 1 @ce and filters to
+@cb{.ini} none @ce, for smallest files set the level to @cpp 9 @ce and keep
+the filters at their default. If filters or strategy are left empty, libpng
+defaults are used.
+
+@subsection Trade-PngImageConverter-behavior-threads Parallel compression
+
+By default the image is filtered and compressed serially on the calling thread
+by libpng. Setting the @cb{.ini} threads @ce
+@ref Trade-PngImageConverter-configuration "configuration option" to a value
+other than @cpp 1 @ce splits the image into horizontal chunks of rows that
+are filtered and deflated in parallel, each on its own thread. The filter
+selection heuristic is the same as libpng's, and each chunk is compressed with
+the last 32 kB of the preceding data as a dictionary, so the compression ratio
+is close to the serial case. The chunks are then concatenated into a single
+zlib stream and written as one IDAT chunk each. The output is thus a regular
+PNG file, but not byte-for-byte equal to the serial output.
+
+@section Trade-PngImageConverter-configuration Plugin-specific configuration
+
+It's possible to tune various output options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/PngImageConverter/PngImageConverter.conf configuration_
+
+See @ref plugins-configuration for more information and an example showing how
+to edit the configuration values.
 */
 class MAGNUM_PNGIMAGECONVERTER_EXPORT PngImageConverter: public AbstractImageConverter {
     public:
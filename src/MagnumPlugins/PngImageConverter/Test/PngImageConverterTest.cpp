@@ -29,7 +29,9 @@
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
@@ -58,6 +60,13 @@ struct PngImageConverterTest: TestSuite::Tester {
 
     void unsupportedMetadata();
 
+    void compressionOptions();
+    void compressionLevelSize();
+    void invalidOption();
+    void threads();
+
+    void benchmarkThreads();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -84,6 +93,75 @@ const struct {
         nullptr},
 };
 
+const struct {
+    const char* name;
+    Int compressionLevel;
+    const char* filters;
+    const char* strategy;
+} CompressionOptionsData[]{
+    {"defaults", 6, "", ""},
+    {"fastest", 1, "none", ""},
+    {"no compression", 0, "none", ""},
+    {"best", 9, "", "default"},
+    {"sub and paeth filter, RLE", 6, "sub paeth", "rle"},
+    {"up filter, Huffman only", 6, "up", "huffmanOnly"},
+    {"average filter, fixed", 6, "average", "fixed"},
+};
+
+const struct {
+    const char* name;
+    const char* key;
+    const char* value;
+    const char* message;
+} InvalidOptionData[]{
+    {"compression level too large", "compressionLevel", "10",
+        "expected compressionLevel to be between 0 and 9, got 10"},
+    {"negative compression level", "compressionLevel", "-1",
+        "expected compressionLevel to be between 0 and 9, got -1"},
+    {"invalid filter", "filters", "up left", "expected filters to be empty or a combination of none, sub, up, average and paeth, got left"},
+    {"invalid strategy", "strategy", "huffman", "expected strategy to be empty or one of default, filtered, huffmanOnly, rle or fixed, got huffman"},
+};
+
+const struct {
+    const char* name;
+    PixelFormat format;
+    Vector2i size;
+    UnsignedInt threads;
+    Int compressionLevel;
+    const char* filters;
+    const char* strategy;
+    const char* message;
+} ThreadsData[]{
+    {"2 threads", PixelFormat::RGB8Unorm, {37, 29}, 2, 6, "", "",
+        "compressing 2 chunks of up to 15 rows"},
+    /* The second chunk starts 64*(256*3 + 1) bytes into the filtered data,
+       so only the last 32 kB before it are used as a dictionary */
+    {"2 threads, chunk past the deflate window", PixelFormat::RGB8Unorm, {256, 128}, 2, 6, "", "",
+        "compressing 2 chunks of up to 64 rows"},
+    {"3 threads, 16-bit", PixelFormat::RGBA16Unorm, {37, 29}, 3, 6, "", "",
+        "compressing 3 chunks of up to 10 rows"},
+    {"5 threads, paeth filter, 16-bit", PixelFormat::RG16Unorm, {37, 29}, 5, 6, "paeth", "",
+        "compressing 5 chunks of up to 6 rows"},
+    {"4 threads, no filter, RLE, best compression", PixelFormat::R8Unorm, {37, 29}, 4, 9, "none", "rle",
+        "compressing 4 chunks of up to 8 rows"},
+    {"4 threads, no compression", PixelFormat::RGBA8Unorm, {37, 29}, 4, 0, "none", "",
+        "compressing 4 chunks of up to 8 rows"},
+    {"more threads than rows", PixelFormat::RG8Unorm, {37, 29}, 64, 6, "sub up", "",
+        "compressing 29 chunks of up to 1 rows"},
+    {"autodetected thread count", PixelFormat::RGB16Unorm, {37, 29}, 0, 6, "", "",
+        nullptr},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} BenchmarkThreadsData[]{
+    {"1 thread", 1},
+    {"2 threads", 2},
+    {"4 threads", 4},
+    {"8 threads", 8},
+};
+
 PngImageConverterTest::PngImageConverterTest() {
     addTests({&PngImageConverterTest::wrongFormat});
 
@@ -99,6 +177,20 @@ PngImageConverterTest::PngImageConverterTest() {
     addInstancedTests({&PngImageConverterTest::unsupportedMetadata},
         Containers::arraySize(UnsupportedMetadataData));
 
+    addInstancedTests({&PngImageConverterTest::compressionOptions},
+        Containers::arraySize(CompressionOptionsData));
+
+    addTests({&PngImageConverterTest::compressionLevelSize});
+
+    addInstancedTests({&PngImageConverterTest::invalidOption},
+        Containers::arraySize(InvalidOptionData));
+
+    addInstancedTests({&PngImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addInstancedBenchmarks({&PngImageConverterTest::benchmarkThreads}, 10,
+        Containers::arraySize(BenchmarkThreadsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef PNGIMAGECONVERTER_PLUGIN_FILENAME
@@ -321,6 +413,143 @@ void PngImageConverterTest::unsupportedMetadata() {
         CORRADE_COMPARE(out.str(), Utility::formatString("Trade::PngImageConverter::convertToData(): {}\n", data.message));
 }
 
+/* Horizontal and vertical gradients, different for each channel, with a bit
+   of noise on top. The gradients are what the sub, up and paeth filters turn
+   into easily compressible data, the noise makes the compression level
+   matter. Meant to be used with one-byte row alignment. */
+Containers::Array<char> gradientImageData(const Vector2i& size, const PixelFormat format) {
+    const std::size_t pixelSize = pixelFormatSize(format);
+    Containers::Array<char> out{NoInit, std::size_t(size.product())*pixelSize};
+    for(std::size_t y = 0; y != std::size_t(size.y()); ++y)
+        for(std::size_t x = 0; x != std::size_t(size.x()); ++x)
+            for(std::size_t c = 0; c != pixelSize; ++c)
+                out[(y*size.x() + x)*pixelSize + c] = char(x*(c + 1) + y*2 + (x*7 + y*13 + c) % 5);
+    return out;
+}
+
+void PngImageConverterTest::compressionOptions() {
+    auto&& data = CompressionOptionsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("compressionLevel", data.compressionLevel);
+    converter->configuration().setValue("filters", data.filters);
+    converter->configuration().setValue("strategy", data.strategy);
+
+    const Containers::Array<char> imageData = gradientImageData({37, 29}, PixelFormat::RGB8Unorm);
+    const ImageView2D image{PixelStorage{}.setAlignment(1),
+        PixelFormat::RGB8Unorm, {37, 29}, imageData};
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(image);
+    CORRADE_VERIFY(out);
+
+    /* With no compression the file is at least as large as the data
+       themselves */
+    if(data.compressionLevel == 0)
+        CORRADE_COMPARE_AS(out->size(), imageData.size(),
+            TestSuite::Compare::Greater);
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE_AS(*converted, image,
+        DebugTools::CompareImage);
+}
+
+void PngImageConverterTest::compressionLevelSize() {
+    const Containers::Array<char> imageData = gradientImageData({128, 128}, PixelFormat::RGB8Unorm);
+    const ImageView2D image{PixelFormat::RGB8Unorm, {128, 128}, imageData};
+
+    Containers::Pointer<AbstractImageConverter> fastestConverter = _converterManager.instantiate("PngImageConverter");
+    fastestConverter->configuration().setValue("compressionLevel", 1);
+    fastestConverter->configuration().setValue("filters", "none");
+    Containers::Optional<Containers::Array<char>> fastest = fastestConverter->convertToData(image);
+    CORRADE_VERIFY(fastest);
+
+    Containers::Pointer<AbstractImageConverter> bestConverter = _converterManager.instantiate("PngImageConverter");
+    bestConverter->configuration().setValue("compressionLevel", 9);
+    Containers::Optional<Containers::Array<char>> best = bestConverter->convertToData(image);
+    CORRADE_VERIFY(best);
+
+    /* The options should actually get passed through to zlib and libpng */
+    CORRADE_COMPARE_AS(fastest->size(), best->size(),
+        TestSuite::Compare::Greater);
+}
+
+void PngImageConverterTest::invalidOption() {
+    auto&& data = InvalidOptionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue(data.key, data.value);
+
+    const char imageData[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData}));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::PngImageConverter::convertToData(): {}\n", data.message));
+}
+
+void PngImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->addFlags(ImageConverterFlag::Verbose);
+    converter->configuration().setValue("threads", data.threads);
+    converter->configuration().setValue("compressionLevel", data.compressionLevel);
+    converter->configuration().setValue("filters", data.filters);
+    converter->configuration().setValue("strategy", data.strategy);
+
+    const Containers::Array<char> imageData = gradientImageData(data.size, data.format);
+    const ImageView2D image{PixelStorage{}.setAlignment(1),
+        data.format, data.size, imageData};
+
+    Containers::Optional<Containers::Array<char>> out;
+    std::ostringstream verbose;
+    {
+        Debug redirectOutput{&verbose};
+        out = converter->convertToData(image);
+    }
+    CORRADE_VERIFY(out);
+    /* The autodetected thread count is system-dependent, so not checking the
+       output in that case */
+    if(data.message)
+        CORRADE_COMPARE(verbose.str(), Utility::formatString("Trade::PngImageConverter::convertToData(): {}\n", data.message));
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE_AS(*converted, image,
+        DebugTools::CompareImage);
+}
+
+void PngImageConverterTest::benchmarkThreads() {
+    auto&& data = BenchmarkThreadsData[testCaseInstanceId()];
+    /* Large enough for each of the eight chunks to be a few times bigger than
+       the 32 kB deflate window, so the per-thread overhead doesn't dominate */
+    setTestCaseDescription(Utility::formatString("{}, 1024x512", data.name));
+
+    const Containers::Array<char> imageData = gradientImageData({1024, 512}, PixelFormat::RGB8Unorm);
+    const ImageView2D image{PixelFormat::RGB8Unorm, {1024, 512}, imageData};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("threads", data.threads);
+
+    Containers::Optional<Containers::Array<char>> out;
+    CORRADE_BENCHMARK(1)
+        out = converter->convertToData(image);
+
+    CORRADE_VERIFY(out);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::PngImageConverterTest)
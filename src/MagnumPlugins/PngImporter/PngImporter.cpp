@@ -38,81 +38,66 @@
 */
 #include <csetjmp> /* setjmp(), libpng why are you still insane */
 #include <Corrade/Containers/Optional.h>
-#include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Configuration.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
 namespace Magnum { namespace Trade {
 
-PngImporter::PngImporter() = default;
-
-PngImporter::PngImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
-
-PngImporter::~PngImporter() = default;
-
-ImporterFeatures PngImporter::doFeatures() const { return ImporterFeature::OpenData; }
+struct PngImporter::State {
+    /* Has to be called before setjmp(), as the jump buffer is a part of the
+       created structure */
+    explicit State(Containers::ArrayView<char> input, ImporterFlags flags, const char* messagePrefix);
 
-bool PngImporter::doIsOpened() const { return _in; }
+    ~State() {
+        png_destroy_read_struct(&file, &info, nullptr);
+    }
 
-void PngImporter::doClose() { _in = nullptr; }
+    /* Reads file information and sets up transformations. Has to be called
+       after setjmp(). */
+    bool readInfo(const Utility::ConfigurationGroup& configuration);
 
-void PngImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
-       can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
-    if(data.isEmpty()) {
-        Error{} << "Trade::PngImporter::openData(): the file is empty";
-        return;
-    }
+    png_structp file;
+    png_infop info;
+    Containers::ArrayView<char> input;
+    ImporterFlags flags;
+    /* Used by the error and warning callbacks, changed by each API that
+       calls into libpng */
+    const char* messagePrefix;
 
-    /* Take over the existing array or copy the data if we can't */
-    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
-        _in = Utility::move(data);
-    } else {
-        _in = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, _in);
-    }
-}
+    /* Filled by readInfo() */
+    PixelFormat format;
+    Vector2i size;
+    bool interlaced;
 
-UnsignedInt PngImporter::doImage2DCount() const { return 1; }
+    /* Count of rows decoded by image2DRows() so far */
+    Int decodedRows = 0;
+};
 
-Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedInt) {
+PngImporter::State::State(const Containers::ArrayView<char> input, const ImporterFlags flags, const char* const messagePrefix): input{input}, flags{flags}, messagePrefix{messagePrefix} {
     /* Structures for reading the file */
-    png_structp file = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    file = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     /** @todo this will assert if the PNG major/minor version doesn't match,
         with "libpng warning: Application built with libpng-1.7.0 but running
         with 1.6.38" being printed to stdout, the proper fix is to set error
         callbacks directly in the png_create_read_struct() call */
     CORRADE_INTERNAL_ASSERT(file);
-    png_infop info = png_create_info_struct(file);
+    info = png_create_info_struct(file);
     CORRADE_INTERNAL_ASSERT(info);
-    /** @todo a capturing ScopeGuard would be nicer :( */
-    struct PngState {
-        png_structp file;
-        png_infop info;
-    } pngState{file, info};
-    Containers::ScopeGuard pngStateGuard{&pngState, [](PngState* state) {
-        png_destroy_read_struct(&state->file, &state->info, nullptr);
-    }};
-    Containers::Array<png_bytep> rows;
-    Containers::Array<char> data;
 
     /* Error handling routine. Since we're replacing the png_default_error()
        function, we need to call std::longjmp() ourselves -- otherwise the
        default error handling with stderr printing kicks in. */
-    if(setjmp(png_jmpbuf(file))) return Containers::NullOpt;
-    png_set_error_fn(file, nullptr, [](const png_structp file, const png_const_charp message) {
-        Error{} << "Trade::PngImporter::image2D(): error:" << message;
+    png_set_error_fn(file, this, [](const png_structp file, const png_const_charp message) {
+        Error{} << static_cast<State*>(png_get_error_ptr(file))->messagePrefix << "error:" << message;
         std::longjmp(png_jmpbuf(file), 1);
-    }, flags() & ImporterFlag::Quiet ?
+    }, flags & ImporterFlag::Quiet ?
         /* MSVC w/o /permissive- "cannot convert <lambda> to <lambda>", ffs.
            Casting just one of the two is enough. */
         #ifndef CORRADE_MSVC_COMPATIBILITY
@@ -120,25 +105,27 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         #else
         static_cast<void(*)(png_structp, png_const_charp)>([](png_structp, png_const_charp) {})
         #endif
-        : [](png_structp, const png_const_charp message) {
-            Warning{} << "Trade::PngImporter::image2D(): warning:" << message;
+        : [](png_structp file, const png_const_charp message) {
+            Warning{} << static_cast<State*>(png_get_error_ptr(file))->messagePrefix << "warning:" << message;
         }
     );
 
     /* Set functions for reading */
-    Containers::ArrayView<char> input = _in;
-    png_set_read_fn(file, &input, [](const png_structp file, const png_bytep data, const png_size_t length) {
+    png_set_read_fn(file, &this->input, [](const png_structp file, const png_bytep data, const png_size_t length) {
         auto&& input = *reinterpret_cast<Containers::ArrayView<char>*>(png_get_io_ptr(file));
         if(input.size() < length) png_error(file, "file too short");
         std::memcpy(data, input.begin(), length);
         input = input.exceptPrefix(length);
     });
+}
 
+bool PngImporter::State::readInfo(const Utility::ConfigurationGroup& configuration) {
     /* Read file information */
     png_read_info(file, info);
 
     /* Image size */
-    const Vector2i size(png_get_image_width(file, info), png_get_image_height(file, info));
+    size = Vector2i(png_get_image_width(file, info), png_get_image_height(file, info));
+    interlaced = png_get_interlace_type(file, info) != PNG_INTERLACE_NONE;
 
     /* Image channels and bit depth */
     png_uint_32 bits = png_get_bit_depth(file, info);
@@ -186,7 +173,7 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         /* We have covered all cases above, but just in case this happens,
            provide a clear message */
         default:
-            CORRADE_ASSERT_UNREACHABLE("Trade::PngImporter::image2D(): unsupported color type" << colorType, );
+            CORRADE_ASSERT_UNREACHABLE(messagePrefix << "unsupported color type" << colorType, {});
         /* LCOV_EXCL_STOP */
     }
 
@@ -206,22 +193,22 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
     }
 
     /* Enable 8-to-16 or 16-to-8 conversion if desired */
-    if(const Int forceBitDepth = configuration().value<Int>("forceBitDepth")) {
+    if(const Int forceBitDepth = configuration.value<Int>("forceBitDepth")) {
         if(forceBitDepth == 8 && bits != 8) {
             CORRADE_INTERNAL_ASSERT(bits == 16);
-            if(flags() & ImporterFlag::Verbose)
-                Debug{} << "Trade::PngImporter::image2D(): stripping" << bits << Debug::nospace << "-bit channels to 8-bit";
+            if(flags & ImporterFlag::Verbose)
+                Debug{} << messagePrefix << "stripping" << bits << Debug::nospace << "-bit channels to 8-bit";
             png_set_scale_16(file);
             bits = 8;
         } else if(forceBitDepth == 16 && bits != 16) {
             CORRADE_INTERNAL_ASSERT(bits == 8);
-            if(flags() & ImporterFlag::Verbose)
-                Debug{} << "Trade::PngImporter::image2D(): expanding" << bits << Debug::nospace << "-bit channels to 16-bit";
+            if(flags & ImporterFlag::Verbose)
+                Debug{} << messagePrefix << "expanding" << bits << Debug::nospace << "-bit channels to 16-bit";
             png_set_expand_16(file);
             bits = 16;
         } else if(forceBitDepth != 8 && forceBitDepth != 16) {
-            Error{} << "Trade::PngImporter::image2D(): expected forceBitDepth to be 0, 8 or 16 but got" << configuration().value<Containers::StringView>("forceBitDepth");
-            return {};
+            Error{} << messagePrefix << "expected forceBitDepth to be 0, 8 or 16 but got" << configuration.value<Containers::StringView>("forceBitDepth");
+            return false;
         }
     }
 
@@ -232,24 +219,12 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         or do detection based on what tool exported the image? such as blender
         producing premultiplied PNGs https://developer.blender.org/T24764 */
 
-    /* Initialize data array, align rows to four bytes */
-    CORRADE_INTERNAL_ASSERT(bits >= 8);
-    const std::size_t stride = ((size.x()*channels*bits/8 + 3)/4)*4;
-    data = Containers::Array<char>{stride*std::size_t(size.y())};
-
     /* Endianness correction for 16 bit depth */
     #ifndef CORRADE_TARGET_BIG_ENDIAN
     if(bits == 16) png_set_swap(file);
     #endif
 
-    /* Read image row by row */
-    rows = Containers::Array<png_bytep>{std::size_t(size.y())};
-    for(Int i = 0; i != size.y(); ++i)
-        rows[i] = reinterpret_cast<unsigned char*>(data.data()) + (size.y() - i - 1)*stride;
-    png_read_image(file, rows);
-
     /* 8-bit images */
-    PixelFormat format;
     if(bits == 8) {
         switch(colorType) {
             case PNG_COLOR_TYPE_GRAY: format = PixelFormat::R8Unorm; break;
@@ -275,8 +250,122 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
        Only 1, 2, 4, 8 or 16 bits per channel, we expand the 1/2/4 to 8 above */
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
+    return true;
+}
+
+PngImporter::PngImporter() = default;
+
+PngImporter::PngImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
+
+PngImporter::~PngImporter() = default;
+
+ImporterFeatures PngImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool PngImporter::doIsOpened() const { return _in; }
+
+void PngImporter::doClose() {
+    _state = nullptr;
+    _in = nullptr;
+}
+
+void PngImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) {
+    /* Because here we're copying the data and using the _in to check if file
+       is opened, having them nullptr would mean openData() would fail without
+       any error message. It's not possible to do this check on the importer
+       side, because empty file is valid in some formats (OBJ or glTF). We also
+       can't do the full import here because then doImage2D() would need to
+       copy the imported data instead anyway (and the uncompressed size is much
+       larger). This way it'll also work nicely with a future openMemory(). */
+    if(data.isEmpty()) {
+        Error{} << "Trade::PngImporter::openData(): the file is empty";
+        return;
+    }
+
+    /* Any decoding in progress references the previous data */
+    _state = nullptr;
+
+    /* Take over the existing array or copy the data if we can't */
+    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+        _in = Utility::move(data);
+    } else {
+        _in = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, _in);
+    }
+}
+
+UnsignedInt PngImporter::doImage2DCount() const { return 1; }
+
+Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    State state{_in, flags(), "Trade::PngImporter::image2D():"};
+    Containers::Array<png_bytep> rows;
+    Containers::Array<char> data;
+
+    if(setjmp(png_jmpbuf(state.file))) return Containers::NullOpt;
+
+    if(!state.readInfo(configuration())) return {};
+
+    /* Initialize data array, align rows to four bytes */
+    const std::size_t stride = ((state.size.x()*pixelFormatSize(state.format) + 3)/4)*4;
+    data = Containers::Array<char>{stride*std::size_t(state.size.y())};
+
+    /* Read image row by row */
+    rows = Containers::Array<png_bytep>{std::size_t(state.size.y())};
+    for(Int i = 0; i != state.size.y(); ++i)
+        rows[i] = reinterpret_cast<unsigned char*>(data.data()) + (state.size.y() - i - 1)*stride;
+    png_read_image(state.file, rows);
+
     /* Always using the default 4-byte alignment */
-    return Trade::ImageData2D{format, size, Utility::move(data)};
+    return Trade::ImageData2D{state.format, state.size, Utility::move(data)};
+}
+
+Containers::Optional<Containers::Pair<PixelFormat, Vector2i>> PngImporter::beginImage2DRows() {
+    CORRADE_ASSERT(isOpened(),
+        "Trade::PngImporter::beginImage2DRows(): no file opened", {});
+
+    /* Discard any previous decoding in progress. The state is heap-allocated
+       as the callbacks reference it. */
+    _state = nullptr;
+    Containers::Pointer<State> state{InPlaceInit, _in, flags(), "Trade::PngImporter::beginImage2DRows():"};
+
+    if(setjmp(png_jmpbuf(state->file))) return {};
+
+    if(!state->readInfo(configuration())) return {};
+
+    /* Adam7-interlaced images have the rows spread over seven passes through
+       the whole image, so there's no way to produce the final rows
+       incrementally */
+    if(state->interlaced) {
+        Error{} << "Trade::PngImporter::beginImage2DRows(): interlaced images can't be decoded in batches of rows";
+        return {};
+    }
+
+    const Containers::Pair<PixelFormat, Vector2i> out{state->format, state->size};
+    _state = Utility::move(state);
+    return out;
+}
+
+Containers::Optional<Int> PngImporter::image2DRows(const MutableImageView2D& destination) {
+    CORRADE_ASSERT(_state,
+        "Trade::PngImporter::image2DRows(): no decoding in progress", {});
+    State& state = *_state;
+    CORRADE_ASSERT(destination.format() == state.format && destination.size().x() == state.size.x(),
+        "Trade::PngImporter::image2DRows(): expected a" << state.format << "destination with width" << state.size.x() << "but got" << destination.format() << "and" << destination.size().x(), {});
+
+    state.messagePrefix = "Trade::PngImporter::image2DRows():";
+    if(setjmp(png_jmpbuf(state.file))) {
+        _state = nullptr;
+        return {};
+    }
+
+    /* Rows in the file go from the top, so decode into the destination from
+       the top as well. The pixels in each row are contiguous. */
+    const Containers::StridedArrayView3D<char> pixels = destination.pixels().flipped<0>();
+    const Int count = Math::min(destination.size().y(), state.size.y() - state.decodedRows);
+    for(Int i = 0; i != count; ++i)
+        png_read_row(state.file, static_cast<png_bytep>(pixels[i].data()), nullptr);
+
+    state.decodedRows += count;
+    return count;
 }
 
 }}
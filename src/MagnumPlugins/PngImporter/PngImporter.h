@@ -30,6 +30,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/PngImporter/configure.h"
@@ -138,6 +139,28 @@ which has the support.
 The test for this plugin contains a file that can be used for verifying CgBI
 support.
 
+@subsection Trade-PngImporter-behavior-rows Decoding in batches of rows
+
+Apart from @ref image2D(), which allocates the output, the image can be
+decoded directly into caller-provided memory, such as a mapped GPU staging
+buffer, in batches of rows. This is available only through the plugin-specific
+@ref beginImage2DRows() and @ref image2DRows() APIs, meaning you need to
+either instantiate the class directly or cast the plugin instance to
+@ref PngImporter. The @ref beginImage2DRows() function reads the file header
+and returns the pixel format and size of the image, then each call to
+@ref image2DRows() decodes as many rows as fit into the destination view. The
+destination row stride and padding is taken from the view's
+@ref PixelStorage, so the rows can be decoded into a larger buffer as well:
+
+@snippet PngImporter.cpp rows
+
+The format and size are the same as @ref image2D() would return, including
+the effect of the @cb{.ini} forceBitDepth @ce
+@ref Trade-PngImporter-configuration "configuration option". As PNG files
+store the rows from the top while Magnum images go from the bottom, the first
+batch contains the topmost rows. Adam7-interlaced images can't be decoded in
+batches of rows, use @ref image2D() for those.
+
 @section Trade-PngImporter-configuration Plugin-specific configuration
 
 For some formats, it's possible to tune various output options through
@@ -158,6 +181,39 @@ class MAGNUM_PNGIMPORTER_EXPORT PngImporter: public AbstractImporter {
 
         ~PngImporter();
 
+        /**
+         * @brief Begin decoding the image in batches of rows
+         * @return Pixel format and size of the image or
+         *      @relativeref{Corrade,Containers::NullOpt} on failure
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened. Reads the file header, after which
+         * the rows can be decoded with @ref image2DRows(). A decoding that's
+         * already in progress is discarded. Prints a message to
+         * @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt} if the header can't be
+         * read or if the image is interlaced. See
+         * @ref Trade-PngImporter-behavior-rows for more information.
+         */
+        Containers::Optional<Containers::Pair<PixelFormat, Vector2i>> beginImage2DRows();
+
+        /**
+         * @brief Decode next batch of rows
+         * @return Count of decoded rows or
+         *      @relativeref{Corrade,Containers::NullOpt} on failure
+         * @m_since_latest_{plugins}
+         *
+         * Expects that @ref beginImage2DRows() was called and succeeded and
+         * that @p destination has the format and width returned from it.
+         * Decodes the next rows from the top of the image into
+         * @p destination, starting from its topmost row, until either the
+         * destination is filled or there are no more rows left. Returns
+         * @cpp 0 @ce once all rows are decoded. On a decoding error prints a
+         * message to @relativeref{Magnum,Error}, discards the decoding in
+         * progress and returns @relativeref{Corrade,Containers::NullOpt}.
+         */
+        Containers::Optional<Int> image2DRows(const MutableImageView2D& destination);
+
     private:
         MAGNUM_PNGIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_PNGIMPORTER_LOCAL bool doIsOpened() const override;
@@ -167,7 +223,10 @@ class MAGNUM_PNGIMPORTER_EXPORT PngImporter: public AbstractImporter {
         MAGNUM_PNGIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_PNGIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
+        struct State;
+
         Containers::Array<char> _in;
+        Containers::Pointer<State> _state;
 };
 
 }}
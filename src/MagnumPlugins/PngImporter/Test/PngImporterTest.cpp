@@ -25,10 +25,12 @@
 
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -43,6 +45,12 @@
 
 #include "configure.h"
 
+/* The plugin-specific APIs can be called only if the plugin is linked
+   directly to the test */
+#ifndef PNGIMPORTER_PLUGIN_FILENAME
+#include "MagnumPlugins/PngImporter/PngImporter.h"
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct PngImporterTest: TestSuite::Tester {
@@ -67,6 +75,10 @@ struct PngImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
 
+    void rows();
+    void rowsInterlaced();
+    void rowsError();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -257,6 +269,22 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    Int batchSize;
+    Int forceBitDepth;
+} RowsData[]{
+    {"RGB16, one row at a time", "rgb16.png", 1, 0},
+    {"RGB16, two rows at a time", "rgb16.png", 2, 0},
+    {"RGB16, all at once", "rgb16.png", 3, 0},
+    {"RGB16, destination larger than the image", "rgb16.png", 5, 0},
+    {"RGB16, forced 8-bit", "rgb16.png", 2, 8},
+    {"palette, one row at a time", "rgb-palette.png", 1, 0},
+    {"RGBA tRNS, two rows at a time", "rgba-trns.png", 2, 0},
+    {"gray 4-bit, forced 16-bit", "gray4.png", 1, 16},
+};
+
 PngImporterTest::PngImporterTest() {
     addTests({&PngImporterTest::empty});
 
@@ -294,6 +322,12 @@ PngImporterTest::PngImporterTest() {
     addTests({&PngImporterTest::openTwice,
               &PngImporterTest::importTwice});
 
+    addInstancedTests({&PngImporterTest::rows},
+        Containers::arraySize(RowsData));
+
+    addTests({&PngImporterTest::rowsInterlaced,
+              &PngImporterTest::rowsError});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef PNGIMPORTER_PLUGIN_FILENAME
@@ -607,6 +641,133 @@ void PngImporterTest::importTwice() {
     }
 }
 
+void PngImporterTest::rows() {
+    auto&& data = RowsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifdef PNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific APIs can be tested only with a static build of the plugin.");
+    #else
+    PngImporter importer;
+    importer.configuration().setValue("forceBitDepth", data.forceBitDepth);
+    CORRADE_VERIFY(importer.openFile(Utility::Path::join(PNGIMPORTER_TEST_DIR, data.filename)));
+
+    /* Import the whole image the regular way for comparison */
+    Containers::Optional<ImageData2D> expected = importer.image2D(0);
+    CORRADE_VERIFY(expected);
+
+    Containers::Optional<Containers::Pair<PixelFormat, Vector2i>> properties = importer.beginImage2DRows();
+    CORRADE_VERIFY(properties);
+    CORRADE_COMPARE(properties->first(), expected->format());
+    CORRADE_COMPARE(properties->second(), expected->size());
+
+    /* Decode into a buffer with rows padded to 16 pixels, filled with a
+       pattern to verify that the padding isn't touched. Going from the top,
+       with each batch being a view on a subset of the rows. */
+    const Vector2i size = properties->second();
+    const std::size_t pixelSize = pixelFormatSize(properties->first());
+    Containers::Array<char> out{DirectInit, 16*pixelSize*size.y(), '\xcd'};
+    Int decoded = 0;
+    for(;;) {
+        /* The last batch may be larger than the remaining rows, in which case
+           it's extended downwards into a separate buffer */
+        const Int remaining = size.y() - decoded;
+        Containers::Array<char> extra;
+        Containers::Optional<Int> count;
+        if(remaining >= data.batchSize) {
+            count = importer.image2DRows(MutableImageView2D{
+                PixelStorage{}.setRowLength(16).setAlignment(1).setSkip({0, remaining - data.batchSize, 0}),
+                properties->first(), {size.x(), data.batchSize}, out});
+        } else {
+            extra = Containers::Array<char>{DirectInit, 16*pixelSize*data.batchSize, '\xcd'};
+            const MutableImageView2D destination{
+                PixelStorage{}.setRowLength(16).setAlignment(1),
+                properties->first(), {size.x(), data.batchSize}, extra};
+            count = importer.image2DRows(destination);
+            /* Copy the topmost rows to where they belong */
+            CORRADE_VERIFY(count);
+            CORRADE_COMPARE(*count, remaining);
+            Utility::copy(extra.exceptPrefix(16*pixelSize*(data.batchSize - remaining)),
+                out.prefix(16*pixelSize*remaining));
+        }
+
+        CORRADE_VERIFY(count);
+        if(!*count) break;
+        CORRADE_COMPARE_AS(*count, data.batchSize,
+            TestSuite::Compare::LessOrEqual);
+        decoded += *count;
+    }
+    CORRADE_COMPARE(decoded, size.y());
+
+    /* Calling again after everything is decoded does nothing */
+    CORRADE_COMPARE(importer.image2DRows(MutableImageView2D{
+        PixelStorage{}.setRowLength(16).setAlignment(1),
+        properties->first(), {size.x(), 1}, out}), 0);
+
+    CORRADE_COMPARE_AS((ImageView2D{
+        PixelStorage{}.setRowLength(16).setAlignment(1),
+        properties->first(), size, out}),
+        *expected,
+        DebugTools::CompareImage);
+
+    /* The padding is left untouched */
+    for(std::size_t y = 0; y != std::size_t(size.y()); ++y) {
+        CORRADE_ITERATION(y);
+        for(char i: out.slice(16*pixelSize*y + size.x()*pixelSize, 16*pixelSize*(y + 1)))
+            CORRADE_COMPARE(i, '\xcd');
+    }
+    #endif
+}
+
+void PngImporterTest::rowsInterlaced() {
+    #ifdef PNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific APIs can be tested only with a static build of the plugin.");
+    #else
+    PngImporter importer;
+    /* Just the header, which is enough for the check */
+    CORRADE_VERIFY(importer.openData(
+        "\x89PNG\x0d\x0a\x1a\x0a"
+        "\x00\x00\x00\x0DIHDR"  /* HDR chunk, 13 bytes */
+        "\x00\x00\x00\x02"      /* width, big-endian */
+        "\x00\x00\x00\x02"      /* height, big-endian */
+        "\x08\x00"              /* bit depth, color type */
+        "\x00\x00\x01"          /* compression, filter, interlace method */
+        "\x20\xda\x62\x6e"      /* hex(zlib.crc32(b'IHDR...')), big-endian */
+        "\x00\x00\x00\x01IDAT"_s));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer.beginImage2DRows());
+    CORRADE_COMPARE(out.str(), "Trade::PngImporter::beginImage2DRows(): interlaced images can't be decoded in batches of rows\n");
+    #endif
+}
+
+void PngImporterTest::rowsError() {
+    #ifdef PNGIMPORTER_PLUGIN_FILENAME
+    CORRADE_SKIP("The plugin-specific APIs can be tested only with a static build of the plugin.");
+    #else
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(PNGIMPORTER_TEST_DIR, "rgb16.png"));
+    CORRADE_VERIFY(file);
+
+    /* Cut the file in the middle of the first IDAT chunk, so the header is
+       read fine but decoding the rows fails */
+    const Containers::StringView idat = Containers::StringView{*file}.find("IDAT"_s);
+    CORRADE_VERIFY(idat);
+
+    PngImporter importer;
+    CORRADE_VERIFY(importer.openData(file->prefix(idat.end() + 2 - file->data())));
+
+    Containers::Optional<Containers::Pair<PixelFormat, Vector2i>> properties = importer.beginImage2DRows();
+    CORRADE_VERIFY(properties);
+
+    Containers::Array<char> out{NoInit, 12*3};
+    std::ostringstream message;
+    Error redirectError{&message};
+    CORRADE_VERIFY(!importer.image2DRows(MutableImageView2D{properties->first(), properties->second(), out}));
+    CORRADE_COMPARE(message.str(), "Trade::PngImporter::image2DRows(): error: file too short\n");
+    #endif
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::PngImporterTest)
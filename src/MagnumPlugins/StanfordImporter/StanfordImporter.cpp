@@ -26,25 +26,49 @@
 
 #include "StanfordImporter.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Containers/StringStlHash.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once <string> is gone here */
 #include <Corrade/Utility/EndiannessBatch.h>
-#include <Corrade/Utility/String.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/MeshTools/Combine.h>
 #include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/MeshData.h>
 
+#if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_MINGW)
+#include <locale.h> /* _create_locale(), _strtod_l() */
+#elif defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_ANDROID)
+#include <locale.h> /* newlocale(), strtod_l() */
+#ifdef CORRADE_TARGET_APPLE
+#include <xlocale.h>
+#endif
+#else
+#include <clocale> /* std::localeconv() */
+#endif
+
 namespace Magnum { namespace Trade {
 
 struct StanfordImporter::State {
+    ~State();
+
     Containers::Array<char> data;
+    /* Flags to use for vertex data referenced directly from data in a
+       zero-copy mesh() */
+    DataFlags dataFlags;
     std::size_t headerSize;
     Containers::Array<MeshAttributeData> attributeData;
     Containers::Array<MeshAttributeData> faceAttributeData;
@@ -52,22 +76,44 @@ struct StanfordImporter::State {
     MeshIndexType faceSizeType{}, faceIndexType{};
     bool fileFormatNeedsEndianSwapping;
 
-    std::unordered_map<std::string, MeshAttribute> attributeNameMap;
-    Containers::Array<std::string> attributeNames;
+    /* While parsing the header the names are views on it, after they're
+       copied to attributeNameStorage */
+    std::unordered_map<Containers::StringView, MeshAttribute> attributeNameMap;
+    Containers::Array<Containers::StringView> attributeNames;
+    Containers::String attributeNameStorage;
+
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    /* If the file was opened with openFile() and no file callback, it's
+       memory-mapped and data is a non-owning view on it */
+    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mappedData;
+    #endif
+
+    /* If the file was opened with openFile() through a file callback, data is
+       a non-owning view on what the callback returned and the callback gets
+       called with InputFileCallbackPolicy::Close on destruction */
+    Containers::Optional<Containers::ArrayView<const char>>(*fileCallback)(const std::string&, InputFileCallbackPolicy, void*){};
+    void* fileCallbackUserData{};
+    std::string filename;
 };
 
+StanfordImporter::State::~State() {
+    if(fileCallback)
+        fileCallback(filename, InputFileCallbackPolicy::Close, fileCallbackUserData);
+}
+
 StanfordImporter::StanfordImporter() {
     /** @todo horrible workaround, fix this properly */
     configuration().setValue("perFaceToPerVertex", true);
     configuration().setValue("triangleFastPath", true);
     configuration().setValue("objectIdAttribute", "object_id");
+    configuration().setValue("zeroCopy", false);
 }
 
 StanfordImporter::StanfordImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
 
 StanfordImporter::~StanfordImporter() = default;
 
-ImporterFeatures StanfordImporter::doFeatures() const { return ImporterFeature::OpenData; }
+ImporterFeatures StanfordImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool StanfordImporter::doIsOpened() const { return !!_state; }
 
@@ -80,7 +126,7 @@ enum class PropertyType {
     Face
 };
 
-MeshIndexType parseIndexType(const std::string& type) {
+MeshIndexType parseIndexType(const Containers::StringView type) {
     if(type == "uchar"  || type == "uint8" ||
        type == "char"   || type == "int8")
         return MeshIndexType::UnsignedByte;
@@ -94,7 +140,7 @@ MeshIndexType parseIndexType(const std::string& type) {
     return {};
 }
 
-VertexFormat parseAttributeType(const std::string& type) {
+VertexFormat parseAttributeType(const Containers::StringView type) {
     if(type == "uchar"  || type == "uint8")
         return VertexFormat::UnsignedByte;
     if(type == "char"   || type == "int8")
@@ -138,17 +184,378 @@ template<class T> T extractIndexValue(const char* buffer, const MeshIndexType ty
     }
 }
 
-std::string extractLine(Containers::ArrayView<const char>& in) {
+/* Returns a view on the next line and advances the input past it. The view
+   points to the input data, so no allocation is done. */
+Containers::StringView extractLine(Containers::ArrayView<const char>& in) {
     for(const char& i: in) if(i == '\n') {
         std::size_t end = &i - in;
         auto out = in.prefix(end);
         in = in.exceptPrefix(end + 1);
-        return {out.begin(), out.end()};
+        return {out.data(), out.size()};
     }
 
     auto out = in;
     in = {};
-    return {out.begin(), out.end()};
+    return {out.data(), out.size()};
+}
+
+inline bool isAsciiWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* Returns the next whitespace-delimited token of a header line or an ASCII
+   element block and advances the iterator past it, or an empty view if
+   there's nothing left. The token is a view on the input. */
+Containers::StringView nextAsciiToken(const char*& it, const char* const end) {
+    while(it != end && isAsciiWhitespace(*it)) ++it;
+    const char* const begin = it;
+    while(it != end && !isAsciiWhitespace(*it)) ++it;
+    return {begin, std::size_t(it - begin)};
+}
+
+/* Splits a header line into whitespace-delimited tokens without allocating.
+   Only the first `size` tokens are stored, but all of them are counted so
+   the caller can detect lines with extra data. */
+template<std::size_t size> std::size_t splitHeaderLine(const Containers::StringView line, Containers::StringView(&tokens)[size]) {
+    const char* it = line.begin();
+    std::size_t count = 0;
+    for(;;) {
+        const Containers::StringView token = nextAsciiToken(it, line.end());
+        if(token.isEmpty()) return count;
+        if(count < size) tokens[count] = token;
+        ++count;
+    }
+}
+
+/* Parses a decimal integer with an optional sign. More than 18 digits are
+   rejected, which is still plenty for all 32-bit types PLY supports and
+   means the value can't overflow. */
+bool parseAsciiInteger(const Containers::StringView token, Long& out) {
+    const char* it = token.begin();
+    const char* const end = token.end();
+    bool negative = false;
+    if(it != end && (*it == '-' || *it == '+')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    if(it == end || end - it > 18) return false;
+
+    Long value = 0;
+    for(; it != end; ++it) {
+        const UnsignedInt digit = UnsignedInt(*it - '0');
+        if(digit > 9) return false;
+        value = value*10 + digit;
+    }
+
+    out = negative ? -value : value;
+    return true;
+}
+
+bool parseElementCount(const Containers::StringView token, UnsignedInt& out) {
+    Long count;
+    if(!parseAsciiInteger(token, count) || count < 0 || count > Long(~UnsignedInt{})) {
+        Error{} << "Trade::StanfordImporter::openData(): invalid element count" << token;
+        return false;
+    }
+
+    out = count;
+    return true;
+}
+
+/* Powers of ten that are exactly representable in a double */
+constexpr Double ExactPowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+/* A "C" locale for parseAsciiFloatSlow(), created on first use and kept
+   until the plugin is unloaded */
+#if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_MINGW)
+struct CLocale {
+    explicit CLocale(): locale{_create_locale(LC_NUMERIC, "C")} {}
+    ~CLocale() { _free_locale(locale); }
+    _locale_t locale;
+};
+#elif defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_ANDROID)
+struct CLocale {
+    explicit CLocale(): locale{newlocale(LC_NUMERIC_MASK, "C", locale_t(0))} {}
+    ~CLocale() { freelocale(locale); }
+    locale_t locale;
+};
+#endif
+
+/* Fallback for values the fast path in parseAsciiFloat() can't handle
+   exactly, such as more than 19 significant digits, large exponents or
+   inf / nan literals. Plain std::strtod() depends on the process locale,
+   which could make it expect a comma as the decimal separator, so a variant
+   with an explicit "C" locale is used where available. Elsewhere the
+   decimal point is replaced with what the current locale expects instead.
+   The token isn't null-terminated, so it's copied to a stack buffer first. */
+bool parseAsciiFloatSlow(const Containers::StringView token, Double& out) {
+    char buffer[64];
+    if(token.size() >= sizeof(buffer)) return false;
+    std::memcpy(buffer, token.data(), token.size());
+    buffer[token.size()] = '\0';
+
+    char* end;
+    #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_MINGW)
+    static const CLocale locale;
+    out = _strtod_l(buffer, &end, locale.locale);
+    #elif defined(CORRADE_TARGET_UNIX) && !defined(CORRADE_TARGET_ANDROID)
+    static const CLocale locale;
+    out = strtod_l(buffer, &end, locale.locale);
+    #else
+    const char decimalPoint = *std::localeconv()->decimal_point;
+    for(char* i = buffer; *i; ++i)
+        if(*i == '.') *i = decimalPoint;
+    out = std::strtod(buffer, &end);
+    #endif
+    return end == buffer + token.size();
+}
+
+/* Parses a decimal floating-point value. If the mantissa fits into 53 bits
+   and the exponent is at most 22, both the mantissa and the power of ten are
+   exactly representable in a double and a single multiplication or division
+   gives a correctly rounded result, otherwise it delegates to
+   parseAsciiFloatSlow(). */
+bool parseAsciiFloat(const Containers::StringView token, Double& out) {
+    const char* it = token.begin();
+    const char* const end = token.end();
+    bool negative = false;
+    if(it != end && (*it == '-' || *it == '+')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    /* Integral and fractional part. Leading zeros don't count towards the
+       significant digits, if there's more significant digits than what fits
+       into 64 bits, go the slow path. */
+    UnsignedLong mantissa = 0;
+    Int significantDigits = 0;
+    Int exponent = 0;
+    bool anyDigits = false;
+    bool slow = false;
+    for(; it != end && UnsignedInt(*it - '0') <= 9; ++it) {
+        anyDigits = true;
+        if(significantDigits == 19) {
+            slow = true;
+            continue;
+        }
+        mantissa = mantissa*10 + (*it - '0');
+        if(mantissa) ++significantDigits;
+    }
+    if(it != end && *it == '.') {
+        ++it;
+        for(; it != end && UnsignedInt(*it - '0') <= 9; ++it) {
+            anyDigits = true;
+            if(significantDigits == 19) {
+                slow = true;
+                continue;
+            }
+            mantissa = mantissa*10 + (*it - '0');
+            if(mantissa) ++significantDigits;
+            --exponent;
+        }
+    }
+
+    /* Possibly an inf or nan, let the slow path decide */
+    if(!anyDigits) return parseAsciiFloatSlow(token, out);
+
+    /* Exponent. Clamping it to avoid overflow, such values go the slow path
+       anyway. */
+    if(it != end && (*it == 'e' || *it == 'E')) {
+        ++it;
+        bool exponentNegative = false;
+        if(it != end && (*it == '-' || *it == '+')) {
+            exponentNegative = *it == '-';
+            ++it;
+        }
+        if(it == end) return false;
+
+        Int explicitExponent = 0;
+        for(; it != end; ++it) {
+            const UnsignedInt digit = UnsignedInt(*it - '0');
+            if(digit > 9) return false;
+            if(explicitExponent < 100000)
+                explicitExponent = explicitExponent*10 + digit;
+        }
+
+        exponent += exponentNegative ? -explicitExponent : explicitExponent;
+    }
+
+    /* Trailing garbage */
+    if(it != end) return false;
+
+    if(slow || mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+        return parseAsciiFloatSlow(token, out);
+
+    Double value = Double(mantissa);
+    if(exponent < 0) value /= ExactPowersOfTen[-exponent];
+    else value *= ExactPowersOfTen[exponent];
+    out = negative ? -value : value;
+    return true;
+}
+
+template<class T> bool parseAsciiIntegerValue(const Containers::StringView token, char* const out) {
+    Long value;
+    if(!parseAsciiInteger(token, value) ||
+       value < Long(std::numeric_limits<T>::min()) ||
+       value > Long(std::numeric_limits<T>::max()))
+        return false;
+
+    const T dest = T(value);
+    std::memcpy(out, &dest, sizeof(T));
+    return true;
+}
+
+template<class T> bool parseAsciiFloatValue(const Containers::StringView token, char* const out) {
+    Double value;
+    if(!parseAsciiFloat(token, value))
+        return false;
+
+    /* Converting a finite value that's out of range of the destination type
+       is undefined behavior. Infinities are representable, so they pass. */
+    if(value != Double(std::numeric_limits<T>::infinity()) &&
+       value != -Double(std::numeric_limits<T>::infinity()) &&
+       (value > Double(std::numeric_limits<T>::max()) ||
+        value < -Double(std::numeric_limits<T>::max())))
+        return false;
+
+    const T dest = T(value);
+    std::memcpy(out, &dest, sizeof(T));
+    return true;
+}
+
+/* Parses a token and writes it in a native binary representation of given
+   format to out, which is expected to have at least vertexFormatSize(format)
+   bytes. Again using memcpy() as the output may be unaligned. */
+bool parseAsciiValue(const Containers::StringView token, const VertexFormat format, char* const out) {
+    switch(format) {
+        /* LCOV_EXCL_START */
+        #define _c(type) case VertexFormat::type: return parseAsciiIntegerValue<type>(token, out);
+        _c(UnsignedByte)
+        _c(Byte)
+        _c(UnsignedShort)
+        _c(Short)
+        _c(UnsignedInt)
+        _c(Int)
+        #undef _c
+        #define _c(type) case VertexFormat::type: return parseAsciiFloatValue<type>(token, out);
+        _c(Float)
+        _c(Double)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+}
+
+/* Indices are interpreted as unsigned, same as in the binary case */
+VertexFormat asciiIndexFormat(const MeshIndexType type) {
+    switch(type) {
+        /* LCOV_EXCL_START */
+        #define _c(type) case MeshIndexType::type: return VertexFormat::type;
+        _c(UnsignedByte)
+        _c(UnsignedShort)
+        _c(UnsignedInt)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+}
+
+/* Converts ASCII vertex and face elements to the same layout a binary file
+   with native endianness would have. Face properties are listed in order,
+   with the vertex index list denoted by VertexFormat{}. */
+Containers::Optional<Containers::Array<char>> convertAsciiData(const Containers::ArrayView<const char> in, const Containers::ArrayView<const VertexFormat> vertexFormats, const UnsignedInt vertexStride, const UnsignedInt vertexCount, const Containers::ArrayView<const VertexFormat> faceFormats, const MeshIndexType faceSizeType, const MeshIndexType faceIndexType, const UnsignedInt faceCount) {
+    const char* it = in.begin();
+    const char* const end = in.end();
+
+    /* Each value is at least one character with a separator after, so this
+       catches bogus vertex counts before allocating for them */
+    if(std::size_t(vertexCount)*vertexFormats.size() > (in.size() + 1)/2) {
+        Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
+        return {};
+    }
+
+    /* Vertex data have a fixed size, faces get appended as they're parsed.
+       Reserving for triangle faces, and only if there's enough values left
+       for them, for the same reason as above. */
+    const VertexFormat faceSizeFormat = asciiIndexFormat(faceSizeType);
+    const VertexFormat faceIndexFormat = asciiIndexFormat(faceIndexType);
+    std::size_t triangleFaceSize = 0;
+    for(const VertexFormat format: faceFormats)
+        triangleFaceSize += format == VertexFormat{} ?
+            vertexFormatSize(faceSizeFormat) + 3*vertexFormatSize(faceIndexFormat) : vertexFormatSize(format);
+    Containers::Array<char> out;
+    arrayReserve(out, std::size_t(vertexStride)*vertexCount +
+        (std::size_t(faceCount)*faceFormats.size() <= (in.size() + 1)/2 ?
+            faceCount*triangleFaceSize : 0));
+
+    char* vertexOut = arrayAppend(out, NoInit, std::size_t(vertexStride)*vertexCount).data();
+    for(UnsignedInt i = 0; i != vertexCount; ++i) {
+        for(const VertexFormat format: vertexFormats) {
+            const Containers::StringView token = nextAsciiToken(it, end);
+            if(token.isEmpty()) {
+                Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
+                return {};
+            }
+            if(!parseAsciiValue(token, format, vertexOut)) {
+                Error{} << "Trade::StanfordImporter::openData(): invalid vertex value" << token;
+                return {};
+            }
+            vertexOut += vertexFormatSize(format);
+        }
+    }
+
+    for(UnsignedInt i = 0; i != faceCount; ++i) {
+        for(const VertexFormat format: faceFormats) {
+            /* Per-face property */
+            if(format != VertexFormat{}) {
+                const Containers::StringView token = nextAsciiToken(it, end);
+                if(token.isEmpty()) {
+                    Error{} << "Trade::StanfordImporter::openData(): incomplete face data";
+                    return {};
+                }
+                if(!parseAsciiValue(token, format, arrayAppend(out, NoInit, vertexFormatSize(format)).data())) {
+                    Error{} << "Trade::StanfordImporter::openData(): invalid face value" << token;
+                    return {};
+                }
+                continue;
+            }
+
+            /* Vertex index list, first the size and then the indices. Face
+               size validity is checked in doMesh(), same as for binary
+               files. */
+            const Containers::StringView sizeToken = nextAsciiToken(it, end);
+            if(sizeToken.isEmpty()) {
+                Error{} << "Trade::StanfordImporter::openData(): incomplete face data";
+                return {};
+            }
+            char* const sizeOut = arrayAppend(out, NoInit, vertexFormatSize(faceSizeFormat)).data();
+            if(!parseAsciiValue(sizeToken, faceSizeFormat, sizeOut)) {
+                Error{} << "Trade::StanfordImporter::openData(): invalid face size" << sizeToken;
+                return {};
+            }
+            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(sizeOut, faceSizeType, false);
+            for(UnsignedInt j = 0; j != faceSize; ++j) {
+                const Containers::StringView token = nextAsciiToken(it, end);
+                if(token.isEmpty()) {
+                    Error{} << "Trade::StanfordImporter::openData(): incomplete index data";
+                    return {};
+                }
+                if(!parseAsciiValue(token, faceIndexFormat, arrayAppend(out, NoInit, vertexFormatSize(faceIndexFormat)).data())) {
+                    Error{} << "Trade::StanfordImporter::openData(): invalid face index" << token;
+                    return {};
+                }
+            }
+        }
+    }
+
+    return Containers::Optional<Containers::Array<char>>{Utility::move(out)};
 }
 
 template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<size, VertexFormat>& formats, const Math::Vector<size, UnsignedInt>& offsets, const char* name) {
@@ -172,6 +579,54 @@ template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<
 
 }
 
+void StanfordImporter::doOpenFile(const Containers::StringView filename) {
+    auto state = Containers::pointer<State>();
+
+    /* If a file callback is set, load the data through it. With
+       InputFileCallbackPolicy::LoadPermanent they stay valid until the
+       importer is closed, so they can be used directly without a copy. */
+    Containers::ArrayView<const char> data;
+    if(fileCallback()) {
+        const Containers::Optional<Containers::ArrayView<const char>> callbackData = fileCallback()(filename, InputFileCallbackPolicy::LoadPermanent, fileCallbackUserData());
+        if(!callbackData) {
+            Error{} << "Trade::StanfordImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        data = *callbackData;
+        state->fileCallback = fileCallback();
+        state->fileCallbackUserData = fileCallbackUserData();
+        state->filename = filename;
+
+    /* Otherwise memory-map the file, if possible, which avoids reading it
+       whole into memory upfront */
+    } else {
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mappedData = Utility::Path::mapRead(filename);
+        if(!mappedData) {
+            Error{} << "Trade::StanfordImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        data = *mappedData;
+        state->mappedData = Utility::move(mappedData);
+        #else
+        AbstractImporter::doOpenFile(filename);
+        return;
+        #endif
+    }
+
+    /* Checked here and not in openInternal() to print the function that was
+       actually called. See doOpenData() for why this is needed. */
+    if(data.isEmpty()) {
+        Error{} << "Trade::StanfordImporter::openFile(): the file is empty";
+        return;
+    }
+
+    /* The data are owned by the state, so pass them as non-owning */
+    openInternal(Utility::move(state), Containers::Array<char>{const_cast<char*>(data.data()), data.size(), [](char*, std::size_t) {}}, {});
+}
+
 void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
@@ -179,7 +634,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
        side, because empty file is valid in some formats (OBJ or glTF). We also
        can't do the full import here because then doImage2D() would need to
        copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
+       larger). */
     if(data.isEmpty()) {
         Error{} << "Trade::StanfordImporter::openData(): the file is empty";
         return;
@@ -194,13 +649,17 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
         Utility::copy(data, dataCopy);
     }
 
-    /* Initialize the state */
-    auto state = Containers::pointer<State>();
+    /* Externally owned memory can be referenced from the output even after
+       the importer is closed */
+    openInternal(Containers::pointer<State>(), Utility::move(dataCopy), dataFlags & DataFlag::ExternallyOwned);
+}
+
+void StanfordImporter::openInternal(Containers::Pointer<State>&& state, Containers::Array<char>&& dataCopy, const DataFlags dataFlags) {
     Containers::ArrayView<const char> in = dataCopy;
 
     /* Check file signature */
     {
-        std::string header = Utility::String::rtrim(extractLine(in));
+        const Containers::StringView header = extractLine(in).trimmedSuffix();
         if(header != "ply") {
             Error{} << "Trade::StanfordImporter::openData(): invalid file signature" << header;
             return;
@@ -209,13 +668,15 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
 
     /* Parse format line */
     Containers::Optional<bool> fileFormatNeedsEndianSwapping;
+    bool ascii = false;
     {
         while(in) {
-            const std::string line = extractLine(in);
-            std::vector<std::string> tokens = Utility::String::splitWithoutEmptyParts(line);
+            const Containers::StringView line = extractLine(in);
+            Containers::StringView tokens[5];
+            const std::size_t tokenCount = splitHeaderLine(line, tokens);
 
             /* Skip empty lines and comments */
-            if(tokens.empty() || tokens.front() == "comment")
+            if(!tokenCount || tokens[0] == "comment")
                 continue;
 
             if(tokens[0] != "format") {
@@ -223,7 +684,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                 return;
             }
 
-            if(tokens.size() != 3) {
+            if(tokenCount != 3) {
                 Error() << "Trade::StanfordImporter::openData(): invalid format line" << line;
                 return;
             }
@@ -235,6 +696,11 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                 } else if(tokens[1] == "binary_big_endian") {
                     fileFormatNeedsEndianSwapping = !Utility::Endianness::isBigEndian();
                     break;
+                } else if(tokens[1] == "ascii") {
+                    /* Converted to native endianness below */
+                    fileFormatNeedsEndianSwapping = false;
+                    ascii = true;
+                    break;
                 }
             }
 
@@ -264,27 +730,35 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
     bool perFaceNormals = false;
     bool perFaceColors = false;
     bool perFaceObjectIds = false;
+    /* Property formats in order, needed for converting ASCII data. The vertex
+       index list is denoted by VertexFormat{}. */
+    Containers::Array<VertexFormat> vertexPropertyFormats;
+    Containers::Array<VertexFormat> facePropertyFormats;
     {
+        const Containers::StringView objectIdAttribute = configuration().value<Containers::StringView>("objectIdAttribute");
         std::size_t vertexComponentOffset{};
         PropertyType propertyType{};
         while(in) {
-            const std::string line = extractLine(in);
-            std::vector<std::string> tokens = Utility::String::splitWithoutEmptyParts(line);
+            const Containers::StringView line = extractLine(in);
+            Containers::StringView tokens[5];
+            const std::size_t tokenCount = splitHeaderLine(line, tokens);
 
             /* Skip empty lines and comments */
-            if(tokens.empty() || tokens.front() == "comment")
+            if(!tokenCount || tokens[0] == "comment")
                 continue;
 
             /* Elements */
             if(tokens[0] == "element") {
                 /* Vertex elements */
-                if(tokens.size() == 3 && tokens[1] == "vertex") {
-                    state->vertexCount = std::stoi(tokens[2]);
+                if(tokenCount == 3 && tokens[1] == "vertex") {
+                    if(!parseElementCount(tokens[2], state->vertexCount))
+                        return;
                     propertyType = PropertyType::Vertex;
 
                 /* Face elements */
-                } else if(tokens.size() == 3 &&tokens[1] == "face") {
-                    state->faceCount = std::stoi(tokens[2]);
+                } else if(tokenCount == 3 && tokens[1] == "face") {
+                    if(!parseElementCount(tokens[2], state->faceCount))
+                        return;
                     propertyType = PropertyType::Face;
 
                 /* Something else */
@@ -297,7 +771,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             } else if(tokens[0] == "property") {
                 /* Vertex element properties */
                 if(propertyType == PropertyType::Vertex) {
-                    if(tokens.size() != 3) {
+                    if(tokenCount != 3) {
                         Error{} << "Trade::StanfordImporter::openData(): invalid vertex property line" << line;
                         return;
                     }
@@ -350,7 +824,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                     } else if(tokens[2] == "alpha") {
                         colorOffsets.w() = vertexComponentOffset;
                         colorFormats.w() = componentFormat;
-                    } else if(tokens[2] == configuration().value("objectIdAttribute")) {
+                    } else if(tokens[2] == objectIdAttribute) {
                         objectIdOffset = vertexComponentOffset;
                         objectIdFormat = componentFormat;
 
@@ -368,13 +842,14 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
 
                     /* Add size of current component to total offset */
                     vertexComponentOffset += vertexFormatSize(componentFormat);
+                    if(ascii) arrayAppend(vertexPropertyFormats, componentFormat);
 
                 /* Face element properties */
                 } else if(propertyType == PropertyType::Face) {
                     /* Face vertex indices. The vertex_indices name is usual,
                        Assimp exports with vertex_index, reference from
                        http://paulbourke.net/dataformats/ply/ mentions both. */
-                    if(tokens.size() == 5 && tokens[1] == "list" && (tokens[4] == "vertex_indices" || tokens[4] == "vertex_index")) {
+                    if(tokenCount == 5 && tokens[1] == "list" && (tokens[4] == "vertex_indices" || tokens[4] == "vertex_index")) {
                         state->faceIndicesOffset = state->faceSkip;
                         state->faceSkip = 0;
 
@@ -390,8 +865,10 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                             return;
                         }
 
+                        if(ascii) arrayAppend(facePropertyFormats, VertexFormat{});
+
                     /* Per-face component */
-                    } else if(tokens.size() == 3) {
+                    } else if(tokenCount == 3) {
                        const VertexFormat componentFormat = parseAttributeType(tokens[1]);
                         if(componentFormat == VertexFormat{}) {
                             Error{} << "Trade::StanfordImporter::openData(): invalid face component type" << tokens[1];
@@ -433,7 +910,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                         } else if(tokens[2] == "alpha") {
                             colorOffsets.w() = faceComponentOffset;
                             colorFormats.w() = componentFormat;
-                        } else if(tokens[2] == configuration().value("objectIdAttribute")) {
+                        } else if(tokens[2] == objectIdAttribute) {
                             perFaceObjectIds = true;
                             objectIdOffset = faceComponentOffset;
                             objectIdFormat = componentFormat;
@@ -451,6 +928,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                         }
 
                         state->faceSkip += vertexFormatSize(componentFormat);
+                        if(ascii) arrayAppend(facePropertyFormats, componentFormat);
 
                     /* Fail on unknown lines */
                     } else {
@@ -637,6 +1115,43 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             objectIdOffset, 0u, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip));
     }
 
+    /* The custom attribute names are views on the header, which doesn't
+       outlive this function for ASCII files. Copy them all to a single
+       allocation and redirect the lookup there. The first name wins in case
+       of duplicates, same as when inserting above. */
+    if(!state->attributeNames.isEmpty()) {
+        std::size_t attributeNameStorageSize = 0;
+        for(const Containers::StringView name: state->attributeNames)
+            attributeNameStorageSize += name.size();
+        state->attributeNameStorage = Containers::String{NoInit, attributeNameStorageSize};
+
+        state->attributeNameMap.clear();
+        char* attributeNameStorage = state->attributeNameStorage.data();
+        for(std::size_t i = 0; i != state->attributeNames.size(); ++i) {
+            Containers::StringView& name = state->attributeNames[i];
+            std::memcpy(attributeNameStorage, name.data(), name.size());
+            name = {attributeNameStorage, name.size()};
+            attributeNameStorage += name.size();
+            state->attributeNameMap.emplace(name, meshAttributeCustom(i));
+        }
+    }
+
+    /* ASCII data get converted to what a binary file with native endianness
+       would contain and then treated the same way in doMesh(). The converted
+       data are owned by the importer so they can't be referenced after it's
+       closed. */
+    if(ascii) {
+        Containers::Optional<Containers::Array<char>> converted = convertAsciiData(in, vertexPropertyFormats, state->vertexStride, state->vertexCount, facePropertyFormats, state->faceSizeType, state->faceIndexType, state->faceCount);
+        if(!converted)
+            return;
+
+        state->data = Utility::move(*converted);
+        state->dataFlags = {};
+        state->headerSize = 0;
+        _state = Utility::move(state);
+        return;
+    }
+
     if(in.size() < state->vertexStride*state->vertexCount) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
         return;
@@ -645,6 +1160,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
     /* All good, move the data to the state struct and save it. Remember header
        size so we can directly access the binary data in doMesh(). */
     state->data = Utility::move(dataCopy);
+    state->dataFlags = dataFlags;
     state->headerSize = state->data.size() - in.size();
     _state = Utility::move(state);
 }
@@ -664,12 +1180,25 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
 
     Containers::ArrayView<const char> in = _state->data.exceptPrefix(_state->headerSize);
 
-    /* Copy all vertex data */
+    /* If the file doesn't need endian swapping and the per-face attributes
+       don't need to be merged, vertex data can be referenced directly, as
+       their layout was already verified to be representable with MeshData
+       during opening */
+    const bool zeroCopy = level == 0 &&
+        configuration().value<bool>("zeroCopy") &&
+        !_state->fileFormatNeedsEndianSwapping &&
+        !(configuration().value<bool>("perFaceToPerVertex") && !_state->faceAttributeData.isEmpty());
+
+    /* Copy all vertex data, unless they're referenced directly */
     Containers::Array<char> vertexData;
-    if(level == 0) {
+    Containers::ArrayView<const char> vertexDataView;
+    if(zeroCopy) {
+        vertexDataView = in.prefix(_state->vertexStride*_state->vertexCount);
+    } else if(level == 0) {
         vertexData = Containers::Array<char>{NoInit,
         _state->vertexStride*_state->vertexCount};
         Utility::copy(in.prefix(vertexData.size()), vertexData);
+        vertexDataView = vertexData;
     }
     in = in.exceptPrefix(_state->vertexStride*_state->vertexCount);
 
@@ -793,7 +1322,7 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
             vertexAttributeData[i] = MeshAttributeData{
                 _state->attributeData[i].name(),
                 _state->attributeData[i].format(),
-                _state->attributeData[i].data(vertexData)};
+                _state->attributeData[i].data(vertexDataView)};
         }
     }
 
@@ -867,7 +1396,12 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
         return MeshTools::combineFaceAttributes(perVertex, perFace);
     }
 
-    if(level == 0) {
+    if(zeroCopy) {
+        MeshIndexData indices{_state->faceIndexType, indexData};
+        return MeshData{MeshPrimitive::Triangles,
+            Utility::move(indexData), indices,
+            _state->dataFlags, vertexDataView, Utility::move(vertexAttributeData)};
+    } else if(level == 0) {
         MeshIndexData indices{_state->faceIndexType, indexData};
         return MeshData{MeshPrimitive::Triangles,
             Utility::move(indexData), indices,
@@ -879,7 +1413,9 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
 }
 
 MeshAttribute StanfordImporter::doMeshAttributeForName(const Containers::StringView name) {
-    return _state ? _state->attributeNameMap[name] : MeshAttribute{};
+    if(!_state) return {};
+    const auto found = _state->attributeNameMap.find(name);
+    return found == _state->attributeNameMap.end() ? MeshAttribute{} : found->second;
 }
 
 Containers::String StanfordImporter::doMeshAttributeName(MeshAttribute name) {
@@ -108,8 +108,18 @@ In order to optimize for fast import, the importer supports a restricted subset
 of PLY features, which however shouldn't affect any real-world models.
 
 -   Both Little- and Big-Endian binary files are supported, with bytes swapped
-    to match platform endianness. ASCII files are not supported due to the
-    storage size overhead and inherent inefficiency of float literal parsing.
+    to match platform endianness.
+-   ASCII files are supported as well, with their contents converted to a
+    binary representation in platform endianness on opening. Numbers are
+    parsed directly from the file data without any per-line allocations;
+    floating-point values with more than 19 significant digits, exponents
+    outside of @f$ [-22, 22] @f$, `inf` or `nan` go through a slower
+    @ref std::strtod() fallback. Both are independent of the locale set in
+    the application, a dot is always the decimal separator. Because the whole
+    file is processed upfront, malformed or incomplete face data are reported
+    already during opening instead of in @ref mesh(). As the converted data
+    are owned by the importer, the @cb{.ini} zeroCopy @ce option references
+    them without any @ref DataFlag set.
 -   Position coordinates (`x`/`y`/`z`) are expected to have the same type, be
     tightly packed in a XYZ order and be either 32-bit floats or (signed) bytes
     or shorts. Resulting position type is then
@@ -181,6 +191,29 @@ From the builtin attributes, colors, normals and object IDs can be either
 per-vertex or per-face, positions and texture coordinates are always
 per-vertex.
 
+@subsection Trade-StanfordImporter-behavior-zero-copy Zero-copy import
+
+The importer supports @ref ImporterFeature::OpenData and
+@relativeref{ImporterFeature,FileCallback}. Files opened with
+@ref openFile() are memory-mapped on platforms that support it, and if a file
+callback is set, the file is loaded through it with
+@ref InputFileCallbackPolicy::LoadPermanent and
+@relativeref{InputFileCallbackPolicy,Close} is called once the importer is
+closed. In both cases the file contents aren't copied on opening.
+
+By default the vertex data are still copied into the returned @ref MeshData.
+If the @cb{.ini} zeroCopy @ce
+@ref Trade-StanfordImporter-configuration "configuration option" is enabled,
+the file endianness matches the platform and there are no per-face attributes
+to be converted to per-vertex, the mesh at <tt>level</tt> @cpp 0 @ce
+references the vertex data directly instead. Its
+@ref MeshData::vertexDataFlags() are then either empty, meaning the data are
+valid only as long as the importer stays opened, or
+@ref DataFlag::ExternallyOwned if the file was opened with @ref openMemory(),
+in which case the data are valid for as long as the passed memory stays alive.
+Index data are copied always, as they're interleaved with face sizes in the
+file.
+
 @subsection Trade-StanfordImporter-behavior-custom-attributes Custom attributes
 
 Custom and unrecognized vertex and face attributes of known types are present
@@ -213,6 +246,7 @@ class MAGNUM_STANFORDIMPORTER_EXPORT StanfordImporter: public AbstractImporter {
         MAGNUM_STANFORDIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
         MAGNUM_STANFORDIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_STANFORDIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_STANFORDIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
         MAGNUM_STANFORDIMPORTER_LOCAL void doClose() override;
 
@@ -223,6 +257,8 @@ class MAGNUM_STANFORDIMPORTER_EXPORT StanfordImporter: public AbstractImporter {
         MAGNUM_STANFORDIMPORTER_LOCAL Containers::String doMeshAttributeName(MeshAttribute name) override;
 
         struct State;
+        MAGNUM_STANFORDIMPORTER_LOCAL void openInternal(Containers::Pointer<State>&& state, Containers::Array<char>&& data, DataFlags dataFlags);
+
         Containers::Pointer<State> _state;
 };
 
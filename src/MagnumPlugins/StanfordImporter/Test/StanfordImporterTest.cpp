@@ -23,9 +23,15 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <clocale>
 #include <sstream>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
@@ -35,6 +41,7 @@
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/AbstractImporter.h>
@@ -54,6 +61,7 @@ struct StanfordImporterTest: TestSuite::Tester {
     void parse();
     void parsePerFace();
     void parsePerFaceToPerVertex();
+    void parseAsciiFloatSlowPath();
     void empty();
 
     void customAttributes();
@@ -65,9 +73,14 @@ struct StanfordImporterTest: TestSuite::Tester {
     void triangleFastPathPerFaceToPerVertex();
 
     void openMemory();
+    void zeroCopy();
+    void fileCallback();
+    void fileCallbackNotFound();
     void openTwice();
     void importTwice();
 
+    void benchmarkOpen();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -80,12 +93,13 @@ constexpr struct {
     {"invalid-signature", "invalid file signature bla", true},
 
     {"format-invalid", "invalid format line format binary_big_endian 1.0 extradata", true},
-    {"format-unsupported", "unsupported file format ascii 1.0", true},
+    {"format-unsupported", "unsupported file format ascii 2.0", true},
     {"format-missing", "missing format line", true},
     {"format-too-late", "expected format line, got element face 1", true},
 
     {"unknown-line", "unknown line heh", true},
     {"unknown-element", "unknown element edge", true},
+    {"invalid-element-count", "invalid element count five", true},
 
     {"unexpected-property", "unexpected property line", true},
     {"invalid-vertex-property", "invalid vertex property line property float x extradata", true},
@@ -122,7 +136,26 @@ constexpr struct {
 
     {"objectid-unsupported-type", "unsupported object ID type VertexFormat::Float", true},
 
-    {"unsupported-face-size", "unsupported face size 5", false}
+    {"unsupported-face-size", "unsupported face size 5", false},
+
+    {"ascii-invalid-vertex-value", "invalid vertex value 1.0f", true},
+    {"ascii-vertex-value-out-of-range", "invalid vertex value 256", true},
+    {"ascii-vertex-float-value-out-of-range", "invalid vertex value 1e39", true},
+    {"ascii-incomplete-vertex-data", "incomplete vertex data", true},
+    {"ascii-invalid-face-value", "invalid face value nope", true},
+    {"ascii-invalid-face-size", "invalid face size -3", true},
+    {"ascii-invalid-face-index", "invalid face index 0x1", true},
+    {"ascii-incomplete-face-data", "incomplete face data", true},
+    {"ascii-incomplete-index-data", "incomplete index data", true}
+};
+
+constexpr struct {
+    const char* name;
+    const char* filename;
+} BenchmarkOpenData[]{
+    {"binary", "positions-colors-normals-texcoords-float-objectid-uint-indices-int.ply"},
+    {"binary, custom attributes", "custom-components.ply"},
+    {"ASCII", "ascii-positions-colors-normals-texcoords-float-objectid-uint-indices-int.ply"}
 };
 
 constexpr struct {
@@ -177,6 +210,17 @@ constexpr struct {
         VertexFormat::Vector3ub, VertexFormat{},
         VertexFormat::Vector3bNormalized, VertexFormat{},
         VertexFormat::UnsignedShort, "OBJECTID", 3, 0},
+    /* ASCII variants of the above, with numbers in various notations */
+    {"ascii-positions-colors-normals-texcoords-float-objectid-uint-indices-int",
+        MeshIndexType::UnsignedInt,
+        VertexFormat::Vector3, VertexFormat::Vector3,
+        VertexFormat::Vector3, VertexFormat::Vector2,
+        VertexFormat::UnsignedInt, nullptr, 5, 0},
+    {"ascii-positions-uchar-normals-char-objectid-short-indices-ushort",
+        MeshIndexType::UnsignedShort,
+        VertexFormat::Vector3ub, VertexFormat{},
+        VertexFormat::Vector3bNormalized, VertexFormat{},
+        VertexFormat::UnsignedShort, "OBJECTID", 3, 0},
     {"positions-char-colors4-ushort-texcoords-uchar-indices-short-be",
         MeshIndexType::UnsignedShort,
         VertexFormat::Vector3b, VertexFormat::Vector4usNormalized,
@@ -227,7 +271,11 @@ constexpr struct {
     {"per-face normals, object ids, verbose", "per-face-normals-objectid.ply", 2,
         MeshIndexType::UnsignedByte,
         VertexFormat{}, VertexFormat::Vector3, VertexFormat::UnsignedShort,
-        ImporterFlag::Verbose, "Trade::StanfordImporter::mesh(): converting 2 per-face attributes to per-vertex\n"}
+        ImporterFlag::Verbose, "Trade::StanfordImporter::mesh(): converting 2 per-face attributes to per-vertex\n"},
+    {"per-face normals, object ids, ASCII", "ascii-per-face-normals-objectid.ply", 2,
+        MeshIndexType::UnsignedByte,
+        VertexFormat{}, VertexFormat::Vector3, VertexFormat::UnsignedShort,
+        {}, ""}
 };
 
 constexpr struct {
@@ -242,7 +290,10 @@ constexpr struct {
     const char* filename;
 } CustomAttributeData[]{
     {"custom-components"},
-    {"custom-components-be"}
+    {"custom-components-be"},
+    /* The header isn't kept for ASCII files, so this verifies the names
+       don't reference it */
+    {"ascii-custom-components"}
 };
 
 constexpr struct {
@@ -269,6 +320,40 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    bool(*open)(AbstractImporter&, Containers::StringView, Containers::ArrayView<const char>);
+    bool zeroCopy;
+    DataFlags expectedDataFlags;
+    bool expectReferenced;
+} ZeroCopyData[]{
+    {"file", "positions-float-indices-uint.ply",
+        [](AbstractImporter& importer, Containers::StringView filename, Containers::ArrayView<const char>) {
+            return importer.openFile(filename);
+        }, true, {}, false},
+    {"memory", "positions-float-indices-uint.ply",
+        [](AbstractImporter& importer, Containers::StringView, Containers::ArrayView<const char> data) {
+            return importer.openMemory(data);
+        }, true, DataFlag::ExternallyOwned, true},
+    {"data", "positions-float-indices-uint.ply",
+        [](AbstractImporter& importer, Containers::StringView, Containers::ArrayView<const char> data) {
+            return importer.openData(data);
+        }, true, {}, false},
+    {"memory, disabled", "positions-float-indices-uint.ply",
+        [](AbstractImporter& importer, Containers::StringView, Containers::ArrayView<const char> data) {
+            return importer.openMemory(data);
+        }, false, DataFlag::Owned|DataFlag::Mutable, false},
+    {"memory, big-endian", "positions-colors-normals-texcoords-float-objectid-uint-indices-int-be.ply",
+        [](AbstractImporter& importer, Containers::StringView, Containers::ArrayView<const char> data) {
+            return importer.openMemory(data);
+        }, true, DataFlag::Owned|DataFlag::Mutable, false},
+    {"memory, per-face to per-vertex", "per-face-normals-objectid.ply",
+        [](AbstractImporter& importer, Containers::StringView, Containers::ArrayView<const char> data) {
+            return importer.openMemory(data);
+        }, true, DataFlag::Owned|DataFlag::Mutable, false},
+};
+
 StanfordImporterTest::StanfordImporterTest() {
     addInstancedTests({&StanfordImporterTest::invalid},
         Containers::arraySize(InvalidData));
@@ -285,6 +370,8 @@ StanfordImporterTest::StanfordImporterTest() {
                        &StanfordImporterTest::parsePerFaceToPerVertex},
         Containers::arraySize(ParsePerFaceData));
 
+    addTests({&StanfordImporterTest::parseAsciiFloatSlowPath});
+
     addInstancedTests({&StanfordImporterTest::empty},
         Containers::arraySize(EmptyData));
 
@@ -302,9 +389,18 @@ StanfordImporterTest::StanfordImporterTest() {
     addInstancedTests({&StanfordImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
+    addInstancedTests({&StanfordImporterTest::zeroCopy},
+        Containers::arraySize(ZeroCopyData));
+
+    addTests({&StanfordImporterTest::fileCallback,
+              &StanfordImporterTest::fileCallbackNotFound});
+
     addTests({&StanfordImporterTest::openTwice,
               &StanfordImporterTest::importTwice});
 
+    addInstancedBenchmarks({&StanfordImporterTest::benchmarkOpen}, 10,
+        Containers::arraySize(BenchmarkOpenData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STANFORDIMPORTER_PLUGIN_FILENAME
@@ -336,7 +432,17 @@ void StanfordImporterTest::fileEmpty() {
     std::ostringstream out;
     Error redirectError{&out};
     CORRADE_VERIFY(!importer->openData(nullptr));
-    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::StanfordImporter::openData(): the file is empty\n"));
+
+    /* The file is not read through openData() in this case, so the message
+       should mention the function that was actually called */
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy, void*) {
+        return Containers::optional(Containers::ArrayView<const char>{});
+    });
+    CORRADE_VERIFY(!importer->openFile("empty.ply"));
+
+    CORRADE_COMPARE(out.str(),
+        "Trade::StanfordImporter::openData(): the file is empty\n"
+        "Trade::StanfordImporter::openFile(): the file is empty\n");
 }
 
 void StanfordImporterTest::fileTooShort() {
@@ -511,6 +617,55 @@ void StanfordImporterTest::parse() {
     } else CORRADE_VERIFY(!mesh->hasAttribute(MeshAttribute::ObjectId));
 }
 
+void StanfordImporterTest::parseAsciiFloatSlowPath() {
+    /* If possible, switch to a locale that uses a comma as a decimal
+       separator to verify the values are parsed independently of it */
+    const Containers::String previousLocale = std::setlocale(LC_NUMERIC, nullptr);
+    const char* commaLocale = nullptr;
+    for(const char* name: {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "cs_CZ.UTF-8", "German"}) {
+        if(std::setlocale(LC_NUMERIC, name)) {
+            commaLocale = name;
+            break;
+        }
+    }
+    Containers::ScopeGuard restoreLocale{&previousLocale, [](const Containers::String* locale) {
+        std::setlocale(LC_NUMERIC, locale->data());
+    }};
+
+    using namespace Containers::Literals;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+
+    /* Exponents outside of [-22, 22] and more than 19 significant digits go
+       through the slow path */
+    CORRADE_VERIFY(importer->openData(
+        "ply\n"
+        "format ascii 1.0\n"
+        "element vertex 3\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "element face 1\n"
+        "property list uchar uint vertex_indices\n"
+        "end_header\n"
+        "1e-30 1.5e+30 -2.5e-25\n"
+        "12345678901234567890.5 0.25 -1e23\n"
+        "0.000000000000000000000000125 3.75e-24 0.5\n"
+        "3 0 1 2\n"_s));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.0e-30f, 1.5e30f, -2.5e-25f},
+            {1.2345678901234567890e19f, 0.25f, -1.0e23f},
+            {1.25e-25f, 3.75e-24f, 0.5f}
+        }), TestSuite::Compare::Container);
+
+    if(!commaLocale)
+        CORRADE_SKIP("No locale with a comma decimal separator available, can't verify locale independence");
+}
+
 void StanfordImporterTest::parsePerFace() {
     auto&& data = ParsePerFaceData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1041,6 +1196,100 @@ void StanfordImporterTest::openMemory() {
         TestSuite::Compare::Container);
 }
 
+void StanfordImporterTest::zeroCopy() {
+    auto&& data = ZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+
+    const Containers::String filename = Utility::Path::join(STANFORDIMPORTER_TEST_DIR, data.filename);
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(filename);
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(data.open(*importer, filename, *memory));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), data.expectedDataFlags);
+
+    /* The vertex data should point right after the header if referenced */
+    const Containers::StringView headerEnd = Containers::StringView{*memory}.find("end_header\n");
+    CORRADE_VERIFY(headerEnd);
+    CORRADE_COMPARE(mesh->vertexData().data() == headerEnd.end(), data.expectReferenced);
+
+    /* The data should be the same as with a regular import in any case */
+    Containers::Pointer<AbstractImporter> expectedImporter = _manager.instantiate("StanfordImporter");
+    CORRADE_VERIFY(expectedImporter->openFile(filename));
+    Containers::Optional<Trade::MeshData> expected = expectedImporter->mesh(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(mesh->vertexCount(), expected->vertexCount());
+    CORRADE_COMPARE(mesh->attributeCount(), expected->attributeCount());
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+        expected->positions3DAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        expected->indicesAsArray(),
+        TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::fileCallback() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    CORRADE_VERIFY(importer->features() & ImporterFeature::FileCallback);
+    importer->configuration().setValue("zeroCopy", true);
+
+    struct {
+        Containers::Array<char> data;
+        std::string filename;
+        Containers::Array<InputFileCallbackPolicy> policies;
+    } files;
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "positions-float-indices-uint.ply"));
+    CORRADE_VERIFY(file);
+    files.data = *Utility::move(file);
+
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, decltype(files)& files) {
+        files.filename = filename;
+        arrayAppend(files.policies, policy);
+        return Containers::optional(Containers::ArrayView<const char>{files.data});
+    }, files);
+
+    CORRADE_VERIFY(importer->openFile("some/path/mesh.ply"));
+    CORRADE_COMPARE(files.filename, "some/path/mesh.ply");
+    CORRADE_COMPARE_AS(files.policies, Containers::arrayView({
+        InputFileCallbackPolicy::LoadPermanent
+    }), TestSuite::Compare::Container);
+
+    /* The data are referenced directly, without a copy */
+    {
+        Containers::Optional<Trade::MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+        CORRADE_VERIFY(mesh->vertexData().data() > files.data.data());
+        CORRADE_VERIFY(mesh->vertexData().data() + mesh->vertexData().size() <= files.data.end());
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView(Positions),
+            TestSuite::Compare::Container);
+    }
+
+    /* Closing the importer releases the file */
+    importer->close();
+    CORRADE_COMPARE_AS(files.policies, Containers::arrayView({
+        InputFileCallbackPolicy::LoadPermanent,
+        InputFileCallbackPolicy::Close
+    }), TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::fileCallbackNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy, void*) {
+        return Containers::Optional<Containers::ArrayView<const char>>{};
+    });
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("some-file.ply"));
+    CORRADE_COMPARE(out.str(), "Trade::StanfordImporter::openFile(): cannot open file some-file.ply\n");
+}
+
 void StanfordImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
 
@@ -1070,6 +1319,24 @@ void StanfordImporterTest::importTwice() {
     }
 }
 
+void StanfordImporterTest::benchmarkOpen() {
+    auto&& data = BenchmarkOpenData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+
+    /* The files are tiny, so this measures mainly the per-file overhead of
+       header parsing, which matters when opening many small files */
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(file);
+
+    bool succeeded = true;
+    CORRADE_BENCHMARK(100)
+        succeeded = importer->openData(*file) && succeeded;
+
+    CORRADE_VERIFY(succeeded);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StanfordImporterTest)
@@ -25,6 +25,8 @@
 
 #include "StbDxtImageConverter.h"
 
+#include <thread>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
@@ -49,7 +51,39 @@ ImageConverterFeatures StbDxtImageConverter::doFeatures() const {
 
 namespace {
 
-Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration) {
+/* Compresses block rows [begin, end), with the rows of all slices
+   concatenated together. Each block is compressed independently so the
+   output doesn't depend on how the rows get split. */
+void compressBlockRows(const Containers::StridedArrayView4D<const UnsignedByte>& input, const Containers::StridedArrayView4D<UnsignedByte>& output, const UnsignedInt inputChannelCount, const bool alpha, const Int flags, const std::size_t begin, const std::size_t end) {
+    /* Prepare destination where to copy linearized input data. If the alpha is
+       missing in the input, fill it to 255. */
+    UnsignedByte inputBlockData[16*4];
+    if(inputChannelCount == 3) {
+        /* Utility::copy() would work but be a lot more painful in this case */
+        for(std::size_t i = 0; i != sizeof(inputBlockData); i += 4)
+            inputBlockData[i + 3] = 255;
+    }
+    const Containers::StridedArrayView3D<UnsignedByte> inputBlock{inputBlockData, {4, 4, inputChannelCount}, {4*4, 4, 1}};
+
+    /* Go through all blocks in given rows, linearize and compress them */
+    const std::size_t yMax = output.size()[1];
+    for(std::size_t i = begin; i != end; ++i) {
+        const std::size_t z = i/yMax;
+        const std::size_t y = i%yMax;
+        const Containers::StridedArrayView3D<const UnsignedByte> inputLayer = input[z];
+        const Containers::StridedArrayView2D<UnsignedByte> outputRow = output[z][y];
+        for(std::size_t x = 0, xMax = output.size()[2]; x < xMax; ++x) {
+            /* If the alpha is missing, it'll copy only the RGB values into
+               the destination */
+            Utility::copy(inputLayer.slice({4*y, 4*x, 0}, {4*y + 4, 4*x + 4, inputChannelCount}), inputBlock);
+
+            /* Compress the block */
+            stb_compress_dxt_block(&outputRow[x][0], inputBlockData, alpha, flags);
+        }
+    }
+}
+
+Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Utility::ConfigurationGroup& configuration, const ImageConverterFlags converterFlags) {
     const Int flags = configuration.value<bool>("highQuality") ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL;
 
     /* Decide on the output format */
@@ -111,32 +145,24 @@ Containers::Optional<ImageData3D> convertInternal(const ImageView3D& image, Util
          outputBlockSize}
     };
 
-    /* Prepare destination where to copy linearized input data. If the alpha is
-       missing in the input, fill it to 255. */
-    UnsignedByte inputBlockData[16*4];
-    if(inputChannelCount == 3) {
-        /* Utility::copy() would work but be a lot more painful in this case */
-        for(std::size_t i = 0; i != sizeof(inputBlockData); i += 4)
-            inputBlockData[i + 3] = 255;
+    UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+    if(!threadCount) {
+        threadCount = std::thread::hardware_concurrency();
+        if(converterFlags & ImageConverterFlag::Verbose)
+            Debug{} << "Trade::StbDxtImageConverter::convert(): autodetected hardware concurrency to" << threadCount << "threads";
     }
-    const Containers::StridedArrayView3D<UnsignedByte> inputBlock{inputBlockData, {4, 4, inputChannelCount}, {4*4, 4, 1}};
 
-    /* Go through all blocks in the input file, linearize and compress them */
-    for(std::size_t z = 0, zMax = input.size()[0]; z != zMax; ++z) {
-        const Containers::StridedArrayView3D<const UnsignedByte> inputLayer = input[z];
-        const Containers::StridedArrayView3D<UnsignedByte> outputLayer = output[z];
-        for(std::size_t y = 0, yMax = input.size()[1]/4; y < yMax; ++y) {
-            const Containers::StridedArrayView2D<UnsignedByte> outputRow = outputLayer[y];
-            for(std::size_t x = 0, xMax = input.size()[2]/4; x < xMax; ++x) {
-                /* If the alpha is missing, it'll copy only the RGB values into
-                   the destination */
-                Utility::copy(inputLayer.slice({4*y, 4*x, 0}, {4*y + 4, 4*x + 4, inputChannelCount}), inputBlock);
-
-                /* Compress the block */
-                stb_compress_dxt_block(&outputRow[x][0], inputBlockData, alpha, flags);
-            }
-        }
-    }
+    /* Split block rows of all slices into contiguous ranges, one per thread,
+       with the calling thread processing the first range. There's no point
+       in having more threads than rows. */
+    const std::size_t rowCount = output.size()[0]*output.size()[1];
+    threadCount = Math::max(Math::min(std::size_t(threadCount), rowCount), std::size_t{1});
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{compressBlockRows, input, output, inputChannelCount, alpha, flags, rowCount*(i + 1)/threadCount, rowCount*(i + 2)/threadCount};
+    compressBlockRows(input, output, inputChannelCount, alpha, flags, 0, rowCount/threadCount);
+    for(std::thread& thread: threads)
+        thread.join();
 
     return ImageData3D{outputFormat, image.size(), Utility::move(outputData), image.flags()};
 }
@@ -149,7 +175,7 @@ Containers::Optional<ImageData2D> StbDxtImageConverter::doConvert(const ImageVie
         return {};
     }
 
-    Containers::Optional<ImageData3D> out = convertInternal(image, configuration());
+    Containers::Optional<ImageData3D> out = convertInternal(image, configuration(), flags());
     if(!out) return {};
 
     CORRADE_INTERNAL_ASSERT(out->size().z() == 1);
@@ -158,7 +184,7 @@ Containers::Optional<ImageData2D> StbDxtImageConverter::doConvert(const ImageVie
 }
 
 Containers::Optional<ImageData3D> StbDxtImageConverter::doConvert(const ImageView3D& image) {
-    return convertInternal(image, configuration());
+    return convertInternal(image, configuration(), flags());
 }
 
 }}
@@ -143,6 +143,12 @@ with Y-flipping block-compressed data. This is in line with importers of
 compressed pixel formats such as @ref AstcImporter, @ref DdsImporter or
 @ref KtxImporter, which don't Y-flip compressed formats on import either.
 
+The compression can be spread across multiple threads using the
+@cb{.ini} threads @ce @ref Trade-StbDxtImageConverter-configuration "configuration option".
+As each block is compressed independently, the output is the same regardless
+of the thread count. The plugin recognizes @ref ImageConverterFlag::Verbose,
+printing the autodetected thread count if the option is set to @cb{.ini} 0 @ce.
+
 @section Trade-StbDxtImageConverter-configuration Plugin-specific configuration
 
 Various compressor options can be set through @ref configuration(). See below
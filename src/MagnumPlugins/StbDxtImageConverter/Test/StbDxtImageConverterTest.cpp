@@ -26,6 +26,7 @@
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -50,6 +51,7 @@ struct StbDxtImageConverterTest: TestSuite::Tester {
 
     void rgba();
     void threeDimensions();
+    void threads();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
@@ -88,6 +90,19 @@ const struct {
         CompressedPixelFormat::Bc3RGBAUnorm, "ship.bc3"},
 };
 
+const struct {
+    const char* name;
+    UnsignedInt threads;
+    ImageConverterFlags flags;
+} ThreadsData[]{
+    {"2 threads", 2, {}},
+    /* 24 block rows in total, so the ranges don't align with slices */
+    {"5 threads", 5, {}},
+    {"more threads than block rows", 100, {}},
+    {"autodetected thread count", 0, {}},
+    {"autodetected thread count, verbose", 0, ImageConverterFlag::Verbose},
+};
+
 StbDxtImageConverterTest::StbDxtImageConverterTest() {
     addTests({&StbDxtImageConverterTest::unsupportedFormat,
               &StbDxtImageConverterTest::unsupportedSize,
@@ -99,6 +114,9 @@ StbDxtImageConverterTest::StbDxtImageConverterTest() {
 
     addTests({&StbDxtImageConverterTest::threeDimensions});
 
+    addInstancedTests({&StbDxtImageConverterTest::threads},
+        Containers::arraySize(ThreadsData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBDXTIMAGECONVERTER_PLUGIN_FILENAME
@@ -222,6 +240,54 @@ void StbDxtImageConverterTest::threeDimensions() {
         TestSuite::Compare::StringToFile);
 }
 
+void StbDxtImageConverterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    importer->configuration().setValue("forceChannelCount", 4);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STBDXTIMAGECONVERTER_TEST_DIR, "ship.jpg")));
+    Containers::Optional<Trade::ImageData2D> uncompressed = importer->image2D(0);
+    CORRADE_VERIFY(uncompressed);
+    CORRADE_COMPARE(uncompressed->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(uncompressed->size(), (Vector2i{160, 96}));
+
+    /* Same as in threeDimensions(), to verify the work is correctly split
+       also across slices. Using the high-quality mode to have the slowest
+       path tested. */
+    ImageView3D uncompressed3D{uncompressed->format(), {160, 32, 3}, uncompressed->data()};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("StbDxtImageConverter");
+    converter->addFlags(data.flags);
+    converter->configuration().setValue("highQuality", true);
+    converter->configuration().setValue("threads", data.threads);
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData3D> compressed;
+    {
+        Debug redirectOutput{&out};
+        compressed = converter->convert(uncompressed3D);
+    }
+    CORRADE_VERIFY(compressed);
+    CORRADE_COMPARE(compressed->compressedFormat(), CompressedPixelFormat::Bc3RGBAUnorm);
+    CORRADE_COMPARE(compressed->size(), (Vector3i{160, 32, 3}));
+    if(data.flags & ImageConverterFlag::Verbose)
+        CORRADE_COMPARE_AS(out.str(),
+            "Trade::StbDxtImageConverter::convert(): autodetected hardware concurrency to ",
+            TestSuite::Compare::StringHasPrefix);
+    else
+        CORRADE_COMPARE(out.str(), "");
+
+    /* The output should be bit-identical to the single-threaded case */
+    /** @todo Compare::DataToFile */
+    CORRADE_COMPARE_AS(Containers::StringView{compressed->data()},
+        Utility::Path::join(STBDXTIMAGECONVERTER_TEST_DIR, "ship-hq.bc3"),
+        TestSuite::Compare::StringToFile);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StbDxtImageConverterTest)
@@ -0,0 +1,326 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+/* Global allocation tracking for the peakAllocation() benchmark. Replacing
+   the global operator new and delete catches allocations done by the plugins
+   themselves as well, however allocations done by third-party C libraries
+   directly through malloc() aren't included. On Windows, DLL plugins don't
+   see these replacements at all. */
+namespace {
+    /* Size of each allocation is stored in front of it, padded to keep the
+       returned pointer suitably aligned */
+    constexpr std::size_t AllocationHeaderSize = alignof(std::max_align_t);
+
+    std::atomic<std::size_t> currentAllocationSize{0};
+    std::atomic<std::size_t> peakAllocationSize{0};
+
+    void* trackedAllocate(const std::size_t size) noexcept {
+        char* const data = static_cast<char*>(std::malloc(size + AllocationHeaderSize));
+        if(!data) return nullptr;
+        *reinterpret_cast<std::size_t*>(data) = size;
+
+        const std::size_t current = currentAllocationSize += size;
+        std::size_t peak = peakAllocationSize;
+        while(current > peak && !peakAllocationSize.compare_exchange_weak(peak, current));
+
+        return data + AllocationHeaderSize;
+    }
+}
+
+void* operator new(const std::size_t size) {
+    void* const data = trackedAllocate(size);
+    if(!data) throw std::bad_alloc{};
+    return data;
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size);
+}
+
+void operator delete(void* const data) noexcept {
+    if(!data) return;
+    char* const begin = static_cast<char*>(data) - AllocationHeaderSize;
+    currentAllocationSize -= *reinterpret_cast<std::size_t*>(begin);
+    std::free(begin);
+}
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct ImageImporterBenchmark: TestSuite::Tester {
+    explicit ImageImporterBenchmark();
+
+    void wallTime();
+    void timePerMegapixel();
+    void peakAllocation();
+
+    void timePerMegapixelBegin();
+    UnsignedLong timePerMegapixelEnd();
+    void peakAllocationBegin();
+    UnsignedLong peakAllocationEnd();
+
+    /* Loads the file for current test case instance and verifies it can
+       be decoded, returning the data or a NullOpt if not */
+    Containers::Optional<Containers::Array<char>> setupCase(AbstractImporter& importer);
+
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    struct Case {
+        Containers::String plugin;
+        Containers::String file;
+    };
+    Containers::Array<Case> _cases;
+
+    std::size_t _pixelCount;
+    std::chrono::steady_clock::time_point _begin;
+    std::size_t _allocationBaseline;
+};
+
+using namespace Containers::Literals;
+
+/* Extensions each plugin is tried for, lowercase and space-separated */
+const struct {
+    const char* plugin;
+    Containers::StringView extensions;
+} Importers[]{
+    {"AstcImporter", ".astc"_s},
+    {"BasisImporter", ".basis .ktx2"_s},
+    {"DdsImporter", ".dds"_s},
+    {"DevIlImageImporter", ".bmp .dds .exr .gif .hdr .ico .jpeg .jpg .png .psd .tga .tif .tiff"_s},
+    {"IcoImporter", ".ico"_s},
+    {"JpegImporter", ".jpeg .jpg"_s},
+    {"KtxImporter", ".ktx2"_s},
+    {"OpenExrImporter", ".exr"_s},
+    {"PngImporter", ".png"_s},
+    {"SpngImporter", ".png"_s},
+    {"StbImageImporter", ".bmp .gif .hdr .jpeg .jpg .pgm .pic .png .ppm .psd .tga"_s},
+    {"WebPImporter", ".webp"_s},
+};
+
+/* Used if --corpus-dir isn't specified, relative to the plugin source
+   directory */
+constexpr const char* DefaultCorpus[]{
+    "AstcImporter/Test/8x8.astc",
+    "BasisImporter/Test/rgba.basis",
+    "BasisImporter/Test/rgba.ktx2",
+    "BasisImporter/Test/rgba-64x32.png",
+    "DdsImporter/Test/dxt10-bc7.dds",
+    "DdsImporter/Test/dxt10-rgba8unorm.dds",
+    "IcoImporter/Test/pngs.ico",
+    "JpegImporter/Test/rgb.jpg",
+    "KtxImporter/Test/2d-rgba.ktx2",
+    "OpenExrImporter/Test/rgba32f.exr",
+    "PngImporter/Test/rgba.png",
+    "StbImageImporter/Test/rgb.hdr",
+    "WebPImporter/Test/rgb-lossy-90.webp",
+    "WebPImporter/Test/rgba-lossless.webp",
+};
+
+/* Opens the data and decodes the first 2D or 3D image, returning its pixel
+   count or 0 on failure */
+std::size_t decode(AbstractImporter& importer, const Containers::ArrayView<const char> data) {
+    if(!importer.openData(data))
+        return 0;
+
+    std::size_t pixelCount = 0;
+    if(importer.image2DCount()) {
+        if(Containers::Optional<ImageData2D> image = importer.image2D(0))
+            pixelCount = image->size().product();
+    } else if(importer.image3DCount()) {
+        if(Containers::Optional<ImageData3D> image = importer.image3D(0))
+            pixelCount = image->size().product();
+    }
+
+    importer.close();
+    return pixelCount;
+}
+
+ImageImporterBenchmark::ImageImporterBenchmark(): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"corpus"})} {
+    Utility::Arguments args{"corpus"};
+    args.addOption("dir").setHelp("dir", "directory with files to decode instead of the built-in corpus", "PATH")
+        .setFromEnvironment("dir")
+        .parse(arguments().first(), arguments().second());
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    for(const Containers::StringView filename: Containers::StringView{IMAGEIMPORTERBENCHMARK_PLUGIN_FILENAMES}.splitWithoutEmptyParts(';'))
+        CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(filename) & PluginManager::LoadState::Loaded);
+
+    /* Gather the corpus */
+    Containers::Array<Containers::String> files;
+    if(const Containers::StringView dir = args.value<Containers::StringView>("dir")) {
+        Containers::Optional<Containers::Array<Containers::String>> list = Utility::Path::list(dir, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot|Utility::Path::ListFlag::SortAscending);
+        if(!list)
+            Fatal{} << "Can't list the corpus directory" << dir;
+        for(const Containers::String& file: *list)
+            arrayAppend(files, Utility::Path::join(dir, file));
+    } else for(const char* file: DefaultCorpus)
+        arrayAppend(files, Utility::Path::join(MAGNUMPLUGINS_SOURCE_DIR, file));
+
+    /* Pair each file with all available plugins that claim to support its
+       extension */
+    for(const Containers::String& file: files) {
+        const Containers::String extension = Utility::String::lowercase(Utility::Path::splitExtension(file).second());
+        if(extension.isEmpty()) continue;
+
+        for(const auto& importer: Importers) {
+            if(_manager.loadState(importer.plugin) == PluginManager::LoadState::NotFound)
+                continue;
+            for(const Containers::StringView i: importer.extensions.splitWithoutEmptyParts(' ')) {
+                if(i != extension) continue;
+                arrayAppend(_cases, InPlaceInit, importer.plugin, file);
+                break;
+            }
+        }
+    }
+
+    addInstancedBenchmarks({&ImageImporterBenchmark::wallTime}, 10,
+        _cases.size());
+
+    addCustomInstancedBenchmarks({&ImageImporterBenchmark::timePerMegapixel}, 10,
+        _cases.size(),
+        &ImageImporterBenchmark::timePerMegapixelBegin,
+        &ImageImporterBenchmark::timePerMegapixelEnd,
+        BenchmarkUnits::Nanoseconds);
+
+    addCustomInstancedBenchmarks({&ImageImporterBenchmark::peakAllocation}, 3,
+        _cases.size(),
+        &ImageImporterBenchmark::peakAllocationBegin,
+        &ImageImporterBenchmark::peakAllocationEnd,
+        BenchmarkUnits::Bytes);
+}
+
+Containers::Optional<Containers::Array<char>> ImageImporterBenchmark::setupCase(AbstractImporter& importer) {
+    const Case& data = _cases[testCaseInstanceId()];
+
+    Containers::Optional<Containers::Array<char>> fileData = Utility::Path::read(data.file);
+    if(!fileData) return {};
+
+    /* The extension matching is only a guess, the file may be for example a
+       KTX file with a non-Basis payload. Silence the errors and let the
+       caller skip the case in that case. */
+    {
+        Error silenceError{nullptr};
+        _pixelCount = decode(importer, *fileData);
+    }
+    if(!_pixelCount) return {};
+
+    return fileData;
+}
+
+void ImageImporterBenchmark::wallTime() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(Utility::format("{}, {}", data.plugin, Utility::Path::split(data.file).second()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    Containers::Optional<Containers::Array<char>> fileData = setupCase(*importer);
+    if(!fileData)
+        CORRADE_SKIP(data.plugin << "can't decode" << data.file);
+
+    std::size_t pixelCount{};
+    CORRADE_BENCHMARK(5)
+        pixelCount = decode(*importer, *fileData);
+
+    CORRADE_COMPARE(pixelCount, _pixelCount);
+}
+
+void ImageImporterBenchmark::timePerMegapixelBegin() {
+    _begin = std::chrono::steady_clock::now();
+}
+
+UnsignedLong ImageImporterBenchmark::timePerMegapixelEnd() {
+    /* Normalizing the wall time to a megapixel, which makes the results
+       comparable across differently sized images. It's the inverse of a
+       megapixels per second throughput. */
+    const UnsignedLong duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _begin).count();
+    return duration*1000000/_pixelCount;
+}
+
+void ImageImporterBenchmark::timePerMegapixel() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(Utility::format("{}, {}", data.plugin, Utility::Path::split(data.file).second()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    Containers::Optional<Containers::Array<char>> fileData = setupCase(*importer);
+    if(!fileData)
+        CORRADE_SKIP(data.plugin << "can't decode" << data.file);
+
+    std::size_t pixelCount{};
+    CORRADE_BENCHMARK(5)
+        pixelCount = decode(*importer, *fileData);
+
+    CORRADE_COMPARE(pixelCount, _pixelCount);
+}
+
+void ImageImporterBenchmark::peakAllocationBegin() {
+    _allocationBaseline = currentAllocationSize;
+    peakAllocationSize = _allocationBaseline;
+}
+
+UnsignedLong ImageImporterBenchmark::peakAllocationEnd() {
+    return peakAllocationSize - _allocationBaseline;
+}
+
+void ImageImporterBenchmark::peakAllocation() {
+    const Case& data = _cases[testCaseInstanceId()];
+    setTestCaseDescription(Utility::format("{}, {}", data.plugin, Utility::Path::split(data.file).second()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(data.plugin);
+    Containers::Optional<Containers::Array<char>> fileData = setupCase(*importer);
+    if(!fileData)
+        CORRADE_SKIP(data.plugin << "can't decode" << data.file);
+
+    /* A single iteration, as the reported value is divided by the iteration
+       count and a peak doesn't accumulate */
+    std::size_t pixelCount{};
+    CORRADE_BENCHMARK(1)
+        pixelCount = decode(*importer, *fileData);
+
+    CORRADE_COMPARE(pixelCount, _pixelCount);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::ImageImporterBenchmark)
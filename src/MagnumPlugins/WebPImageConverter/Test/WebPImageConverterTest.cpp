@@ -0,0 +1,354 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct WebPImageConverterTest: TestSuite::Tester {
+    explicit WebPImageConverterTest();
+
+    void wrongFormat();
+    void tooLarge();
+
+    void unsupportedMetadata();
+    void invalidOption();
+
+    void lossless();
+    void lossy();
+
+    void benchmark();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
+};
+
+const struct {
+    const char* name;
+    ImageConverterFlags converterFlags;
+    ImageFlags2D imageFlags;
+    const char* message;
+} UnsupportedMetadataData[]{
+    {"1D array", {}, ImageFlag2D::Array,
+        "1D array images are unrepresentable in WebP, saving as a regular 2D image"},
+    {"1D array, quiet", ImageConverterFlag::Quiet, ImageFlag2D::Array,
+        nullptr},
+};
+
+const struct {
+    const char* name;
+    const char* key;
+    const char* value;
+    const char* message;
+} InvalidOptionData[]{
+    {"invalid preset", "preset", "painting",
+        "expected preset to be one of default, picture, photo, drawing, icon or text, got painting"},
+    {"quality too large", "quality", "100.5",
+        "expected quality to be between 0 and 100, got 100.5"},
+    {"negative quality", "quality", "-1",
+        "expected quality to be between 0 and 100, got -1"},
+    {"method too large", "method", "7",
+        "expected method to be between 0 and 6, got 7"},
+    {"negative method", "method", "-1",
+        "expected method to be between 0 and 6, got -1"},
+    {"alpha quality too large", "alphaQuality", "101",
+        "expected alphaQuality to be between 0 and 100, got 101"},
+};
+
+const struct {
+    const char* name;
+    PixelFormat format;
+    Float quality;
+    Int method;
+    bool multithreaded;
+} LosslessData[]{
+    {"RGB", PixelFormat::RGB8Unorm, 75.0f, 4, false},
+    {"RGBA", PixelFormat::RGBA8Unorm, 75.0f, 4, false},
+    {"RGB, fastest", PixelFormat::RGB8Unorm, 0.0f, 0, false},
+    {"RGBA, smallest", PixelFormat::RGBA8Unorm, 100.0f, 6, false},
+    {"RGB, multithreaded", PixelFormat::RGB8Unorm, 75.0f, 4, true},
+    {"RGBA, smallest, multithreaded", PixelFormat::RGBA8Unorm, 100.0f, 6, true},
+};
+
+const struct {
+    const char* name;
+    PixelFormat format;
+    const char* preset;
+    Float quality;
+    Int method;
+    bool sharpYuv;
+    bool multithreaded;
+} LossyData[]{
+    {"RGB", PixelFormat::RGB8Unorm, "default", 75.0f, 4, false, false},
+    {"RGBA", PixelFormat::RGBA8Unorm, "default", 75.0f, 4, false, false},
+    {"RGB, photo preset, fastest", PixelFormat::RGB8Unorm, "photo", 50.0f, 0, false, false},
+    {"RGB, drawing preset, best", PixelFormat::RGB8Unorm, "drawing", 100.0f, 6, false, false},
+    {"RGB, sharp YUV", PixelFormat::RGB8Unorm, "default", 75.0f, 4, true, false},
+    {"RGBA, multithreaded", PixelFormat::RGBA8Unorm, "default", 75.0f, 4, false, true},
+    {"RGBA, sharp YUV, multithreaded", PixelFormat::RGBA8Unorm, "picture", 75.0f, 4, true, true},
+};
+
+const struct {
+    const char* name;
+    bool lossless;
+    bool multithreaded;
+} BenchmarkData[]{
+    {"lossy", false, false},
+    {"lossy, multithreaded", false, true},
+    {"lossless", true, false},
+    {"lossless, multithreaded", true, true},
+};
+
+WebPImageConverterTest::WebPImageConverterTest() {
+    addTests({&WebPImageConverterTest::wrongFormat,
+              &WebPImageConverterTest::tooLarge});
+
+    addInstancedTests({&WebPImageConverterTest::unsupportedMetadata},
+        Containers::arraySize(UnsupportedMetadataData));
+
+    addInstancedTests({&WebPImageConverterTest::invalidOption},
+        Containers::arraySize(InvalidOptionData));
+
+    addInstancedTests({&WebPImageConverterTest::lossless},
+        Containers::arraySize(LosslessData));
+
+    addInstancedTests({&WebPImageConverterTest::lossy},
+        Containers::arraySize(LossyData));
+
+    addInstancedBenchmarks({&WebPImageConverterTest::benchmark}, 10,
+        Containers::arraySize(BenchmarkData));
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef WEBPIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(WEBPIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The WebPImporter is optional */
+    #ifdef WEBPIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(WEBPIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void WebPImageConverterTest::wrongFormat() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+
+    const char data[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RG8Unorm, {1, 1}, data}));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImageConverter::convertToData(): unsupported pixel format PixelFormat::RG8Unorm\n");
+}
+
+void WebPImageConverterTest::tooLarge() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+
+    const char data[16384*3]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGB8Unorm, {16384, 1}, data}));
+    CORRADE_COMPARE(out.str(), "Trade::WebPImageConverter::convertToData(): expected image size to be at most 16383 pixels in each dimension, got {16384, 1}\n");
+}
+
+void WebPImageConverterTest::unsupportedMetadata() {
+    auto&& data = UnsupportedMetadataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->addFlags(data.converterFlags);
+
+    const char imageData[4]{};
+    ImageView2D image{PixelFormat::RGBA8Unorm, {1, 1}, imageData, data.imageFlags};
+
+    std::ostringstream out;
+    Warning redirectWarning{&out};
+    CORRADE_VERIFY(converter->convertToData(image));
+    if(!data.message)
+        CORRADE_COMPARE(out.str(), "");
+    else
+        CORRADE_COMPARE(out.str(), Utility::formatString("Trade::WebPImageConverter::convertToData(): {}\n", data.message));
+}
+
+void WebPImageConverterTest::invalidOption() {
+    auto&& data = InvalidOptionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->configuration().setValue(data.key, data.value);
+
+    const char imageData[4]{};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, imageData}));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::WebPImageConverter::convertToData(): {}\n", data.message));
+}
+
+/* Pseudo-random noise for verifying the lossless mode is bit-exact, meant
+   to be used with one-byte row alignment. Every row is different to verify
+   the image isn't flipped, and there are fully transparent pixels in random
+   places. */
+Containers::Array<char> noiseImageData(const Vector2i& size, const PixelFormat format) {
+    Containers::Array<char> out{NoInit, std::size_t(size.product())*pixelFormatSize(format)};
+    /* xorshift32 */
+    UnsignedInt state = 0x2545f491;
+    for(char& i: out) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        i = char(state);
+    }
+    return out;
+}
+
+/* Smooth gradients that survive lossy compression with only a small error.
+   Alpha never gets to zero, as fully transparent areas are allowed to be
+   changed arbitrarily by the lossy encoder. */
+Containers::Array<char> gradientImageData(const Vector2i& size, const PixelFormat format) {
+    const std::size_t pixelSize = pixelFormatSize(format);
+    Containers::Array<char> out{NoInit, std::size_t(size.product())*pixelSize};
+    for(Int y = 0; y != size.y(); ++y) {
+        for(Int x = 0; x != size.x(); ++x) {
+            const Color4ub color{
+                UnsignedByte(x*255/(size.x() - 1)),
+                UnsignedByte(y*255/(size.y() - 1)),
+                UnsignedByte(128 + (x + y)*64/(size.x() + size.y())),
+                UnsignedByte(255 - y*191/(size.y() - 1))};
+            char* const pixel = out.data() + (y*size.x() + x)*pixelSize;
+            for(std::size_t i = 0; i != pixelSize; ++i)
+                pixel[i] = color[i];
+        }
+    }
+    return out;
+}
+
+void WebPImageConverterTest::lossless() {
+    auto&& data = LosslessData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    CORRADE_COMPARE(converter->extension(), "webp");
+    CORRADE_COMPARE(converter->mimeType(), "image/webp");
+
+    converter->configuration().setValue("lossless", true);
+    converter->configuration().setValue("quality", data.quality);
+    converter->configuration().setValue("method", data.method);
+    converter->configuration().setValue("multithreaded", data.multithreaded);
+    /* The noise has fully transparent pixels in random places, RGB values
+       of which wouldn't be preserved otherwise */
+    converter->configuration().setValue("exact", true);
+
+    const Containers::Array<char> imageData = noiseImageData({37, 29}, data.format);
+    const ImageView2D image{PixelStorage{}.setAlignment(1),
+        data.format, {37, 29}, imageData};
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(image);
+    CORRADE_VERIFY(out);
+
+    if(_importerManager.loadState("WebPImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("WebPImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("WebPImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE_AS(*converted, image,
+        DebugTools::CompareImage);
+}
+
+void WebPImageConverterTest::lossy() {
+    auto&& data = LossyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->configuration().setValue("preset", data.preset);
+    converter->configuration().setValue("quality", data.quality);
+    converter->configuration().setValue("method", data.method);
+    converter->configuration().setValue("sharpYuv", data.sharpYuv);
+    converter->configuration().setValue("multithreaded", data.multithreaded);
+
+    const Containers::Array<char> imageData = gradientImageData({64, 48}, data.format);
+    const ImageView2D image{PixelStorage{}.setAlignment(1),
+        data.format, {64, 48}, imageData};
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(image);
+    CORRADE_VERIFY(out);
+
+    /* The file should be smaller than the input */
+    CORRADE_COMPARE_AS(out->size(), imageData.size(),
+        TestSuite::Compare::Less);
+
+    if(_importerManager.loadState("WebPImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("WebPImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("WebPImporter");
+    CORRADE_VERIFY(importer->openData(*out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    /* The thresholds are rather generous to not depend on a particular
+       libwebp version, the point is to verify the orientation and that the
+       options don't break anything */
+    CORRADE_COMPARE_WITH(*converted, image,
+        (DebugTools::CompareImage{32.0f, 3.0f}));
+}
+
+void WebPImageConverterTest::benchmark() {
+    auto&& data = BenchmarkData[testCaseInstanceId()];
+    /* Large enough for the multithreaded encoding to make a measurable
+       difference, with content that's representative for both the lossy and
+       lossless mode */
+    setTestCaseDescription(Utility::formatString("{}, 512x512", data.name));
+
+    const Containers::Array<char> imageData = gradientImageData({512, 512}, PixelFormat::RGB8Unorm);
+    const ImageView2D image{PixelFormat::RGB8Unorm, {512, 512}, imageData};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("WebPImageConverter");
+    converter->configuration().setValue("lossless", data.lossless);
+    converter->configuration().setValue("multithreaded", data.multithreaded);
+
+    Containers::Optional<Containers::Array<char>> out;
+    CORRADE_BENCHMARK(1)
+        out = converter->convertToData(image);
+
+    CORRADE_VERIFY(out);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::WebPImageConverterTest)
@@ -0,0 +1,206 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "WebPImageConverter.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+
+#include <webp/encode.h>
+
+namespace Magnum { namespace Trade {
+
+using namespace Containers::Literals;
+
+WebPImageConverter::WebPImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {}
+
+ImageConverterFeatures WebPImageConverter::doFeatures() const { return ImageConverterFeature::Convert2DToData; }
+
+Containers::String WebPImageConverter::doExtension() const { return "webp"_s; }
+
+Containers::String WebPImageConverter::doMimeType() const {
+    return "image/webp"_s;
+}
+
+namespace {
+
+const char* encodingErrorString(const WebPEncodingError error) {
+    switch(error) {
+        /* LCOV_EXCL_START */
+        case VP8_ENC_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case VP8_ENC_ERROR_BITSTREAM_OUT_OF_MEMORY: return "out of memory while flushing bits";
+        case VP8_ENC_ERROR_NULL_PARAMETER: return "null parameter";
+        case VP8_ENC_ERROR_INVALID_CONFIGURATION: return "invalid configuration";
+        case VP8_ENC_ERROR_BAD_DIMENSION: return "bad picture dimension";
+        case VP8_ENC_ERROR_PARTITION0_OVERFLOW: return "first partition is too large";
+        case VP8_ENC_ERROR_PARTITION_OVERFLOW: return "partition is too large";
+        case VP8_ENC_ERROR_BAD_WRITE: return "error while flushing bytes";
+        case VP8_ENC_ERROR_FILE_TOO_BIG: return "file is too large";
+        case VP8_ENC_ERROR_USER_ABORT: return "process aborted";
+        case VP8_ENC_OK:
+        case VP8_ENC_ERROR_LAST: ;
+        /* LCOV_EXCL_STOP */
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+}
+
+Containers::Optional<Containers::Array<char>> WebPImageConverter::doConvertToData(const ImageView2D& image) {
+    /* Warn about lost metadata */
+    if((image.flags() & ImageFlag2D::Array) && !(flags() & ImageConverterFlag::Quiet)) {
+        Warning{} << "Trade::WebPImageConverter::convertToData(): 1D array images are unrepresentable in WebP, saving as a regular 2D image";
+    }
+
+    /* WebP has only 8-bit RGB and RGBA */
+    bool hasAlpha;
+    switch(image.format()) {
+        case PixelFormat::RGB8Unorm:
+            hasAlpha = false;
+            break;
+        case PixelFormat::RGBA8Unorm:
+            hasAlpha = true;
+            break;
+        default:
+            Error{} << "Trade::WebPImageConverter::convertToData(): unsupported pixel format" << image.format();
+            return {};
+    }
+
+    if(image.size().x() > WEBP_MAX_DIMENSION || image.size().y() > WEBP_MAX_DIMENSION) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected image size to be at most" << WEBP_MAX_DIMENSION << "pixels in each dimension, got" << Debug::packed << image.size();
+        return {};
+    }
+
+    /* Check the options upfront so we don't need to clean up the picture on
+       failure */
+    WebPPreset preset;
+    const Containers::StringView presetString = configuration().value<Containers::StringView>("preset");
+    if(presetString == "default"_s)
+        preset = WEBP_PRESET_DEFAULT;
+    else if(presetString == "picture"_s)
+        preset = WEBP_PRESET_PICTURE;
+    else if(presetString == "photo"_s)
+        preset = WEBP_PRESET_PHOTO;
+    else if(presetString == "drawing"_s)
+        preset = WEBP_PRESET_DRAWING;
+    else if(presetString == "icon"_s)
+        preset = WEBP_PRESET_ICON;
+    else if(presetString == "text"_s)
+        preset = WEBP_PRESET_TEXT;
+    else {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected preset to be one of default, picture, photo, drawing, icon or text, got" << presetString;
+        return {};
+    }
+
+    const Float quality = configuration().value<Float>("quality");
+    if(quality < 0.0f || quality > 100.0f) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected quality to be between 0 and 100, got" << quality;
+        return {};
+    }
+
+    const Int method = configuration().value<Int>("method");
+    if(method < 0 || method > 6) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected method to be between 0 and 6, got" << method;
+        return {};
+    }
+
+    const Int alphaQuality = configuration().value<Int>("alphaQuality");
+    if(alphaQuality < 0 || alphaQuality > 100) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): expected alphaQuality to be between 0 and 100, got" << alphaQuality;
+        return {};
+    }
+
+    /* Encoder configuration. The preset fills in the lossy encoder defaults
+       for given content, everything else is applied on top. */
+    WebPConfig config;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(WebPConfigPreset(&config, preset, quality));
+    config.lossless = configuration().value<bool>("lossless");
+    config.method = method;
+    config.alpha_quality = alphaQuality;
+    config.exact = configuration().value<bool>("exact");
+    config.use_sharp_yuv = configuration().value<bool>("sharpYuv");
+    config.thread_level = configuration().value<bool>("multithreaded");
+    CORRADE_INTERNAL_ASSERT_OUTPUT(WebPValidateConfig(&config));
+
+    WebPPicture picture;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(WebPPictureInit(&picture));
+    picture.width = image.size().x();
+    picture.height = image.size().y();
+    /* Lossless encoding and the sharp RGB to YUV conversion both operate on
+       ARGB data. Importing to ARGB for them avoids a lossy YUV roundtrip in
+       the first case and having the sharp conversion silently skipped in the
+       second. */
+    picture.use_argb = config.lossless || config.use_sharp_yuv;
+
+    /* Import the pixels. WebP is Y down, so pass a pointer to the last row
+       together with a negative stride, which libwebp handles directly without
+       having to make a flipped copy first. */
+    const Containers::StridedArrayView3D<const char> pixels = image.pixels().flipped<0>();
+    const std::uint8_t* const pixelData = static_cast<const std::uint8_t*>(pixels.data());
+    const int stride = int(pixels.stride()[0]);
+    if(!(hasAlpha ? WebPPictureImportRGBA(&picture, pixelData, stride) :
+                    WebPPictureImportRGB(&picture, pixelData, stride))) {
+        /* LCOV_EXCL_START */
+        Error{} << "Trade::WebPImageConverter::convertToData(): can't import the image, out of memory";
+        WebPPictureFree(&picture);
+        return {};
+        /* LCOV_EXCL_STOP */
+    }
+
+    /* Encode directly into a growable array */
+    Containers::Array<char> output;
+    picture.custom_ptr = &output;
+    picture.writer = [](const std::uint8_t* data, std::size_t size, const WebPPicture* picture) -> int {
+        arrayAppend(*static_cast<Containers::Array<char>*>(picture->custom_ptr), {reinterpret_cast<const char*>(data), size});
+        return 1;
+    };
+
+    const bool encoded = WebPEncode(&config, &picture);
+    const WebPEncodingError error = picture.error_code;
+    WebPPictureFree(&picture);
+    if(!encoded) {
+        Error{} << "Trade::WebPImageConverter::convertToData(): encoding failed:" << encodingErrorString(error);
+        return {};
+    }
+
+    /* Convert the growable array back to a non-growable with the default
+       deleter so we can return it */
+    arrayShrink(output);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(Utility::move(output));
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(WebPImageConverter, Magnum::Trade::WebPImageConverter,
+    MAGNUM_TRADE_ABSTRACTIMAGECONVERTER_PLUGIN_INTERFACE)